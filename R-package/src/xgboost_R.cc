@@ -6,8 +6,10 @@
 #include <xgboost/c_api.h>
 #include <xgboost/context.h>
 #include <xgboost/data.h>
+#include <xgboost/json.h>
 #include <xgboost/logging.h>
 
+#include <cstddef>
 #include <cstdio>
 #include <cstring>
 #include <sstream>
@@ -108,26 +110,35 @@ XGB_DLL SEXP XGDMatrixCreateFromMat_R(SEXP mat, SEXP missing, SEXP n_threads) {
   size_t nrow = static_cast<size_t>(INTEGER(dim)[0]);
   size_t ncol = static_cast<size_t>(INTEGER(dim)[1]);
   const bool is_int = TYPEOF(mat) == INTSXP;
-  double *din;
-  int *iin;
-  if (is_int) {
-    iin = INTEGER(mat);
-  } else {
-    din = REAL(mat);
-  }
-  std::vector<float> data(nrow * ncol);
   xgboost::Context ctx;
   ctx.nthread = asInteger(n_threads);
-  std::int32_t threads = ctx.Threads();
 
-  xgboost::common::ParallelFor(nrow, threads, [&](xgboost::omp_ulong i) {
-    for (size_t j = 0; j < ncol; ++j) {
-      data[i * ncol + j] = is_int ? static_cast<float>(iin[i + nrow * j]) : din[i + nrow * j];
-    }
-  });
+  // R matrices are column-major, read them in place with strides instead of converting to a
+  // row-major float matrix first.
+  void const *ptr = is_int ? static_cast<void const *>(INTEGER(mat))
+                           : static_cast<void const *>(REAL(mat));
+  std::size_t itemsize = is_int ? sizeof(int) : sizeof(double);
+  xgboost::Json jinterface{xgboost::Object{}};
+  jinterface["data"] = xgboost::Array{std::vector<xgboost::Json>{
+      xgboost::Json{reinterpret_cast<xgboost::Integer::Int>(ptr)}, xgboost::Json{true}}};
+  jinterface["shape"] = std::vector<xgboost::Json>{xgboost::Json{nrow}, xgboost::Json{ncol}};
+  jinterface["strides"] =
+      std::vector<xgboost::Json>{xgboost::Json{itemsize}, xgboost::Json{itemsize * nrow}};
+  std::string typestr{is_int ? "i" : "f"};
+  typestr += std::to_string(itemsize);
+  jinterface["typestr"] = xgboost::String{(DMLC_LITTLE_ENDIAN ? "<" : ">") + typestr};
+  jinterface["version"] = xgboost::Integer{3};
+  std::string sinterface;
+  xgboost::Json::Dump(jinterface, &sinterface);
+
+  xgboost::Json jconfig{xgboost::Object{}};
+  jconfig["missing"] = xgboost::Number{static_cast<float>(asReal(missing))};
+  jconfig["nthread"] = xgboost::Integer{static_cast<xgboost::Integer::Int>(ctx.Threads())};
+  std::string config;
+  xgboost::Json::Dump(jconfig, &config);
+
   DMatrixHandle handle;
-  CHECK_CALL(XGDMatrixCreateFromMat_omp(BeginPtr(data), nrow, ncol,
-                                        asReal(missing), &handle, threads));
+  CHECK_CALL(XGDMatrixCreateFromDense(sinterface.c_str(), config.c_str(), &handle));
   ret = PROTECT(R_MakeExternalPtr(handle, R_NilValue, R_NilValue));
   R_RegisterCFinalizerEx(ret, _DMatrixFinalizer, TRUE);
   R_API_END();
@@ -240,6 +240,9 @@ macro(xgboost_target_defs target)
   if (USE_DEBUG_OUTPUT)
     target_compile_definitions(${target} PRIVATE -DXGBOOST_USE_DEBUG_OUTPUT=1)
   endif (USE_DEBUG_OUTPUT)
+  if (USE_THREAD_POOL)
+    target_compile_definitions(${target} PRIVATE -DXGBOOST_USE_THREAD_POOL=1)
+  endif (USE_THREAD_POOL)
   if (XGBOOST_MM_PREFETCH_PRESENT)
     target_compile_definitions(${target}
       PRIVATE
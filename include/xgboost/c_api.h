@@ -109,6 +109,36 @@ XGB_DLL int XGBSetGlobalConfig(char const *config);
  */
 XGB_DLL int XGBGetGlobalConfig(char const **out_config);
 
+/*!
+ * \brief Start recording trace events for the training and prediction phases, events
+ *        recorded by a previous call are discarded.
+ *
+ * \param config JSON encoded string storing the parameters, can be NULL:
+ *   - buffer_size: Maximum number of events kept for each thread, older events are
+ *                  overwritten.  Default to 65536.
+ *
+ * \return 0 for success, -1 for failure
+ */
+XGB_DLL int XGBTraceStart(char const *config);
+
+/*!
+ * \brief Stop recording trace events.
+ *
+ * \return 0 for success, -1 for failure
+ */
+XGB_DLL int XGBTraceStop(void);
+
+/*!
+ * \brief Export the recorded trace events in the Chrome trace event format, which can be
+ *        loaded by chrome://tracing or Perfetto.
+ *
+ * \param out_len Length of the output string.
+ * \param out_str The JSON document, valid until the next call on the same thread.
+ *
+ * \return 0 for success, -1 for failure
+ */
+XGB_DLL int XGBTraceDump(bst_ulong *out_len, char const **out_str);
+
 /**@}*/
 
 /**
@@ -1060,6 +1090,25 @@ XGB_DLL int XGBoosterPredict(BoosterHandle handle,
 XGB_DLL int XGBoosterPredictFromDMatrix(BoosterHandle handle, DMatrixHandle dmat,
                                         char const *config, bst_ulong const **out_shape,
                                         bst_ulong *out_dim, float const **out_result);
+
+/**
+ * \brief Make prediction from DMatrix, writing the result into a buffer owned by the caller.
+ *
+ * \param handle Booster handle
+ * \param dmat   DMatrix handle
+ * \param config See \ref XGBoosterPredictFromDMatrix for more info.
+ * \param out    JSON encoded __array_interface__ to a writable float32 or float64 array in host
+ *               memory.  The shape must be the same as the one returned by \ref
+ *               XGBoosterPredictFromDMatrix for the same input, strides are supported.
+ *
+ * \note The prediction is still computed in the thread-local buffer of the booster, then
+ *       copied into `out` with conversion to its type and layout.  This saves the binding
+ *       from allocating and filling its own result array, it doesn't avoid the copy.
+ *
+ * \return 0 when success, -1 when failure happens
+ */
+XGB_DLL int XGBoosterPredictFromDMatrixInto(BoosterHandle handle, DMatrixHandle dmat,
+                                            char const *config, char const *out);
 /**
  * @example inference.c
  */
@@ -1084,6 +1133,22 @@ XGB_DLL int XGBoosterPredictFromDMatrix(BoosterHandle handle, DMatrixHandle dmat
 XGB_DLL int XGBoosterPredictFromDense(BoosterHandle handle, char const *values, char const *config,
                                       DMatrixHandle m, bst_ulong const **out_shape,
                                       bst_ulong *out_dim, const float **out_result);
+
+/**
+ * \brief Inplace prediction from CPU dense matrix, writing the result into a buffer owned by
+ *        the caller.
+ *
+ * \param handle        Booster handle.
+ * \param values        JSON encoded __array_interface__ to values.
+ * \param config        See \ref XGBoosterPredictFromDense for more info.
+ * \param m             An optional (NULL if not available) proxy DMatrix instance
+ *                      storing meta info.
+ * \param out           See \ref XGBoosterPredictFromDMatrixInto for more info.
+ *
+ * \return 0 when success, -1 when failure happens
+ */
+XGB_DLL int XGBoosterPredictFromDenseInto(BoosterHandle handle, char const *values,
+                                          char const *config, DMatrixHandle m, char const *out);
 /**
  * @example inference.c
  */
@@ -1113,6 +1178,66 @@ XGB_DLL int XGBoosterPredictFromCSR(BoosterHandle handle, char const *indptr, ch
                                     DMatrixHandle m, bst_ulong const **out_shape,
                                     bst_ulong *out_dim, const float **out_result);
 
+/**
+ * \brief Inplace prediction from CPU CSR matrix, writing the result into a buffer owned by the
+ *        caller.
+ *
+ * \param handle        Booster handle.
+ * \param indptr        JSON encoded __array_interface__ to row pointer in CSR.
+ * \param indices       JSON encoded __array_interface__ to column indices in CSR.
+ * \param values        JSON encoded __array_interface__ to values in CSR..
+ * \param ncol          Number of features in data.
+ * \param config        See \ref XGBoosterPredictFromCSR for more info.
+ * \param m             An optional (NULL if not available) proxy DMatrix instance
+ *                      storing meta info.
+ * \param out           See \ref XGBoosterPredictFromDMatrixInto for more info.
+ *
+ * \return 0 when success, -1 when failure happens
+ */
+XGB_DLL int XGBoosterPredictFromCSRInto(BoosterHandle handle, char const *indptr,
+                                        char const *indices, char const *values, bst_ulong ncol,
+                                        char const *config, DMatrixHandle m, char const *out);
+
+/**
+ * \brief Callback function prototype for receiving the prediction of a batch from \ref
+ *        XGBoosterPredictFromCallback.
+ *
+ * \param iter   A handle to the user defined iterator.
+ * \param shape  Shape of the prediction, see \ref XGBoosterPredictFromDMatrix for more info.
+ * \param dim    Dimension of the prediction.
+ * \param result Prediction values, only valid during the call.
+ *
+ * \return 0 when success, -1 when failure happens.  On failure the prediction stops, and the
+ *         error message set by the callback, if any, is kept as the last error.
+ */
+XGB_EXTERN_C typedef int XGBoosterPredictCallback(DataIterHandle iter,  // NOLINT(*)
+                                                  bst_ulong const *shape, bst_ulong dim,
+                                                  float const *result);
+
+/**
+ * \brief Inplace prediction over batches yielded by a data iterator.  Only one batch is
+ *        held at a time, which can be used to predict data that doesn't fit in memory.
+ *
+ * - Step 0: Define a data iterator with the `next` method and an output callback.
+ * - Step 1: Create a DMatrix proxy by \ref XGProxyDMatrixCreate and hold the handle.
+ * - Step 2: Call appropriate data setters in `next`, which returns 1 when a batch is set on
+ *           the proxy and 0 when there's no more data.
+ * - Step 3: Consume the prediction of each batch in `output`, batches are processed in the
+ *           order they are yielded.
+ *
+ * \param handle  Booster handle.
+ * \param iter    A handle to external data iterator, passed to both callbacks.
+ * \param proxy   A DMatrix proxy handle created by \ref XGProxyDMatrixCreate.
+ * \param next    Callback function yielding the next batch of data.
+ * \param config  See \ref XGBoosterPredictFromDense for more info.
+ * \param output  Callback function receiving the prediction of each batch.
+ *
+ * \return 0 when success, -1 when failure happens
+ */
+XGB_DLL int XGBoosterPredictFromCallback(BoosterHandle handle, DataIterHandle iter,
+                                         DMatrixHandle proxy, XGDMatrixCallbackNext *next,
+                                         char const *config, XGBoosterPredictCallback *output);
+
 /**
  * \brief Inplace prediction from CUDA Dense matrix (cupy in Python).
  *
@@ -1237,6 +1362,48 @@ XGB_DLL int XGBoosterLoadModelFromBuffer(BoosterHandle handle,
 XGB_DLL int XGBoosterSaveModelToBuffer(BoosterHandle handle, char const *config, bst_ulong *out_len,
                                        char const **out_dptr);
 
+/*!
+ * \brief Export the cached prediction of a DMatrix into raw bytes.  User must copy the
+ *        result out, before next xgboost call.
+ *
+ *   The cache holds the raw prediction of the current model along with a hash of the
+ *   DMatrix content.  Saving it next to a model checkpoint and importing it with
+ *   XGBoosterImportPredictionCache() after the model is loaded avoids predicting the
+ *   DMatrix with all trees again when training is resumed.
+ *
+ * \param handle   handle
+ * \param dmat     DMatrix used for training or evaluation.
+ * \param config   JSON encoded string storing parameters for the function.  Following
+ *                 keys are expected in the JSON document:
+ *
+ *     "format": str
+ *       - json: Output will be encoded as JSON.
+ *       - ubj:  Output will be encoded as Univeral binary JSON.
+ *
+ * \param out_len  The argument to hold the output length
+ * \param out_dptr The argument to hold the output data pointer
+ *
+ * \return 0 when success, -1 when failure happens
+ */
+XGB_DLL int XGBoosterExportPredictionCache(BoosterHandle handle, DMatrixHandle dmat,
+                                           char const *config, bst_ulong *out_len,
+                                           char const **out_dptr);
+
+/*!
+ * \brief Attach a prediction cache exported by XGBoosterExportPredictionCache() to a
+ *        DMatrix.  Must be called after the model is loaded, as loading a model clears the
+ *        cache.
+ *
+ * \param handle handle
+ * \param dmat   DMatrix with the same content as the one used for export.
+ * \param buf    pointer to the buffer, either JSON or UBJSON.
+ * \param len    the length of the buffer
+ *
+ * \return 0 when success, -1 when failure happens
+ */
+XGB_DLL int XGBoosterImportPredictionCache(BoosterHandle handle, DMatrixHandle dmat,
+                                           char const *buf, bst_ulong len);
+
 /*!
  * \brief Save booster to a buffer with in binary format.
  *
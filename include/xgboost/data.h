@@ -263,6 +263,11 @@ struct BatchParam {
    * \brief Parameter used to generate column matrix for hist.
    */
   double sparse_thresh{std::numeric_limits<double>::quiet_NaN()};
+  /**
+   * \brief Tolerated rank error of the hessian weighted cuts.  When positive, a
+   *        regeneration with new hessian re-bins only the features whose cuts have moved.
+   */
+  double rebin_tolerance{0.0};
 
   /**
    * \brief Exact or others that don't need histogram.
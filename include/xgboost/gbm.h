@@ -100,6 +100,19 @@ class GradientBooster : public Model, public Configurable {
    */
   virtual void PredictBatch(DMatrix* dmat, PredictionCacheEntry* out_preds, bool training,
                             bst_layer_t begin, bst_layer_t end) = 0;
+  /**
+   * \brief Generate predictions without reading or updating any cached state.  Used by the
+   *        inference snapshot, implementations must be safe to call concurrently.
+   *
+   * \param dmat      The feature matrix.
+   * \param out_preds Output predictions, the cache version is ignored.
+   * \param begin     Beginning of boosted tree layer used for prediction.
+   * \param end       End of booster layer. 0 means do not limit trees.
+   */
+  virtual void PredictBatchNoCache(DMatrix*, PredictionCacheEntry*, bst_layer_t,
+                                   bst_layer_t) const {
+    LOG(FATAL) << "Prediction without cache is not supported by the current booster.";
+  }
 
   /**
    * \brief Inplace prediction.
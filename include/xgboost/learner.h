@@ -46,6 +46,47 @@ enum class PredictionType : std::uint8_t {  // NOLINT
   kLeaf = 6
 };
 
+/**
+ * \brief An immutable copy of a trained model for concurrent inference.
+ *
+ *   The snapshot is obtained from `Learner::Snapshot` and is not affected by further
+ *   training or configuration of the learner.  All prediction methods are const, acquire
+ *   no lock and don't use the prediction cache, so a single snapshot can be shared by any
+ *   number of threads.
+ */
+class InferenceSnapshot {
+ public:
+  virtual ~InferenceSnapshot() = default;
+  /**
+   * \brief Predict on a DMatrix.
+   *
+   * \param          data          Input data.
+   * \param          output_margin Whether to output the untransformed margin.
+   * \param [out]    out_preds     Output predictions.
+   * \param          layer_begin   Beginning of boosted tree layer used for prediction.
+   * \param          layer_end     End of booster layer. 0 means do not limit trees.
+   */
+  virtual void Predict(std::shared_ptr<DMatrix> data, bool output_margin,
+                       HostDeviceVector<bst_float>* out_preds, bst_layer_t layer_begin,
+                       bst_layer_t layer_end) const = 0;
+  /**
+   * \brief Inplace prediction, see `Learner::InplacePredict`.
+   *
+   * \param [out]    out_preds Output predictions, owned by the caller.
+   */
+  virtual void InplacePredict(std::shared_ptr<DMatrix> p_m, PredictionType type, float missing,
+                              HostDeviceVector<bst_float>* out_preds, bst_layer_t layer_begin,
+                              bst_layer_t layer_end) const = 0;
+  /**
+   * \brief Number of output groups of the model.
+   */
+  [[nodiscard]] virtual std::uint32_t Groups() const = 0;
+  /**
+   * \brief Number of boosted rounds of the model.
+   */
+  [[nodiscard]] virtual std::int32_t BoostedRounds() const = 0;
+};
+
 /*!
  * \brief Learner class that does training and prediction.
  *  This is the user facing module of xgboost training.
@@ -252,6 +293,31 @@ class Learner : public Model, public Configurable, public dmlc::Serializable {
                                              bool with_stats,
                                              std::string format) = 0;
 
+  /**
+   * \brief Create a frozen copy of the current model for concurrent inference.
+   */
+  virtual std::shared_ptr<InferenceSnapshot const> Snapshot() = 0;
+
+  /**
+   * \brief Export the cached prediction of a DMatrix, which can be imported into the same
+   *        model after it's reloaded to avoid predicting with all trees again.
+   *
+   *   The cache is brought up to date with the current model before exporting.  Output
+   *   contains the raw prediction, the number of layers it includes and a hash of the
+   *   DMatrix content.
+   *
+   * \param data The DMatrix used for evaluation or training.
+   * \param out  Output JSON object.
+   */
+  virtual void ExportPredictionCache(std::shared_ptr<DMatrix> data, Json* out) = 0;
+  /**
+   * \brief Attach a prediction cache obtained from `ExportPredictionCache` to a DMatrix.
+   *
+   *   The DMatrix must have the same content as the one used for export, and the model
+   *   must be the exported one or a model trained from it with more rounds.
+   */
+  virtual void ImportPredictionCache(std::shared_ptr<DMatrix> data, Json const& in) = 0;
+
   virtual XGBAPIThreadLocalEntry& GetThreadLocal() const = 0;
   /*!
    * \brief Create a new instance of learner.
@@ -34,6 +34,8 @@ struct PredictionCacheEntry {
   HostDeviceVector<bst_float> predictions;
   // The version of current cache, corresponding number of layers of trees
   std::uint32_t version{0};
+  // The DMatrix this entry belongs to, empty if the entry is not from a `PredictionContainer`.
+  std::weak_ptr<DMatrix> ref;
 
   PredictionCacheEntry() = default;
   /**
@@ -57,6 +59,7 @@ class PredictionContainer : public DMatrixCache<PredictionCacheEntry> {
   PredictionContainer() : DMatrixCache<PredictionCacheEntry>{DefaultSize()} {}
   PredictionCacheEntry& Cache(std::shared_ptr<DMatrix> m, std::int32_t device) {
     auto p_cache = this->CacheItem(m);
+    p_cache->ref = m;
     if (device != Context::kCpuId) {
       p_cache->predictions.SetDevice(device);
     }
@@ -325,6 +325,7 @@ class RegTree : public Model {
     stats_.resize(param_.num_nodes);
     split_types_.resize(param_.num_nodes, FeatureType::kNumerical);
     split_categories_segments_.resize(param_.num_nodes);
+    split_categories_compact_ptr_.resize(param_.num_nodes);
     for (int i = 0; i < param_.num_nodes; i++) {
       nodes_[i].SetLeaf(0.0f);
       nodes_[i].SetParent(kInvalidNodeId);
@@ -604,10 +605,11 @@ class RegTree : public Model {
   /*!
    * \brief calculate the approximate feature contributions for the given root
    * \param feat dense feature vector, if the feature is missing the field is set to NaN
+   * \param mean_values mean value of each node in the tree
    * \param out_contribs output vector to hold the contributions
    */
   void CalculateContributionsApprox(const RegTree::FVec& feat,
-                                    std::vector<float>* mean_values,
+                                    std::vector<float> const& mean_values,
                                     bst_float* out_contribs) const;
   /*!
    * \brief dump the model in the requested format as a text string
@@ -657,9 +659,33 @@ class RegTree : public Model {
       std::size_t beg{0};
       std::size_t size{0};
     };
+    /**
+     * \brief Encoding of the matching categories used for prediction, chosen for each node
+     *        when the split is created.  The bitset is always kept as the serialized form.
+     */
+    enum class Encoding : std::uint8_t {
+      kBitset = 0,
+      // Sorted list of categories, for small sets.
+      kSorted = 1,
+      // Perfect hash table, for sparse sets from high-cardinality features.
+      kHash = 2,
+    };
+    struct Compact {
+      // Position in `compact`.
+      std::size_t beg{0};
+      // Number of sorted categories, or the number of buckets of the hash table.  The seeds
+      // of buckets are followed by the slots.
+      std::size_t size{0};
+      // Number of slots in the hash table, a power of 2.
+      std::size_t n_slots{0};
+      Encoding kind{Encoding::kBitset};
+    };
     common::Span<FeatureType const> split_type;
     common::Span<uint32_t const> categories;
     common::Span<Segment const> node_ptr;
+    // Optional, nodes use the bitset if these are empty.
+    common::Span<Compact const> compact_ptr;
+    common::Span<bst_cat_t const> compact;
   };
 
   [[nodiscard]] CategoricalSplitMatrix GetCategoriesMatrix() const {
@@ -667,6 +693,9 @@ class RegTree : public Model {
     view.split_type = common::Span<FeatureType const>(this->GetSplitTypes());
     view.categories = this->GetSplitCategories();
     view.node_ptr = common::Span<CategoricalSplitMatrix::Segment const>(split_categories_segments_);
+    view.compact_ptr =
+        common::Span<CategoricalSplitMatrix::Compact const>(split_categories_compact_ptr_);
+    view.compact = common::Span<bst_cat_t const>(split_categories_compact_);
     return view;
   }
 
@@ -737,6 +766,10 @@ class RegTree : public Model {
   template <bool typed>
   void LoadCategoricalSplit(Json const& in);
   void SaveCategoricalSplit(Json* p_out) const;
+  /**
+   * \brief Choose the compact encoding of the categories for a categorical split.
+   */
+  void EncodeCategories(bst_node_t nidx);
   /*! \brief model parameter */
   TreeParam param_;
   // vector of nodes
@@ -751,6 +784,9 @@ class RegTree : public Model {
   std::vector<uint32_t> split_categories_;
   // Ptr to split categories of each node.
   std::vector<CategoricalSplitMatrix::Segment> split_categories_segments_;
+  // Compact encoding of split categories, derived from the bitsets and not serialized.
+  std::vector<bst_cat_t> split_categories_compact_;
+  std::vector<CategoricalSplitMatrix::Compact> split_categories_compact_ptr_;
   // ptr to multi-target tree with vector leaf.
   CopyUniquePtr<MultiTargetTree> p_mt_tree_;
   // allocate a new node,
@@ -770,6 +806,7 @@ class RegTree : public Model {
     stats_.resize(param_.num_nodes);
     split_types_.resize(param_.num_nodes, FeatureType::kNumerical);
     split_categories_segments_.resize(param_.num_nodes);
+    split_categories_compact_ptr_.resize(param_.num_nodes);
     return nd;
   }
   // delete a tree node, keep the parent field to allow trace back
@@ -16,6 +16,8 @@
 package ml.dmlc.xgboost4j.java;
 
 import java.io.*;
+import java.nio.ByteBuffer;
+import java.nio.ByteOrder;
 import java.util.Arrays;
 import java.util.HashMap;
 import java.util.HashSet;
@@ -374,6 +376,63 @@ public class Booster implements Serializable, KryoSerializable {
     return this.predict(data, outputMargin, treeLimit, false, false);
   }
 
+  private static ByteBuffer checkDirectBuffer(ByteBuffer buffer, String name) {
+    if (buffer == null || !buffer.isDirect()) {
+      throw new IllegalArgumentException("`" + name + "` must be a direct buffer.");
+    }
+    if (buffer.order() != ByteOrder.nativeOrder()) {
+      throw new IllegalArgumentException("`" + name + "` must use the native byte order.");
+    }
+    // The native side sees the remaining bytes of the buffer.
+    return buffer.slice();
+  }
+
+  /**
+   * Inplace prediction from a row-major dense matrix of float values stored off-heap. The
+   * input is used by the native library without copy, and the result is copied by the native
+   * library into the output buffer without going through a JVM array.
+   *
+   * @param data         direct buffer of nrow * ncol float values in native byte order.
+   * @param nrow         number of rows, the call returns without prediction when it's 0.
+   * @param ncol         number of columns.
+   * @param missing      value treated as missing.
+   * @param outputMargin output margin instead of transformed prediction.
+   * @param out          direct buffer with exactly nrow * nGroups float values remaining,
+   *                     the prediction of each row is stored contiguously.
+   * @throws XGBoostError native error
+   */
+  public synchronized void inplacePredict(ByteBuffer data, long nrow, int ncol, float missing,
+                                          boolean outputMargin, ByteBuffer out)
+      throws XGBoostError {
+    XGBoostJNI.checkCall(XGBoostJNI.XGBoosterPredictFromDense(handle,
+        checkDirectBuffer(data, "data"), nrow, ncol, missing, outputMargin,
+        checkDirectBuffer(out, "out")));
+  }
+
+  /**
+   * Inplace prediction from a CSR matrix stored off-heap. See
+   * {@link #inplacePredict(ByteBuffer, long, int, float, boolean, ByteBuffer)} for details.
+   *
+   * @param indptr       direct buffer of nrow + 1 long values.
+   * @param indices      direct buffer of int column indices.
+   * @param data         direct buffer of float values.
+   * @param nrow         number of rows.
+   * @param ncol         number of columns.
+   * @param missing      value treated as missing.
+   * @param outputMargin output margin instead of transformed prediction.
+   * @param out          direct buffer with exactly nrow * nGroups float values remaining.
+   * @throws XGBoostError native error
+   */
+  public synchronized void inplacePredict(ByteBuffer indptr, ByteBuffer indices, ByteBuffer data,
+                                          long nrow, int ncol, float missing,
+                                          boolean outputMargin, ByteBuffer out)
+      throws XGBoostError {
+    XGBoostJNI.checkCall(XGBoostJNI.XGBoosterPredictFromCSR(handle,
+        checkDirectBuffer(indptr, "indptr"), checkDirectBuffer(indices, "indices"),
+        checkDirectBuffer(data, "data"), nrow, ncol, missing, outputMargin,
+        checkDirectBuffer(out, "out")));
+  }
+
   /**
    * Save model to modelPath
    *
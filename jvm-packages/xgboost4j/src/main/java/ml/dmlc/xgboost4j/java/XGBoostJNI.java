@@ -119,6 +119,15 @@ class XGBoostJNI {
   public final static native int XGBoosterPredict(long handle, long dmat, int option_mask,
                                                   int ntree_limit, float[][] predicts);
 
+  public final static native int XGBoosterPredictFromDense(long handle, ByteBuffer data, long nrow,
+                                                           int ncol, float missing,
+                                                           boolean outputMargin, ByteBuffer out);
+
+  public final static native int XGBoosterPredictFromCSR(long handle, ByteBuffer indptr,
+                                                         ByteBuffer indices, ByteBuffer data,
+                                                         long nrow, int ncol, float missing,
+                                                         boolean outputMargin, ByteBuffer out);
+
   public final static native int XGBoosterLoadModel(long handle, String fname);
 
   public final static native int XGBoosterSaveModel(long handle, String fname);
@@ -17,7 +17,9 @@
 #include <rabit/c_api.h>
 #include <xgboost/base.h>
 #include <xgboost/c_api.h>
+#include <xgboost/context.h>
 #include <xgboost/json.h>
+#include <xgboost/linalg.h>
 #include <xgboost/logging.h>
 
 #include <cstddef>
@@ -28,6 +30,7 @@
 #include <type_traits>
 #include <vector>
 
+#include "../../../src/c_api/c_api_error.h"
 #include "../../../src/c_api/c_api_utils.h"
 
 #define JVM_CHECK_CALL(__expr)                                                 \
@@ -661,6 +664,143 @@ JNIEXPORT jint JNICALL Java_ml_dmlc_xgboost4j_java_XGBoostJNI_XGBoosterPredict
   return ret;
 }
 
+namespace {
+/**
+ * \brief Get the address of a direct buffer holding at least `n` elements of type T.
+ *
+ * \return nullptr and the error is set when the buffer is invalid.
+ */
+template <typename T>
+T *GetDirectBuffer(JNIEnv *jenv, jobject jbuffer, std::size_t n, char const *name) {
+  auto ptr = jbuffer ? static_cast<T *>(jenv->GetDirectBufferAddress(jbuffer)) : nullptr;
+  auto capacity = jbuffer ? jenv->GetDirectBufferCapacity(jbuffer) : -1;
+  if (ptr == nullptr || capacity < 0 || static_cast<std::size_t>(capacity) < n * sizeof(T)) {
+    auto msg = "Invalid direct buffer for `" + std::string{name} +
+               "`, expecting a direct buffer with at least " + std::to_string(n * sizeof(T)) +
+               " bytes.";
+    XGBAPISetLastError(msg.c_str());
+    return nullptr;
+  }
+  return ptr;
+}
+
+std::string MakeInplacePredictConfig(jfloat jmissing, jboolean joutput_margin) {
+  xgboost::Json jconfig{xgboost::Object{}};
+  jconfig["type"] = xgboost::Integer{joutput_margin ? 1 : 0};
+  jconfig["training"] = xgboost::Boolean{false};
+  jconfig["iteration_begin"] = xgboost::Integer{0};
+  jconfig["iteration_end"] = xgboost::Integer{0};
+  // The output is always a matrix of [n_samples, n_groups].
+  jconfig["strict_shape"] = xgboost::Boolean{true};
+  jconfig["cache_id"] = xgboost::Integer{0};
+  jconfig["missing"] = xgboost::Number{static_cast<float>(jmissing)};
+  std::string config;
+  xgboost::Json::Dump(jconfig, &config);
+  return config;
+}
+
+/**
+ * \brief Array interface of the output buffer, the number of groups is inferred from the
+ *        capacity of the buffer.  The number of rows must not be 0.
+ */
+jint MakeOutputInterface(JNIEnv *jenv, jobject jout, jlong jnrow, std::string *out) {
+  auto n_samples = static_cast<std::size_t>(jnrow);
+  auto capacity = jout ? jenv->GetDirectBufferCapacity(jout) : -1;
+  if (capacity < 0 || capacity % (n_samples * sizeof(float)) != 0) {
+    XGBAPISetLastError(
+        "The output buffer must be a direct buffer with the size of n_samples * n_groups "
+        "float values.");
+    return -1;
+  }
+  auto n_groups = static_cast<std::size_t>(capacity) / sizeof(float) / n_samples;
+  auto ptr = GetDirectBuffer<float>(jenv, jout, n_samples * n_groups, "out");
+  if (ptr == nullptr) {
+    return -1;
+  }
+  *out = xgboost::linalg::ArrayInterfaceStr(
+      xgboost::linalg::MakeTensorView(xgboost::Context::kCpuId,
+                                      xgboost::common::Span<float>{ptr, n_samples * n_groups},
+                                      n_samples, n_groups));
+  return 0;
+}
+}  // anonymous namespace
+
+/*
+ * Class:     ml_dmlc_xgboost4j_java_XGBoostJNI
+ * Method:    XGBoosterPredictFromDense
+ * Signature: (JLjava/nio/ByteBuffer;JIFZLjava/nio/ByteBuffer;)I
+ */
+JNIEXPORT jint JNICALL Java_ml_dmlc_xgboost4j_java_XGBoostJNI_XGBoosterPredictFromDense(
+    JNIEnv *jenv, jclass jcls, jlong jhandle, jobject jdata, jlong jnrow, jint jncol,
+    jfloat jmissing, jboolean joutput_margin, jobject jout) {
+  auto handle = reinterpret_cast<BoosterHandle>(jhandle);
+  auto n_samples = static_cast<std::size_t>(jnrow);
+  if (n_samples == 0) {
+    // The number of groups can't be inferred from an empty output, and there's nothing to
+    // predict.
+    return 0;
+  }
+  auto n_features = static_cast<std::size_t>(jncol);
+  auto data = GetDirectBuffer<float const>(jenv, jdata, n_samples * n_features, "data");
+  if (data == nullptr) {
+    return -1;
+  }
+  // Views over the memory owned by the JVM, no copy is made.
+  auto sdata = xgboost::linalg::ArrayInterfaceStr(xgboost::linalg::MakeTensorView(
+      xgboost::Context::kCpuId, xgboost::common::Span<float const>{data, n_samples * n_features},
+      n_samples, n_features));
+  std::string sout;
+  JVM_CHECK_CALL(MakeOutputInterface(jenv, jout, jnrow, &sout));
+  auto config = MakeInplacePredictConfig(jmissing, joutput_margin);
+  int ret = XGBoosterPredictFromDenseInto(handle, sdata.c_str(), config.c_str(), nullptr,
+                                          sout.c_str());
+  JVM_CHECK_CALL(ret);
+  return ret;
+}
+
+/*
+ * Class:     ml_dmlc_xgboost4j_java_XGBoostJNI
+ * Method:    XGBoosterPredictFromCSR
+ * Signature: (JLjava/nio/ByteBuffer;Ljava/nio/ByteBuffer;Ljava/nio/ByteBuffer;JIFZLjava/nio/ByteBuffer;)I
+ */
+JNIEXPORT jint JNICALL Java_ml_dmlc_xgboost4j_java_XGBoostJNI_XGBoosterPredictFromCSR(
+    JNIEnv *jenv, jclass jcls, jlong jhandle, jobject jindptr, jobject jindices, jobject jdata,
+    jlong jnrow, jint jncol, jfloat jmissing, jboolean joutput_margin, jobject jout) {
+  auto handle = reinterpret_cast<BoosterHandle>(jhandle);
+  auto n_samples = static_cast<std::size_t>(jnrow);
+  if (n_samples == 0) {
+    // The number of groups can't be inferred from an empty output, and there's nothing to
+    // predict.
+    return 0;
+  }
+  auto indptr = GetDirectBuffer<jlong const>(jenv, jindptr, n_samples + 1, "indptr");
+  if (indptr == nullptr) {
+    return -1;
+  }
+  auto nnz = static_cast<std::size_t>(indptr[n_samples]);
+  auto indices = GetDirectBuffer<jint const>(jenv, jindices, nnz, "indices");
+  auto data = GetDirectBuffer<jfloat const>(jenv, jdata, nnz, "data");
+  if (indices == nullptr || data == nullptr) {
+    return -1;
+  }
+
+  std::string sindptr, sindices, sdata;
+  using IndPtrT = std::conditional_t<std::is_convertible<jlong *, long *>::value, long, long long>;
+  using IndT =
+      std::conditional_t<std::is_convertible<jint *, std::int32_t *>::value, std::int32_t, long>;
+  xgboost::detail::MakeSparseFromPtr(
+      reinterpret_cast<IndPtrT const *>(indptr), reinterpret_cast<IndT const *>(indices),
+      static_cast<float const *>(data), n_samples + 1, &sindptr, &sindices, &sdata);
+  std::string sout;
+  JVM_CHECK_CALL(MakeOutputInterface(jenv, jout, jnrow, &sout));
+  auto config = MakeInplacePredictConfig(jmissing, joutput_margin);
+  int ret = XGBoosterPredictFromCSRInto(handle, sindptr.c_str(), sindices.c_str(), sdata.c_str(),
+                                        static_cast<bst_ulong>(jncol), config.c_str(), nullptr,
+                                        sout.c_str());
+  JVM_CHECK_CALL(ret);
+  return ret;
+}
+
 /*
  * Class:     ml_dmlc_xgboost4j_java_XGBoostJNI
  * Method:    XGBoosterLoadModel
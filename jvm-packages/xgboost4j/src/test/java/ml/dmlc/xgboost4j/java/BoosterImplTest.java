@@ -16,6 +16,8 @@
 package ml.dmlc.xgboost4j.java;
 
 import java.io.*;
+import java.nio.ByteBuffer;
+import java.nio.ByteOrder;
 import java.util.Arrays;
 import java.util.HashMap;
 import java.util.LinkedHashMap;
@@ -102,6 +104,70 @@ public class BoosterImplTest {
     TestCase.assertTrue(eval.eval(predicts, testMat) < 0.1f);
   }
 
+  @Test
+  public void testInplacePredict() throws XGBoostError {
+    DMatrix trainMat = new DMatrix(this.train_uri);
+    DMatrix testMat = new DMatrix(this.test_uri);
+    Booster booster = trainBooster(trainMat, testMat);
+
+    int nrow = 64;
+    int ncol = 127;
+    java.util.Random rng = new java.util.Random(0);
+    float[] data = new float[nrow * ncol];
+    ByteBuffer dense = ByteBuffer.allocateDirect(data.length * 4).order(ByteOrder.nativeOrder());
+    for (int i = 0; i < data.length; i++) {
+      data[i] = rng.nextFloat() > 0.5f ? 1.0f : Float.NaN;
+      dense.putFloat(i * 4, data[i]);
+    }
+    float[][] expected = booster.predict(new DMatrix(data, nrow, ncol, Float.NaN));
+
+    ByteBuffer out = ByteBuffer.allocateDirect(nrow * 4).order(ByteOrder.nativeOrder());
+    booster.inplacePredict(dense, nrow, ncol, Float.NaN, false, out);
+    for (int i = 0; i < nrow; i++) {
+      TestCase.assertEquals(expected[i][0], out.getFloat(i * 4), 1e-6f);
+    }
+
+    // CSR with the same data.
+    int nnz = 0;
+    for (float v : data) {
+      nnz += Float.isNaN(v) ? 0 : 1;
+    }
+    ByteBuffer indptr = ByteBuffer.allocateDirect((nrow + 1) * 8).order(ByteOrder.nativeOrder());
+    ByteBuffer indices = ByteBuffer.allocateDirect(nnz * 4).order(ByteOrder.nativeOrder());
+    ByteBuffer values = ByteBuffer.allocateDirect(nnz * 4).order(ByteOrder.nativeOrder());
+    int k = 0;
+    indptr.putLong(0, 0);
+    for (int i = 0; i < nrow; i++) {
+      for (int j = 0; j < ncol; j++) {
+        float v = data[i * ncol + j];
+        if (!Float.isNaN(v)) {
+          indices.putInt(k * 4, j);
+          values.putFloat(k * 4, v);
+          k++;
+        }
+      }
+      indptr.putLong((i + 1) * 8, k);
+    }
+    ByteBuffer csrOut = ByteBuffer.allocateDirect(nrow * 4).order(ByteOrder.nativeOrder());
+    booster.inplacePredict(indptr, indices, values, nrow, ncol, Float.NaN, false, csrOut);
+    for (int i = 0; i < nrow; i++) {
+      TestCase.assertEquals(expected[i][0], csrOut.getFloat(i * 4), 1e-6f);
+    }
+
+    // Empty batch.
+    ByteBuffer empty = ByteBuffer.allocateDirect(0).order(ByteOrder.nativeOrder());
+    booster.inplacePredict(empty, 0, ncol, Float.NaN, false, empty);
+    booster.inplacePredict(indptr, empty, empty, 0, ncol, Float.NaN, false, empty);
+
+    // Output buffer with invalid size.
+    ByteBuffer invalid = ByteBuffer.allocateDirect(nrow * 4 + 4).order(ByteOrder.nativeOrder());
+    try {
+      booster.inplacePredict(dense, nrow, ncol, Float.NaN, false, invalid);
+      TestCase.fail("Invalid output buffer should be rejected.");
+    } catch (XGBoostError ignored) {
+    }
+  }
+
   @Test
   public void saveLoadModelWithPath() throws XGBoostError, IOException {
     DMatrix trainMat = new DMatrix(this.train_uri);
@@ -4,8 +4,11 @@
 #include "xgboost/c_api.h"
 
 #include <algorithm>                         // for copy
+#include <cctype>                            // for isspace
 #include <cinttypes>                         // for strtoimax
 #include <cmath>                             // for nan
+#include <cstddef>                           // for size_t
+#include <cstdint>                           // for int32_t
 #include <cstring>                           // for strcmp
 #include <fstream>                           // for operator<<, basic_ostream, ios, stringstream
 #include <functional>                        // for less
@@ -22,7 +25,9 @@
 #include "../common/charconv.h"              // for from_chars, to_chars, NumericLimits, from_ch...
 #include "../common/io.h"                    // for FileExtension, LoadSequentialFile, MemoryBuf...
 #include "../common/threading_utils.h"       // for OmpGetNumThreads, ParallelFor
+#include "../common/trace.h"                 // for Tracer
 #include "../data/adapter.h"                 // for ArrayAdapter, DenseAdapter, RecordBatchesIte...
+#include "../data/array_interface.h"         // for ArrayInterface, ArrayInterfaceHandler
 #include "../data/proxy_dmatrix.h"           // for DMatrixProxy
 #include "../data/simple_dmatrix.h"          // for SimpleDMatrix
 #include "c_api_error.h"                     // for xgboost_CHECK_C_ARG_PTR, API_END, API_BEGIN
@@ -42,6 +47,7 @@
 #include "xgboost/intrusive_ptr.h"           // for xgboost
 #include "xgboost/json.h"                    // for Json, get, Integer, IsA, Boolean, String
 #include "xgboost/learner.h"                 // for Learner, PredictionType
+#include "xgboost/linalg.h"                  // for TensorView, UnravelIndex
 #include "xgboost/logging.h"                 // for LOG_FATAL, LogMessageFatal, CHECK, LogCheck_EQ
 #include "xgboost/predictor.h"               // for PredictionCacheEntry
 #include "xgboost/span.h"                    // for Span
@@ -235,6 +241,37 @@ XGB_DLL int XGBGetGlobalConfig(const char** json_str) {
   API_END();
 }
 
+XGB_DLL int XGBTraceStart(char const *config) {
+  API_BEGIN();
+  std::size_t capacity = 1 << 16;
+  if (config != nullptr) {
+    auto jconfig = Json::Load(StringView{config});
+    auto n = OptionalArg<Integer, std::int64_t>(jconfig, "buffer_size",
+                                                static_cast<std::int64_t>(capacity));
+    CHECK_GT(n, 0) << "Invalid `buffer_size` for tracing.";
+    capacity = static_cast<std::size_t>(n);
+  }
+  common::Tracer::Start(capacity);
+  API_END();
+}
+
+XGB_DLL int XGBTraceStop() {
+  API_BEGIN();
+  common::Tracer::Stop();
+  API_END();
+}
+
+XGB_DLL int XGBTraceDump(bst_ulong *out_len, char const **out_str) {
+  API_BEGIN();
+  xgboost_CHECK_C_ARG_PTR(out_len);
+  xgboost_CHECK_C_ARG_PTR(out_str);
+  auto &ret = GlobalConfigAPIThreadLocalStore::Get()->ret_str;
+  ret = common::Tracer::Dump();
+  *out_str = ret.c_str();
+  *out_len = static_cast<bst_ulong>(ret.size());
+  API_END();
+}
+
 XGB_DLL int XGDMatrixCreateFromFile(const char *fname, int silent, DMatrixHandle *out) {
   xgboost_CHECK_C_ARG_PTR(fname);
   xgboost_CHECK_C_ARG_PTR(out);
@@ -952,13 +989,14 @@ XGB_DLL int XGBoosterPredict(BoosterHandle handle,
   API_END();
 }
 
-XGB_DLL int XGBoosterPredictFromDMatrix(BoosterHandle handle,
-                                        DMatrixHandle dmat,
-                                        char const* c_json_config,
-                                        xgboost::bst_ulong const **out_shape,
-                                        xgboost::bst_ulong *out_dim,
-                                        bst_float const **out_result) {
-  API_BEGIN();
+namespace {
+/**
+ * \brief Run prediction on a DMatrix, the result is stored in the thread-local entry of the
+ *        learner.
+ */
+HostDeviceVector<float> const &PredictFromDMatrixImpl(BoosterHandle handle, DMatrixHandle dmat,
+                                                      char const *c_json_config,
+                                                      xgboost::bst_ulong *out_dim) {
   if (handle == nullptr) {
     LOG(FATAL) << "Booster has not been initialized or has already been disposed.";
   }
@@ -998,9 +1036,6 @@ XGB_DLL int XGBoosterPredictFromDMatrix(BoosterHandle handle,
                    type == PredictionType::kLeaf, contribs, approximate,
                    interactions);
 
-  xgboost_CHECK_C_ARG_PTR(out_result);
-  *out_result = dmlc::BeginPtr(entry.predictions.ConstHostVector());
-
   auto &shape = learner->GetThreadLocal().prediction_shape;
   auto chunksize = p_m->Info().num_row_ == 0 ? 0 : entry.predictions.Size() / p_m->Info().num_row_;
   auto rounds = iteration_end - iteration_begin;
@@ -1009,18 +1044,15 @@ XGB_DLL int XGBoosterPredictFromDMatrix(BoosterHandle handle,
   bool strict_shape = RequiredArg<Boolean>(config, "strict_shape", __func__);
 
   xgboost_CHECK_C_ARG_PTR(out_dim);
-  xgboost_CHECK_C_ARG_PTR(out_shape);
-
   CalcPredictShape(strict_shape, type, p_m->Info().num_row_,
                    p_m->Info().num_col_, chunksize, learner->Groups(), rounds,
                    &shape, out_dim);
-  *out_shape = dmlc::BeginPtr(shape);
-  API_END();
+  return entry.predictions;
 }
 
-void InplacePredictImpl(std::shared_ptr<DMatrix> p_m, char const *c_json_config, Learner *learner,
-                        xgboost::bst_ulong const **out_shape, xgboost::bst_ulong *out_dim,
-                        const float **out_result) {
+HostDeviceVector<float> const &InplacePredictImpl(std::shared_ptr<DMatrix> p_m,
+                                                  char const *c_json_config, Learner *learner,
+                                                  xgboost::bst_ulong *out_dim) {
   xgboost_CHECK_C_ARG_PTR(c_json_config);
   auto config = Json::Load(StringView{c_json_config});
   CHECK_EQ(get<Integer const>(config["cache_id"]), 0) << "Cache ID is not supported yet";
@@ -1042,12 +1074,116 @@ void InplacePredictImpl(std::shared_ptr<DMatrix> p_m, char const *c_json_config,
   xgboost_CHECK_C_ARG_PTR(out_dim);
   CalcPredictShape(strict_shape, type, n_samples, n_features, chunksize, learner->Groups(),
                    learner->BoostedRounds(), &shape, out_dim);
+  return *p_predt;
+}
 
+std::shared_ptr<DMatrix> GetProxy(DMatrixHandle m) {
+  std::shared_ptr<DMatrix> p_m{nullptr};
+  if (!m) {
+    p_m.reset(new data::DMatrixProxy);
+  } else {
+    p_m = *static_cast<std::shared_ptr<DMatrix> *>(m);
+  }
+  CHECK(dynamic_cast<data::DMatrixProxy *>(p_m.get())) << "Invalid input type for inplace predict.";
+  return p_m;
+}
+
+/**
+ * \brief Copy the prediction into a buffer owned by the caller.
+ *
+ *   The predictors output into the thread-local entry, this is the only copy made for the
+ *   `*Into` functions.
+ *
+ * \param predt Prediction stored in the thread-local entry.
+ * \param shape Shape of the prediction.
+ * \param c_out JSON encoded __array_interface__ of the output buffer.  It must have the same
+ *              shape as the prediction, strides are supported.
+ */
+void CopyPredictionToBuffer(Context const *ctx, HostDeviceVector<float> const &predt,
+                            std::vector<bst_ulong> const &shape, char const *c_out) {
+  xgboost_CHECK_C_ARG_PTR(c_out);
+  auto j_out = Json::Load(StringView{c_out});
+  auto const &j_data = get<Array const>(j_out["data"]);
+  CHECK(j_data.size() < 2 || !IsA<Boolean>(j_data[1]) || !get<Boolean const>(j_data[1]))
+      << "The output buffer for prediction is read-only.";
+  auto const &j_shape = get<Array const>(j_out["shape"]);
+  CHECK_EQ(j_shape.size(), shape.size())
+      << "Invalid dimension of the output buffer for prediction.";
+  for (std::size_t i = 0; i < shape.size(); ++i) {
+    CHECK_EQ(static_cast<bst_ulong>(get<Integer const>(j_shape[i])), shape[i])
+        << "Invalid shape of the output buffer for prediction at dimension " << i << ".";
+  }
+
+  // Trailing dimensions are filled with 1.
+  std::int32_t constexpr kMaxDim = 4;
+  CHECK_LE(shape.size(), kMaxDim);
+  ArrayInterface<kMaxDim, false> out{j_out};
+  auto h_predt = predt.ConstHostSpan();
+  CHECK_EQ(out.n, h_predt.size());
+  if (out.n == 0) {
+    return;
+  }
+  CHECK(!ArrayInterfaceHandler::IsCudaPtr(out.data))
+      << "The output buffer for prediction must be in host memory.";
+
+  auto write = [&](auto t) {
+    using T = decltype(t);
+    linalg::TensorView<T, kMaxDim> t_out{
+        common::Span<T>{static_cast<T *>(const_cast<void *>(out.data)),
+                        std::numeric_limits<std::size_t>::max()},
+        out.shape, out.strides, Context::kCpuId};
+    // The prediction is C-contiguous. A linear copy is valid only when the output has the
+    // same layout, F-contiguous outputs are written through their strides.
+    if (t_out.CContiguous()) {
+      auto ptr = t_out.Values().data();
+      common::ParallelFor(t_out.Size(), ctx->Threads(),
+                          [&](std::size_t i) { ptr[i] = static_cast<T>(h_predt[i]); });
+    } else {
+      common::ParallelFor(t_out.Size(), ctx->Threads(), [&](std::size_t i) {
+        linalg::detail::Apply(t_out, linalg::UnravelIndex(i, t_out.Shape())) =
+            static_cast<T>(h_predt[i]);
+      });
+    }
+  };
+  switch (out.type) {
+    case ArrayInterfaceHandler::kF4: {
+      write(float{});
+      break;
+    }
+    case ArrayInterfaceHandler::kF8: {
+      write(double{});
+      break;
+    }
+    default:
+      LOG(FATAL) << "The output buffer for prediction must be float32 or float64.";
+  }
+}
+}  // anonymous namespace
+
+XGB_DLL int XGBoosterPredictFromDMatrix(BoosterHandle handle,
+                                        DMatrixHandle dmat,
+                                        char const* c_json_config,
+                                        xgboost::bst_ulong const **out_shape,
+                                        xgboost::bst_ulong *out_dim,
+                                        bst_float const **out_result) {
+  API_BEGIN();
+  auto const &predt = PredictFromDMatrixImpl(handle, dmat, c_json_config, out_dim);
+  auto *learner = static_cast<Learner *>(handle);
   xgboost_CHECK_C_ARG_PTR(out_result);
   xgboost_CHECK_C_ARG_PTR(out_shape);
+  *out_result = dmlc::BeginPtr(predt.ConstHostVector());
+  *out_shape = dmlc::BeginPtr(learner->GetThreadLocal().prediction_shape);
+  API_END();
+}
 
-  *out_result = dmlc::BeginPtr(p_predt->HostVector());
-  *out_shape = dmlc::BeginPtr(shape);
+XGB_DLL int XGBoosterPredictFromDMatrixInto(BoosterHandle handle, DMatrixHandle dmat,
+                                            char const *c_json_config, char const *out) {
+  API_BEGIN();
+  xgboost::bst_ulong out_dim{0};
+  auto const &predt = PredictFromDMatrixImpl(handle, dmat, c_json_config, &out_dim);
+  auto *learner = static_cast<Learner *>(handle);
+  CopyPredictionToBuffer(learner->Ctx(), predt, learner->GetThreadLocal().prediction_shape, out);
+  API_END();
 }
 
 XGB_DLL int XGBoosterPredictFromDense(BoosterHandle handle, char const *array_interface,
@@ -1056,18 +1192,30 @@ XGB_DLL int XGBoosterPredictFromDense(BoosterHandle handle, char const *array_in
                                       xgboost::bst_ulong *out_dim, const float **out_result) {
   API_BEGIN();
   CHECK_HANDLE();
-  std::shared_ptr<DMatrix> p_m{nullptr};
-  if (!m) {
-    p_m.reset(new data::DMatrixProxy);
-  } else {
-    p_m = *static_cast<std::shared_ptr<DMatrix> *>(m);
-  }
-  auto proxy = dynamic_cast<data::DMatrixProxy *>(p_m.get());
-  CHECK(proxy) << "Invalid input type for inplace predict.";
+  auto p_m = GetProxy(m);
   xgboost_CHECK_C_ARG_PTR(array_interface);
-  proxy->SetArrayData(array_interface);
+  static_cast<data::DMatrixProxy *>(p_m.get())->SetArrayData(array_interface);
   auto *learner = static_cast<xgboost::Learner *>(handle);
-  InplacePredictImpl(p_m, c_json_config, learner, out_shape, out_dim, out_result);
+  auto const &predt = InplacePredictImpl(p_m, c_json_config, learner, out_dim);
+  xgboost_CHECK_C_ARG_PTR(out_result);
+  xgboost_CHECK_C_ARG_PTR(out_shape);
+  *out_result = dmlc::BeginPtr(predt.ConstHostVector());
+  *out_shape = dmlc::BeginPtr(learner->GetThreadLocal().prediction_shape);
+  API_END();
+}
+
+XGB_DLL int XGBoosterPredictFromDenseInto(BoosterHandle handle, char const *array_interface,
+                                          char const *c_json_config, DMatrixHandle m,
+                                          char const *out) {
+  API_BEGIN();
+  CHECK_HANDLE();
+  auto p_m = GetProxy(m);
+  xgboost_CHECK_C_ARG_PTR(array_interface);
+  static_cast<data::DMatrixProxy *>(p_m.get())->SetArrayData(array_interface);
+  auto *learner = static_cast<xgboost::Learner *>(handle);
+  xgboost::bst_ulong out_dim{0};
+  auto const &predt = InplacePredictImpl(p_m, c_json_config, learner, &out_dim);
+  CopyPredictionToBuffer(learner->Ctx(), predt, learner->GetThreadLocal().prediction_shape, out);
   API_END();
 }
 
@@ -1078,18 +1226,58 @@ XGB_DLL int XGBoosterPredictFromCSR(BoosterHandle handle, char const *indptr, ch
                                     xgboost::bst_ulong *out_dim, const float **out_result) {
   API_BEGIN();
   CHECK_HANDLE();
-  std::shared_ptr<DMatrix> p_m{nullptr};
-  if (!m) {
-    p_m.reset(new data::DMatrixProxy);
-  } else {
-    p_m = *static_cast<std::shared_ptr<DMatrix> *>(m);
-  }
-  auto proxy = dynamic_cast<data::DMatrixProxy *>(p_m.get());
-  CHECK(proxy) << "Invalid input type for inplace predict.";
+  auto p_m = GetProxy(m);
   xgboost_CHECK_C_ARG_PTR(indptr);
-  proxy->SetCSRData(indptr, indices, data, cols, true);
+  static_cast<data::DMatrixProxy *>(p_m.get())->SetCSRData(indptr, indices, data, cols, true);
   auto *learner = static_cast<xgboost::Learner *>(handle);
-  InplacePredictImpl(p_m, c_json_config, learner, out_shape, out_dim, out_result);
+  auto const &predt = InplacePredictImpl(p_m, c_json_config, learner, out_dim);
+  xgboost_CHECK_C_ARG_PTR(out_result);
+  xgboost_CHECK_C_ARG_PTR(out_shape);
+  *out_result = dmlc::BeginPtr(predt.ConstHostVector());
+  *out_shape = dmlc::BeginPtr(learner->GetThreadLocal().prediction_shape);
+  API_END();
+}
+
+XGB_DLL int XGBoosterPredictFromCSRInto(BoosterHandle handle, char const *indptr,
+                                        char const *indices, char const *data,
+                                        xgboost::bst_ulong cols, char const *c_json_config,
+                                        DMatrixHandle m, char const *out) {
+  API_BEGIN();
+  CHECK_HANDLE();
+  auto p_m = GetProxy(m);
+  xgboost_CHECK_C_ARG_PTR(indptr);
+  static_cast<data::DMatrixProxy *>(p_m.get())->SetCSRData(indptr, indices, data, cols, true);
+  auto *learner = static_cast<xgboost::Learner *>(handle);
+  xgboost::bst_ulong out_dim{0};
+  auto const &predt = InplacePredictImpl(p_m, c_json_config, learner, &out_dim);
+  CopyPredictionToBuffer(learner->Ctx(), predt, learner->GetThreadLocal().prediction_shape, out);
+  API_END();
+}
+
+XGB_DLL int XGBoosterPredictFromCallback(BoosterHandle handle, DataIterHandle iter,
+                                         DMatrixHandle proxy, XGDMatrixCallbackNext *next,
+                                         char const *c_json_config,
+                                         XGBoosterPredictCallback *output) {
+  API_BEGIN();
+  CHECK_HANDLE();
+  xgboost_CHECK_C_ARG_PTR(proxy);
+  xgboost_CHECK_C_ARG_PTR(next);
+  xgboost_CHECK_C_ARG_PTR(output);
+  auto p_m = GetProxy(proxy);
+  auto *learner = static_cast<xgboost::Learner *>(handle);
+  while (next(iter)) {
+    xgboost::bst_ulong out_dim{0};
+    auto const &predt = InplacePredictImpl(p_m, c_json_config, learner, &out_dim);
+    auto const &shape = learner->GetThreadLocal().prediction_shape;
+    // Keep the error set by the callback, if any, so that bindings can report the cause.
+    XGBAPISetLastError("");
+    if (output(iter, dmlc::BeginPtr(shape), out_dim, predt.ConstHostPointer()) != 0) {
+      if (std::strlen(XGBGetLastError()) == 0) {
+        XGBAPISetLastError("Failed to consume the prediction of a batch.");
+      }
+      return -1;
+    }
+  }
   API_END();
 }
 
@@ -1234,6 +1422,64 @@ XGB_DLL int XGBoosterSaveModelToBuffer(BoosterHandle handle, char const *json_co
   API_END();
 }
 
+XGB_DLL int XGBoosterExportPredictionCache(BoosterHandle handle, DMatrixHandle dmat,
+                                           char const *json_config, xgboost::bst_ulong *out_len,
+                                           char const **out_dptr) {
+  API_BEGIN();
+  CHECK_HANDLE();
+
+  xgboost_CHECK_C_ARG_PTR(dmat);
+  xgboost_CHECK_C_ARG_PTR(json_config);
+  xgboost_CHECK_C_ARG_PTR(out_dptr);
+  xgboost_CHECK_C_ARG_PTR(out_len);
+
+  auto config = Json::Load(StringView{json_config});
+  auto format = RequiredArg<String>(config, "format", __func__);
+  std::ios::openmode mode{std::ios::out};
+  if (format == "json") {
+    mode = std::ios::out;
+  } else if (format == "ubj") {
+    mode = std::ios::binary;
+  } else {
+    LOG(FATAL) << "Unknown format: `" << format << "`";
+  }
+
+  auto *learner = static_cast<Learner *>(handle);
+  auto p_m = *static_cast<std::shared_ptr<DMatrix> *>(dmat);
+  Json out{Object{}};
+  learner->ExportPredictionCache(p_m, &out);
+
+  std::vector<char> &raw_char_vec = learner->GetThreadLocal().ret_char_vec;
+  Json::Dump(out, &raw_char_vec, mode);
+  *out_dptr = dmlc::BeginPtr(raw_char_vec);
+  *out_len = static_cast<xgboost::bst_ulong>(raw_char_vec.size());
+  API_END();
+}
+
+XGB_DLL int XGBoosterImportPredictionCache(BoosterHandle handle, DMatrixHandle dmat,
+                                           char const *buf, xgboost::bst_ulong len) {
+  API_BEGIN();
+  CHECK_HANDLE();
+
+  xgboost_CHECK_C_ARG_PTR(dmat);
+  xgboost_CHECK_C_ARG_PTR(buf);
+  CHECK_GE(len, 2) << "Invalid prediction cache.";
+
+  StringView str{buf, static_cast<std::size_t>(len)};
+  CHECK_EQ(str[0], '{') << "Invalid prediction cache.";
+  Json in;
+  if (str[1] == '"' || std::isspace(str[1])) {
+    in = Json::Load(str);
+  } else {
+    in = Json::Load(str, std::ios::binary);
+  }
+
+  auto *learner = static_cast<Learner *>(handle);
+  auto p_m = *static_cast<std::shared_ptr<DMatrix> *>(dmat);
+  learner->ImportPredictionCache(p_m, in);
+  API_END();
+}
+
 XGB_DLL int XGBoosterGetModelRaw(BoosterHandle handle, xgboost::bst_ulong *out_len,
                                  const char **out_dptr) {
   API_BEGIN();
@@ -18,7 +18,9 @@
 
 #include <iomanip>
 #include <ctime>
+#include <future>
 #include <string>
+#include <utility>
 #include <cstdio>
 #include <cstring>
 #include <vector>
@@ -28,6 +30,9 @@
 #include "common/io.h"
 #include "common/version.h"
 #include "c_api/c_api_utils.h"
+#include "data/file_iterator.h"
+#include "data/gradient_index.h"
+#include "tree/param.h"
 
 namespace xgboost {
 enum CLITask {
@@ -65,6 +70,8 @@ struct CLIParam : public XGBoostParameter<CLIParam> {
   int iteration_end;
   /*!\brief whether to directly output margin value */
   bool pred_margin;
+  /*!\brief whether to predict the test data batch by batch */
+  bool pred_streaming;
   /*! \brief whether dump statistics along with model */
   int dump_stats;
   /*! \brief what format to dump the model in */
@@ -120,6 +127,9 @@ struct CLIParam : public XGBoostParameter<CLIParam> {
         .describe("End of boosted tree iteration used for prediction.  0 means all the trees.");
     DMLC_DECLARE_FIELD(pred_margin).set_default(false)
         .describe("Whether to predict margin value instead of probability.");
+    DMLC_DECLARE_FIELD(pred_streaming).set_default(false)
+        .describe("Whether to predict the test data chunk by chunk instead of loading all of "
+                  "it into memory.");
     DMLC_DECLARE_FIELD(dump_stats).set_default(false)
         .describe("Whether dump the model statistics.");
     DMLC_DECLARE_FIELD(dump_format).set_default("text")
@@ -174,6 +184,8 @@ void CLIError(dmlc::Error const& e) {
 class CLI {
   CLIParam param_;
   std::unique_ptr<Learner> learner_;
+  // Pending write of the last checkpoint.
+  std::future<void> checkpoint_;
   enum Print {
     kNone,
     kVersion,
@@ -191,6 +203,35 @@ class CLI {
     learner_->Configure();
   }
 
+  /**
+   * \brief Build the gradient index of the training data before the learner is created, so
+   *        that the sketching overlaps with loading the evaluation data.  Only the CPU hist
+   *        tree method is handled, the index is regenerated by the updater if the parameter
+   *        turns out to be different.
+   */
+  void WarmUpGradientIndex(DMatrix* p_fmat) const {
+    std::string tree_method;
+    for (auto const& kv : param_.cfg) {
+      if (kv.first == "tree_method") {
+        tree_method = kv.second;
+      }
+    }
+    if (tree_method != "hist" || !p_fmat->SingleColBlock()) {
+      return;
+    }
+    Context ctx;
+    ctx.UpdateAllowUnknown(param_.cfg);
+    if (!ctx.IsCPU()) {
+      return;
+    }
+    tree::TrainParam tparam;
+    tparam.UpdateAllowUnknown(param_.cfg);
+    auto batch = tree::HistBatch(&tparam);
+    for (auto const& page : p_fmat->GetBatches<GHistIndexMatrix>(&ctx, batch)) {
+      (void)page;
+    }
+  }
+
   void CLITrain() {
     const double tstart_data_load = dmlc::GetTime();
     if (collective::IsDistributed()) {
@@ -198,18 +239,34 @@ class CLI {
       LOG(CONSOLE) << "start " << pname << ":" << collective::GetRank();
     }
     // load in data.
-    std::shared_ptr<DMatrix> dtrain(DMatrix::Load(
-        param_.train_path, ConsoleLogger::GlobalVerbosity() > ConsoleLogger::DefaultVerbosity(),
-        static_cast<DataSplitMode>(param_.dsplit)));
+    auto load = [this](std::string const& path) {
+      return std::shared_ptr<DMatrix>(DMatrix::Load(
+          path, ConsoleLogger::GlobalVerbosity() > ConsoleLogger::DefaultVerbosity(),
+          static_cast<DataSplitMode>(param_.dsplit)));
+    };
+    // Loading data performs collective operations in distributed training, which must be
+    // issued in the same order by all workers.  Deferred tasks run in the order of `get`.
+    bool distributed = collective::IsDistributed();
+    auto policy = distributed ? std::launch::deferred : std::launch::async;
+    auto f_train = std::async(policy, [&] {
+      auto p_fmat = load(param_.train_path);
+      if (!distributed) {
+        this->WarmUpGradientIndex(p_fmat.get());
+      }
+      return p_fmat;
+    });
+    std::vector<std::future<std::shared_ptr<DMatrix>>> f_eval;
+    for (auto const& path : param_.eval_data_paths) {
+      f_eval.emplace_back(std::async(policy, load, std::cref(path)));
+    }
+
+    std::shared_ptr<DMatrix> dtrain = f_train.get();
     std::vector<std::shared_ptr<DMatrix>> deval;
     std::vector<std::shared_ptr<DMatrix>> cache_mats;
     std::vector<std::shared_ptr<DMatrix>> eval_datasets;
     cache_mats.push_back(dtrain);
-    for (size_t i = 0; i < param_.eval_data_names.size(); ++i) {
-      deval.emplace_back(std::shared_ptr<DMatrix>(
-          DMatrix::Load(param_.eval_data_paths[i],
-                        ConsoleLogger::GlobalVerbosity() > ConsoleLogger::DefaultVerbosity(),
-                        static_cast<DataSplitMode>(param_.dsplit))));
+    for (auto& f : f_eval) {
+      deval.emplace_back(f.get());
       eval_datasets.push_back(deval.back());
       cache_mats.push_back(deval.back());
     }
@@ -247,11 +304,12 @@ class CLI {
         std::ostringstream os;
         os << param_.model_dir << '/' << std::setfill('0') << std::setw(4)
            << i + 1 << ".model";
-        this->SaveModel(os.str(), learner_.get());
+        this->SaveCheckpoint(os.str());
       }
 
       version += 1;
     }
+    this->WaitCheckpoint();
     LOG(INFO) << "Complete Training loop time: " << dmlc::GetTime() - start
               << " sec";
     // always save final round
@@ -323,11 +381,7 @@ class CLI {
 
     LOG(INFO) << "Start prediction...";
     HostDeviceVector<bst_float> preds;
-    if (param_.ntree_limit != 0) {
-      param_.iteration_end = GetIterationFromTreeLimit(param_.ntree_limit, learner_.get());
-      LOG(WARNING) << "`ntree_limit` is deprecated, use `iteration_begin` and "
-                      "`iteration_end` instead.";
-    }
+    this->ResolveIterationEnd();
     learner_->Predict(dtest, param_.pred_margin, &preds, param_.iteration_begin,
                       param_.iteration_end);
     LOG(CONSOLE) << "Writing prediction to " << param_.name_pred;
@@ -335,14 +389,75 @@ class CLI {
     std::unique_ptr<dmlc::Stream> fo(
         dmlc::Stream::Create(param_.name_pred.c_str(), "w"));
     dmlc::ostream os(fo.get());
-    for (bst_float p : preds.ConstHostVector()) {
-      os << std::setprecision(std::numeric_limits<bst_float>::max_digits10) << p
-         << '\n';
+    WritePrediction(preds.ConstHostVector(), &os);
+    // force flush before fo destruct.
+    os.set_stream(nullptr);
+  }
+
+  /**
+   * \brief Predict the test data chunk by chunk with constant memory usage.
+   *
+   *   The parser reads the next chunk in a background thread while the current one is being
+   *   predicted, and the prediction of the previous chunk is written at the same time.
+   */
+  void CLIPredictStreaming() {
+    CHECK_NE(param_.test_path, CLIParam::kNull)
+        << "Test dataset parameter test:data must be specified.";
+    CHECK(!collective::IsDistributed())
+        << "Streaming prediction is not supported in distributed mode.";
+    // load model
+    CHECK_NE(param_.model_in, CLIParam::kNull) << "Must specify model_in for predict";
+    this->ResetLearner({});
+    this->ResolveIterationEnd();
+
+    data::FileIterator iter{param_.test_path, 0, 1, learner_->GetNumFeature()};
+    iter.Reset();
+    auto p_proxy = *static_cast<std::shared_ptr<DMatrix>*>(iter.Proxy());
+    auto type = param_.pred_margin ? PredictionType::kMargin : PredictionType::kValue;
+
+    LOG(INFO) << "Start prediction...";
+    std::unique_ptr<dmlc::Stream> fo(
+        dmlc::Stream::Create(param_.name_pred.c_str(), "w"));
+    dmlc::ostream os(fo.get());
+    // Pending write of the previous chunk.
+    std::future<void> write;
+    std::size_t n_samples = 0;
+    while (iter.Next()) {
+      HostDeviceVector<bst_float>* p_preds{nullptr};
+      learner_->InplacePredict(p_proxy, type, std::numeric_limits<float>::quiet_NaN(), &p_preds,
+                               param_.iteration_begin, param_.iteration_end);
+      n_samples += p_proxy->Info().num_row_;
+      // The prediction buffer is owned by the learner and reused by the next chunk.
+      std::vector<bst_float> h_preds = p_preds->ConstHostVector();
+      if (write.valid()) {
+        write.get();
+      }
+      write = std::async(std::launch::async, [&os, h_preds = std::move(h_preds)] {
+        WritePrediction(h_preds, &os);
+      });
+    }
+    if (write.valid()) {
+      write.get();
     }
+    LOG(CONSOLE) << "Wrote prediction of " << n_samples << " samples to " << param_.name_pred;
     // force flush before fo destruct.
     os.set_stream(nullptr);
   }
 
+  void ResolveIterationEnd() {
+    if (param_.ntree_limit != 0) {
+      param_.iteration_end = GetIterationFromTreeLimit(param_.ntree_limit, learner_.get());
+      LOG(WARNING) << "`ntree_limit` is deprecated, use `iteration_begin` and "
+                      "`iteration_end` instead.";
+    }
+  }
+
+  static void WritePrediction(std::vector<bst_float> const& preds, dmlc::ostream* os) {
+    for (bst_float p : preds) {
+      *os << std::setprecision(std::numeric_limits<bst_float>::max_digits10) << p << '\n';
+    }
+  }
+
   void LoadModel(std::string const& path, Learner* learner) const {
     if (common::FileExtension(path) == "json") {
       auto str = common::LoadSequentialFile(path);
@@ -356,17 +471,47 @@ class CLI {
     }
   }
 
-  void SaveModel(std::string const& path, Learner* learner) const {
+  /**
+   * \brief Serialize the model into a buffer in the format specified by the path.
+   */
+  std::string SnapshotModel(std::string const& path, Learner* learner) const {
     learner->Configure();
-    std::unique_ptr<dmlc::Stream> fo(dmlc::Stream::Create(path.c_str(), "w"));
+    std::string str;
     if (common::FileExtension(path) == "json") {
       Json out{Object()};
       learner->SaveModel(&out);
-      std::string str;
       Json::Dump(out, &str);
-      fo->Write(str.c_str(), str.size());
     } else {
-      learner->SaveModel(fo.get());
+      common::MemoryBufferStream fo(&str);
+      learner->SaveModel(&fo);
+    }
+    return str;
+  }
+
+  static void WriteModel(std::string const& path, std::string const& str) {
+    std::unique_ptr<dmlc::Stream> fo(dmlc::Stream::Create(path.c_str(), "w"));
+    fo->Write(str.c_str(), str.size());
+  }
+
+  void SaveModel(std::string const& path, Learner* learner) const {
+    WriteModel(path, this->SnapshotModel(path, learner));
+  }
+  /**
+   * \brief Take a snapshot of the model and write it from a background thread, so that
+   *        training can continue while the file is being written.
+   */
+  void SaveCheckpoint(std::string path) {
+    auto str = this->SnapshotModel(path, learner_.get());
+    // At most one pending write, errors from the previous one are raised here.
+    this->WaitCheckpoint();
+    checkpoint_ = std::async(std::launch::async, [path = std::move(path), str = std::move(str)] {
+      WriteModel(path, str);
+    });
+  }
+
+  void WaitCheckpoint() {
+    if (checkpoint_.valid()) {
+      checkpoint_.get();
     }
   }
 
@@ -498,7 +643,11 @@ class CLI {
         CLIDumpModel();
         break;
       case kPredict:
-        CLIPredict();
+        if (param_.pred_streaming) {
+          CLIPredictStreaming();
+        } else {
+          CLIPredict();
+        }
         break;
       }
     } catch (dmlc::Error const& e) {
@@ -2,9 +2,11 @@
  * Copyright 2022-2023 by XGBoost contributors
  */
 #pragma once
+#include <cstdint>
 #include <string>
 #include <vector>
 
+#include "../common/trace.h"
 #include "communicator.h"
 
 namespace xgboost {
@@ -127,6 +129,7 @@ inline std::string GetProcessorName() { return Communicator::Get()->GetProcessor
  * \param root The process rank to broadcast from.
  */
 inline void Broadcast(void *send_receive_buffer, size_t size, int root) {
+  common::TraceScope trace{"Broadcast", "collective", {{"bytes", static_cast<std::int64_t>(size)}}};
   Communicator::Get()->Broadcast(send_receive_buffer, size, root);
 }
 
@@ -151,6 +154,7 @@ inline void Broadcast(std::string *sendrecv_data, int root) {
  * @param size                Size of the data in bytes.
  */
 inline void Allgather(void *send_receive_buffer, std::size_t size) {
+  common::TraceScope trace{"Allgather", "collective", {{"bytes", static_cast<std::int64_t>(size)}}};
   Communicator::Get()->AllGather(send_receive_buffer, size);
 }
 
@@ -167,43 +171,45 @@ inline void Allgather(void *send_receive_buffer, std::size_t size) {
  * \param data_type Enumeration of data type, see xgboost::collective::DataType in communicator.h.
  * \param op Enumeration of operation type, see xgboost::collective::Operation in communicator.h.
  */
-inline void Allreduce(void *send_receive_buffer, size_t count, int data_type, int op) {
-  Communicator::Get()->AllReduce(send_receive_buffer, count, static_cast<DataType>(data_type),
-                                 static_cast<Operation>(op));
-}
-
 inline void Allreduce(void *send_receive_buffer, size_t count, DataType data_type, Operation op) {
+  auto bytes = static_cast<std::int64_t>(count * GetTypeSize(data_type));
+  common::TraceScope trace{"Allreduce", "collective", {{"bytes", bytes}}};
   Communicator::Get()->AllReduce(send_receive_buffer, count, data_type, op);
 }
 
+inline void Allreduce(void *send_receive_buffer, size_t count, int data_type, int op) {
+  Allreduce(send_receive_buffer, count, static_cast<DataType>(data_type),
+            static_cast<Operation>(op));
+}
+
 template <Operation op>
 inline void Allreduce(int8_t *send_receive_buffer, size_t count) {
-  Communicator::Get()->AllReduce(send_receive_buffer, count, DataType::kInt8, op);
+  Allreduce(send_receive_buffer, count, DataType::kInt8, op);
 }
 
 template <Operation op>
 inline void Allreduce(uint8_t *send_receive_buffer, size_t count) {
-  Communicator::Get()->AllReduce(send_receive_buffer, count, DataType::kUInt8, op);
+  Allreduce(send_receive_buffer, count, DataType::kUInt8, op);
 }
 
 template <Operation op>
 inline void Allreduce(int32_t *send_receive_buffer, size_t count) {
-  Communicator::Get()->AllReduce(send_receive_buffer, count, DataType::kInt32, op);
+  Allreduce(send_receive_buffer, count, DataType::kInt32, op);
 }
 
 template <Operation op>
 inline void Allreduce(uint32_t *send_receive_buffer, size_t count) {
-  Communicator::Get()->AllReduce(send_receive_buffer, count, DataType::kUInt32, op);
+  Allreduce(send_receive_buffer, count, DataType::kUInt32, op);
 }
 
 template <Operation op>
 inline void Allreduce(int64_t *send_receive_buffer, size_t count) {
-  Communicator::Get()->AllReduce(send_receive_buffer, count, DataType::kInt64, op);
+  Allreduce(send_receive_buffer, count, DataType::kInt64, op);
 }
 
 template <Operation op>
 inline void Allreduce(uint64_t *send_receive_buffer, size_t count) {
-  Communicator::Get()->AllReduce(send_receive_buffer, count, DataType::kUInt64, op);
+  Allreduce(send_receive_buffer, count, DataType::kUInt64, op);
 }
 
 // Specialization for size_t, which is implementation defined, so it might or might not
@@ -212,17 +218,17 @@ template <Operation op, typename T,
           typename = std::enable_if_t<std::is_same<size_t, T>{} && !std::is_same<uint64_t, T>{}> >
 inline void Allreduce(T *send_receive_buffer, size_t count) {
   static_assert(sizeof(T) == sizeof(uint64_t));
-  Communicator::Get()->AllReduce(send_receive_buffer, count, DataType::kUInt64, op);
+  Allreduce(send_receive_buffer, count, DataType::kUInt64, op);
 }
 
 template <Operation op>
 inline void Allreduce(float *send_receive_buffer, size_t count) {
-  Communicator::Get()->AllReduce(send_receive_buffer, count, DataType::kFloat, op);
+  Allreduce(send_receive_buffer, count, DataType::kFloat, op);
 }
 
 template <Operation op>
 inline void Allreduce(double *send_receive_buffer, size_t count) {
-  Communicator::Get()->AllReduce(send_receive_buffer, count, DataType::kDouble, op);
+  Allreduce(send_receive_buffer, count, DataType::kDouble, op);
 }
 
 template <typename T>
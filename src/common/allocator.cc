@@ -0,0 +1,63 @@
+/**
+ * Copyright 2023 by XGBoost Contributors
+ */
+#include "allocator.h"
+
+#if defined(__linux__)
+#include <sys/mman.h>  // for madvise, MADV_HUGEPAGE
+#endif                 // defined(__linux__)
+
+#include <cstdlib>  // for getenv, posix_memalign, free
+#include <new>      // for bad_alloc
+#include <string>   // for string
+
+namespace xgboost::common {
+bool HugePageEnabled() {
+  static bool const enabled = [] {
+    // Opt-in, transparent huge pages can increase the memory usage and cause latency
+    // spikes from compaction on some hosts.
+    auto const* env = std::getenv("XGBOOST_HUGE_PAGE");
+    return env != nullptr && std::string{env} == "1";
+  }();
+  return enabled;
+}
+
+namespace detail {
+namespace {
+// Only large allocations are aligned to huge pages, the decision must be the same for
+// allocation and deallocation.
+bool UseHugePage(std::size_t n_bytes) {
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+  return n_bytes >= kHugePageSize && HugePageEnabled();
+#else
+  (void)n_bytes;
+  return false;
+#endif  // defined(__linux__) && defined(MADV_HUGEPAGE)
+}
+}  // anonymous namespace
+
+void* AllocHugePage(std::size_t n_bytes) {
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+  if (UseHugePage(n_bytes)) {
+    auto n_aligned = (n_bytes + kHugePageSize - 1) / kHugePageSize * kHugePageSize;
+    void* ptr{nullptr};
+    if (posix_memalign(&ptr, kHugePageSize, n_aligned) != 0) {
+      throw std::bad_alloc{};
+    }
+    // Only an advice, failure is not an error.
+    madvise(ptr, n_aligned, MADV_HUGEPAGE);
+    return ptr;
+  }
+#endif  // defined(__linux__) && defined(MADV_HUGEPAGE)
+  return ::operator new(n_bytes);
+}
+
+void FreeHugePage(void* ptr, std::size_t n_bytes) noexcept {
+  if (UseHugePage(n_bytes)) {
+    std::free(ptr);
+  } else {
+    ::operator delete(ptr);
+  }
+}
+}  // namespace detail
+}  // namespace xgboost::common
@@ -0,0 +1,109 @@
+/**
+ * Copyright 2023 by XGBoost Contributors
+ * \file allocator.h
+ * \brief Host allocators for large buffers.
+ */
+#ifndef XGBOOST_COMMON_ALLOCATOR_H_
+#define XGBOOST_COMMON_ALLOCATOR_H_
+
+#include <cstddef>      // for size_t
+#include <limits>       // for numeric_limits
+#include <memory>       // for allocator, allocator_traits
+#include <new>          // for placement new, bad_array_new_length
+#include <type_traits>  // for is_nothrow_default_constructible
+#include <utility>      // for forward
+#include <vector>       // for vector
+
+namespace xgboost::common {
+namespace detail {
+// Size of a transparent huge page on x86-64 and the default on aarch64.
+constexpr std::size_t kHugePageSize = static_cast<std::size_t>(2) << 20;
+
+void* AllocHugePage(std::size_t n_bytes);
+void FreeHugePage(void* ptr, std::size_t n_bytes) noexcept;
+}  // namespace detail
+
+/**
+ * \brief Whether large allocations from `HugePageAllocator` are backed by transparent huge
+ *        pages.  Disabled by default, set the `XGBOOST_HUGE_PAGE` environment variable to 1
+ *        to enable it.
+ */
+bool HugePageEnabled();
+
+/**
+ * \brief Allocator for large and long-lived training buffers.
+ *
+ *   Allocations of at least 2MB are aligned to the huge page size and advised with
+ *   `MADV_HUGEPAGE` on Linux, so the kernel can back them with transparent huge pages.
+ *   This reduces TLB misses and the number of page faults when the buffer is first
+ *   touched.  Smaller allocations, and all allocations on other platforms, fall back to
+ *   `operator new`.
+ */
+template <typename T>
+class HugePageAllocator {
+ public:
+  using value_type = T;  // NOLINT
+
+  HugePageAllocator() = default;
+  template <typename U>
+  HugePageAllocator(HugePageAllocator<U> const&) noexcept {}  // NOLINT
+
+  T* allocate(std::size_t n) {  // NOLINT
+    if (n > std::numeric_limits<std::size_t>::max() / sizeof(T)) {
+      throw std::bad_array_new_length{};
+    }
+    return static_cast<T*>(detail::AllocHugePage(n * sizeof(T)));
+  }
+  void deallocate(T* ptr, std::size_t n) noexcept {  // NOLINT
+    detail::FreeHugePage(ptr, n * sizeof(T));
+  }
+
+  template <typename U>
+  bool operator==(HugePageAllocator<U> const&) const noexcept {
+    return true;
+  }
+  template <typename U>
+  bool operator!=(HugePageAllocator<U> const&) const noexcept {
+    return false;
+  }
+};
+
+/**
+ * \brief Allocator adaptor that default-initializes elements instead of value-initializing
+ *        them, so resizing a container of trivial types doesn't write to the memory.
+ *
+ *   Operating systems place a page on the NUMA node of the thread that first writes to
+ *   it.  A buffer resized with `std::allocator` is zeroed by the resizing thread and ends
+ *   up on a single node.  With this allocator the pages are first touched by the threads
+ *   filling the buffer in parallel, which keeps the data local to the threads using it
+ *   later with the same static schedule.
+ */
+template <typename T, typename A = std::allocator<T>>
+class DefaultInitAllocator : public A {
+  using Traits = std::allocator_traits<A>;
+
+ public:
+  template <typename U>
+  struct rebind {  // NOLINT
+    using other = DefaultInitAllocator<U, typename Traits::template rebind_alloc<U>>;  // NOLINT
+  };
+
+  using A::A;
+
+  template <typename U>
+  void construct(U* ptr) noexcept(std::is_nothrow_default_constructible<U>::value) {  // NOLINT
+    ::new (static_cast<void*>(ptr)) U;
+  }
+  template <typename U, typename... Args>
+  void construct(U* ptr, Args&&... args) {  // NOLINT
+    Traits::construct(static_cast<A&>(*this), ptr, std::forward<Args>(args)...);
+  }
+};
+
+/**
+ * \brief Storage for large buffers that are fully written after resize.
+ */
+template <typename T>
+using HugePageVector = std::vector<T, DefaultInitAllocator<T, HugePageAllocator<T>>>;
+}  // namespace xgboost::common
+#endif  // XGBOOST_COMMON_ALLOCATOR_H_
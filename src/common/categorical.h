@@ -5,6 +5,7 @@
 #ifndef XGBOOST_COMMON_CATEGORICAL_H_
 #define XGBOOST_COMMON_CATEGORICAL_H_
 
+#include <cstdint>  // for uint32_t
 #include <limits>
 
 #include "bitfield.h"
@@ -69,6 +70,54 @@ inline XGBOOST_DEVICE bool Decision(common::Span<uint32_t const> cats, float cat
   return !s_cats.Check(AsCat(cat));
 }
 
+/**
+ * \brief Same as `Decision`, but the matching categories are stored as a sorted list.
+ */
+inline XGBOOST_DEVICE bool SortedDecision(common::Span<bst_cat_t const> cats, float cat) {
+  if (XGBOOST_EXPECT(InvalidCat(cat), false)) {
+    return true;
+  }
+  auto c = AsCat(cat);
+  // The list is short, a linear scan is cheaper than a binary search.
+  for (auto v : cats) {
+    if (v >= c) {
+      return v != c;
+    }
+  }
+  return true;
+}
+
+// Seed for choosing the bucket of a category in the perfect hash table.
+constexpr std::uint32_t kCatBucketSeed = 0x9E3779B9u;
+
+XGBOOST_DEVICE inline std::uint32_t CatHash(std::uint32_t cat, std::uint32_t seed) {
+  std::uint32_t h = (cat ^ seed) * 0x85EBCA6Bu;
+  h ^= h >> 13;
+  h *= 0xC2B2AE35u;
+  h ^= h >> 16;
+  return h;
+}
+
+/**
+ * \brief Same as `Decision`, but the matching categories are stored in a perfect hash
+ *        table.
+ *
+ * \param seeds Seed of each bucket, chosen such that all categories in the bucket are
+ *              hashed into distinct slots.
+ * \param slots Categories in the table, empty slots are -1.  The size is a power of 2.
+ */
+inline XGBOOST_DEVICE bool HashDecision(common::Span<bst_cat_t const> seeds,
+                                        common::Span<bst_cat_t const> slots, float cat) {
+  if (XGBOOST_EXPECT(InvalidCat(cat), false)) {
+    return true;
+  }
+  auto c = AsCat(cat);
+  auto bucket = CatHash(static_cast<std::uint32_t>(c), kCatBucketSeed) % seeds.size();
+  auto slot = CatHash(static_cast<std::uint32_t>(c), static_cast<std::uint32_t>(seeds[bucket])) &
+              (slots.size() - 1);
+  return slots[slot] != c;
+}
+
 inline void InvalidCategory() {
   // OutOfRangeCat() can be accurately represented, but everything after it will be
   // rounded toward it, so we use >= for comparison check.  As a result, we require input
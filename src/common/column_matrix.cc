@@ -59,7 +59,7 @@ void ColumnMatrix::InitStorage(GHistIndexMatrix const& gmat, double sparse_thres
 
   any_missing_ = !gmat.IsDense();
 
-  missing_flags_.clear();
+  missing_flags_.Clear();
 }
 }  // namespace common
 }  // namespace xgboost
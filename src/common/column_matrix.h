@@ -11,6 +11,8 @@
 #include <dmlc/endian.h>
 
 #include <algorithm>
+#include <cstddef>  // for size_t
+#include <cstdint>  // for uint32_t
 #include <limits>
 #include <memory>
 #include <utility>  // std::move
@@ -19,6 +21,7 @@
 #include "../data/adapter.h"
 #include "../data/gradient_index.h"
 #include "algorithm.h"
+#include "bitfield.h"  // for LBitField32, CLBitField32
 #include "hist_util.h"
 
 namespace xgboost {
@@ -101,25 +104,54 @@ class SparseColumnIter : public Column<BinIdxT> {
   }
 };
 
-template <typename BinIdxT, bool any_missing>
-class DenseColumnIter : public Column<BinIdxT> {
+/**
+ * \brief Bit-packed flags for missing values in dense columns, a set bit means the value
+ *        is missing.
+ */
+class MissingIndicator {
+  using BitFieldT = LBitField32;
+  using T = BitFieldT::value_type;
+
+  std::vector<T> storage_;
+
  public:
-  using ByteType = bool;
+  /**
+   * \brief Allocate flags for `n_elements` values initialized to `init`, no-op if the
+   *        flags are already allocated.
+   */
+  void GrowTo(std::size_t n_elements, bool init) {
+    auto n_words = BitFieldT::ComputeStorageSize(n_elements);
+    if (n_words <= storage_.size()) {
+      return;
+    }
+    CHECK(storage_.empty());
+    storage_.resize(n_words, init ? ~T{0} : T{0});
+  }
+  // Not thread-safe, adjacent values share the same word.
+  void SetValid(std::size_t i) { BitFieldT{Span<T>{storage_}}.Clear(i); }
+  void Clear() { storage_.clear(); }
 
+  [[nodiscard]] CLBitField32 View() const { return CLBitField32{Span<T const>{storage_}}; }
+  [[nodiscard]] std::vector<T> const& Storage() const { return storage_; }
+  [[nodiscard]] std::vector<T>* Storage() { return &storage_; }
+};
+
+template <typename BinIdxT, bool any_missing>
+class DenseColumnIter : public Column<BinIdxT> {
  private:
   using Base = Column<BinIdxT>;
   /* flags for missing values in dense columns */
-  std::vector<ByteType> const& missing_flags_;
+  CLBitField32 missing_flags_;
   size_t feature_offset_;
 
  public:
   explicit DenseColumnIter(common::Span<const BinIdxT> index, bst_bin_t index_base,
-                           std::vector<ByteType> const& missing_flags, size_t feature_offset)
+                           CLBitField32 missing_flags, size_t feature_offset)
       : Base{index, index_base}, missing_flags_{missing_flags}, feature_offset_{feature_offset} {}
   DenseColumnIter(DenseColumnIter const&) = delete;
   DenseColumnIter(DenseColumnIter&&) = default;
 
-  bool IsMissing(size_t ridx) const { return missing_flags_[feature_offset_ + ridx]; }
+  bool IsMissing(size_t ridx) const { return missing_flags_.Check(feature_offset_ + ridx); }
 
   bst_bin_t operator[](size_t ridx) const {
     if (any_missing) {
@@ -144,9 +176,9 @@ class ColumnMatrix {
     if (type_[fid] == kDenseColumn) {
       ColumnBinT* begin = &local_index[feature_offsets_[fid]];
       begin[rid] = bin_id - index_base_[fid];
-      // not thread-safe with bool vector.  FIXME(jiamingy): We can directly assign
+      // not thread-safe with bit field.  FIXME(jiamingy): We can directly assign
       // kMissingId to the index to avoid missing flags.
-      missing_flags_[feature_offsets_[fid] + rid] = false;
+      missing_flags_.SetValid(feature_offsets_[fid] + rid);
     } else {
       ColumnBinT* begin = &local_index[feature_offsets_[fid]];
       begin[num_nonzeros_[fid]] = bin_id - index_base_[fid];
@@ -156,7 +188,6 @@ class ColumnMatrix {
   }
 
  public:
-  using ByteType = bool;
   // get number of features
   bst_feature_t GetNumFeature() const { return static_cast<bst_feature_t>(type_.size()); }
 
@@ -191,8 +222,13 @@ class ColumnMatrix {
       DispatchBinType(gmat.index.GetBinTypeSize(), [&, size = gmat.Size(), n_threads = n_threads,
                                                     n_features = gmat.Features()](auto t) {
         using RowBinIdxT = decltype(t);
-        SetIndexNoMissing(gmat.base_rowid, gmat.index.data<RowBinIdxT>(), size, n_features,
-                          n_threads);
+        if (gmat.index.IsPacked()) {
+          SetIndexNoMissing(gmat.base_rowid, gmat.index.Packed<RowBinIdxT>(), size, n_features,
+                            n_threads);
+        } else {
+          SetIndexNoMissing(gmat.base_rowid, gmat.index.data<RowBinIdxT>(), size, n_features,
+                            n_threads);
+        }
       });
     } else {
       SetIndexMixedColumns(gmat);
@@ -220,7 +256,13 @@ class ColumnMatrix {
       DispatchBinType(gmat.index.GetBinTypeSize(), [&, size = batch.Size(), n_threads = n_threads,
                                                     n_features = gmat.Features()](auto t) {
         using RowBinIdxT = decltype(t);
-        SetIndexNoMissing(base_rowid, gmat.index.data<RowBinIdxT>(), size, n_features, n_threads);
+        if (gmat.index.IsPacked()) {
+          SetIndexNoMissing(base_rowid, gmat.index.Packed<RowBinIdxT>(), size, n_features,
+                            n_threads);
+        } else {
+          SetIndexNoMissing(base_rowid, gmat.index.data<RowBinIdxT>(), size, n_features,
+                            n_threads);
+        }
       });
     } else {
       SetIndexMixedColumns(base_rowid, batch, gmat, missing);
@@ -257,27 +299,38 @@ class ColumnMatrix {
         reinterpret_cast<const BinIdxType*>(&index_[feature_offset * bins_type_size_]),
         column_size};
     return std::move(DenseColumnIter<BinIdxType, any_missing>{
-        bin_index, static_cast<bst_bin_t>(index_base_[fidx]), missing_flags_, feature_offset});
+        bin_index, static_cast<bst_bin_t>(index_base_[fidx]), missing_flags_.View(),
+        feature_offset});
   }
 
   // all columns are dense column and has no missing value
   // FIXME(jiamingy): We don't need a column matrix if there's no missing value.
+  // Local bin of a dense row index, either in the uniform layout or the packed layout.
+  template <typename RowBinIdxT>
+  static std::uint32_t RowBin(RowBinIdxT const* row_index, size_t rid, size_t fidx,
+                              size_t n_features) {
+    return row_index[rid * n_features + fidx];
+  }
   template <typename RowBinIdxT>
-  void SetIndexNoMissing(bst_row_t base_rowid, RowBinIdxT const* row_index, const size_t n_samples,
+  static std::uint32_t RowBin(PackedBins<RowBinIdxT> const& row_index, size_t rid, size_t fidx,
+                              size_t) {
+    return row_index.Get(rid, fidx);
+  }
+
+  template <typename RowIndex>
+  void SetIndexNoMissing(bst_row_t base_rowid, RowIndex const& row_index, const size_t n_samples,
                          const size_t n_features, int32_t n_threads) {
-    missing_flags_.resize(feature_offsets_[n_features], false);
+    missing_flags_.GrowTo(feature_offsets_[n_features], false);
     DispatchBinType(bins_type_size_, [&](auto t) {
       using ColumnBinT = decltype(t);
       auto column_index = Span<ColumnBinT>{reinterpret_cast<ColumnBinT*>(index_.data()),
                                            index_.size() / sizeof(ColumnBinT)};
       ParallelFor(n_samples, n_threads, [&](auto rid) {
         rid += base_rowid;
-        const size_t ibegin = rid * n_features;
-        const size_t iend = (rid + 1) * n_features;
-        for (size_t i = ibegin, j = 0; i < iend; ++i, ++j) {
+        for (size_t j = 0; j < n_features; ++j) {
           const size_t idx = feature_offsets_[j];
           // No need to add offset, as row index is compressed and stores the local index
-          column_index[idx + rid] = row_index[i];
+          column_index[idx + rid] = RowBin(row_index, rid, j, n_features);
         }
       });
     });
@@ -290,7 +343,7 @@ class ColumnMatrix {
   void SetIndexMixedColumns(size_t base_rowid, Batch const& batch, const GHistIndexMatrix& gmat,
                             float missing) {
     auto n_features = gmat.Features();
-    missing_flags_.resize(feature_offsets_[n_features], true);
+    missing_flags_.GrowTo(feature_offsets_[n_features], true);
     auto const* row_index = gmat.index.data<uint32_t>() + gmat.row_ptr[base_rowid];
     num_nonzeros_.resize(n_features, 0);
     auto is_valid = data::IsValidFunctor{missing};
@@ -321,7 +374,7 @@ class ColumnMatrix {
    */
   void SetIndexMixedColumns(const GHistIndexMatrix& gmat) {
     auto n_features = gmat.Features();
-    missing_flags_.resize(feature_offsets_[n_features], true);
+    missing_flags_.GrowTo(feature_offsets_[n_features], true);
     num_nonzeros_.resize(n_features, 0);
 
     DispatchBinType(bins_type_size_, [&](auto t) {
@@ -359,11 +412,7 @@ class ColumnMatrix {
     fi->Read(&row_ind_);
     fi->Read(&feature_offsets_);
 
-    std::vector<std::uint8_t> missing;
-    fi->Read(&missing);
-    missing_flags_.resize(missing.size());
-    std::transform(missing.cbegin(), missing.cend(), missing_flags_.begin(),
-                   [](std::uint8_t flag) { return !!flag; });
+    fi->Read(missing_flags_.Storage());
 
     index_base_ = index_base;
 #if !DMLC_LITTLE_ENDIAN
@@ -399,11 +448,7 @@ class ColumnMatrix {
 #endif  // !DMLC_LITTLE_ENDIAN
     write_vec(row_ind_);
     write_vec(feature_offsets_);
-    // dmlc can not handle bool vector
-    std::vector<std::uint8_t> missing(missing_flags_.size());
-    std::transform(missing_flags_.cbegin(), missing_flags_.cend(), missing.begin(),
-                   [](bool flag) { return static_cast<std::uint8_t>(flag); });
-    write_vec(missing);
+    write_vec(missing_flags_.Storage());
 
 #if !DMLC_LITTLE_ENDIAN
     auto v = static_cast<std::underlying_type<BinTypeSize>::type>(bins_type_size_);
@@ -430,10 +475,10 @@ class ColumnMatrix {
   std::vector<size_t> num_nonzeros_;
 
   // index_base_[fid]: least bin id for feature fid
-  uint32_t const* index_base_;
-  std::vector<ByteType> missing_flags_;
-  BinTypeSize bins_type_size_;
-  bool any_missing_;
+  uint32_t const* index_base_{nullptr};
+  MissingIndicator missing_flags_;
+  BinTypeSize bins_type_size_{kUint8BinsTypeSize};
+  bool any_missing_{false};
 };
 }  // namespace common
 }  // namespace xgboost
@@ -0,0 +1,83 @@
+/**
+ * Copyright 2023 by XGBoost Contributors
+ * \file hash.h
+ * \brief Non-cryptographic hash for checking whether two buffers have the same content.
+ */
+#ifndef XGBOOST_COMMON_HASH_H_
+#define XGBOOST_COMMON_HASH_H_
+
+#include <algorithm>  // for min
+#include <cstddef>    // for size_t
+#include <cstdint>    // for uint64_t, int32_t
+#include <cstring>    // for memcpy
+#include <vector>     // for vector
+
+#include "common.h"           // for DivRoundUp
+#include "threading_utils.h"  // for ParallelFor
+#include "xgboost/span.h"     // for Span
+
+namespace xgboost::common {
+/**
+ * \brief The finalizer of splitmix64.
+ */
+inline std::uint64_t HashMix(std::uint64_t v) {
+  v ^= v >> 30;
+  v *= 0xbf58476d1ce4e5b9ULL;
+  v ^= v >> 27;
+  v *= 0x94d049bb133111ebULL;
+  v ^= v >> 31;
+  return v;
+}
+
+inline std::uint64_t HashCombine(std::uint64_t seed, std::uint64_t v) {
+  return HashMix(seed ^ (HashMix(v) + 0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2)));
+}
+
+namespace detail {
+inline std::uint64_t HashBlock(std::uint8_t const* ptr, std::size_t n_bytes) {
+  std::uint64_t h = HashMix(n_bytes);
+  std::size_t i = 0;
+  for (; i + sizeof(std::uint64_t) <= n_bytes; i += sizeof(std::uint64_t)) {
+    std::uint64_t v;
+    std::memcpy(&v, ptr + i, sizeof(v));
+    h = HashMix(h ^ v) + i;
+  }
+  if (i != n_bytes) {
+    std::uint64_t v{0};
+    std::memcpy(&v, ptr + i, n_bytes - i);
+    h = HashMix(h ^ v);
+  }
+  return h;
+}
+}  // namespace detail
+
+/**
+ * \brief Hash the bytes of a buffer.
+ *
+ *   The buffer is divided into fixed size blocks that are hashed in parallel and combined
+ *   in order, so the result doesn't depend on the number of threads.  Not suitable for
+ *   comparing buffers across platforms with different endianness.
+ */
+template <typename T>
+std::uint64_t HashBytes(common::Span<T const> data, std::int32_t n_threads,
+                        std::uint64_t seed = 0) {
+  constexpr std::size_t kBlockSize = static_cast<std::size_t>(1) << 20;
+  auto const* ptr = reinterpret_cast<std::uint8_t const*>(data.data());
+  std::size_t n_bytes = data.size_bytes();
+  std::size_t n_blocks = DivRoundUp(n_bytes, kBlockSize);
+
+  std::vector<std::uint64_t> blocks(n_blocks);
+  ParallelFor(n_blocks, n_threads, [&](auto i) {
+    auto beg = i * kBlockSize;
+    auto size = std::min(kBlockSize, n_bytes - beg);
+    blocks[i] = detail::HashBlock(ptr + beg, size);
+  });
+
+  std::uint64_t h = HashCombine(seed, n_bytes);
+  for (auto v : blocks) {
+    h = HashCombine(h, v);
+  }
+  return h;
+}
+}  // namespace xgboost::common
+#endif  // XGBOOST_COMMON_HASH_H_
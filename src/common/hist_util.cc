@@ -6,6 +6,7 @@
 
 #include <dmlc/timer.h>
 
+#include <type_traits>  // for true_type, false_type
 #include <vector>
 
 #include "../common/common.h"
@@ -15,15 +16,6 @@
 #include "xgboost/context.h"  // Context
 #include "xgboost/data.h"     // SparsePage, SortedCSCPage
 
-#if defined(XGBOOST_MM_PREFETCH_PRESENT)
-  #include <xmmintrin.h>
-  #define PREFETCH_READ_T0(addr) _mm_prefetch(reinterpret_cast<const char*>(addr), _MM_HINT_T0)
-#elif defined(XGBOOST_BUILTIN_PREFETCH_PRESENT)
-  #define PREFETCH_READ_T0(addr) __builtin_prefetch(reinterpret_cast<const char*>(addr), 0, 3)
-#else  // no SW pre-fetching available; PREFETCH_READ_T0 is no-op
-  #define PREFETCH_READ_T0(addr) do {} while (0)
-#endif  // defined(XGBOOST_MM_PREFETCH_PRESENT)
-
 namespace xgboost {
 namespace common {
 
@@ -69,6 +61,37 @@ HistogramCuts SketchOnDMatrix(Context const *ctx, DMatrix *m, bst_bin_t max_bins
   return out;
 }
 
+bool Index::Pack(std::vector<uint32_t> const &cut_ptrs, bool force) {
+  this->Unpack();
+  CHECK_EQ(bin_offset_.size() + 1, cut_ptrs.size()) << "Only dense index can be packed.";
+  bst_feature_t constexpr kMaxNarrowBins = 16;
+  std::vector<bst_feature_t> narrow, wide;
+  for (bst_feature_t fidx = 0; fidx + 1 < cut_ptrs.size(); ++fidx) {
+    if (cut_ptrs[fidx + 1] - cut_ptrs[fidx] <= kMaxNarrowBins) {
+      narrow.push_back(fidx);
+    } else {
+      wide.push_back(fidx);
+    }
+  }
+  auto type_size = static_cast<std::size_t>(binTypeSize_);
+  auto narrow_bytes = DivRoundUp(DivRoundUp(narrow.size(), 2), type_size) * type_size;
+  if (!force && narrow_bytes >= narrow.size() * type_size) {
+    return false;
+  }
+
+  packed_slot_.resize(bin_offset_.size());
+  for (auto const &features : {narrow, wide}) {
+    for (auto fidx : features) {
+      packed_slot_[fidx] = static_cast<bst_feature_t>(packed_offset_.size());
+      packed_offset_.push_back(cut_ptrs[fidx]);
+    }
+  }
+  n_narrow_ = static_cast<bst_feature_t>(narrow.size());
+  narrow_bytes_ = narrow_bytes;
+  row_bytes_ = narrow_bytes + wide.size() * type_size;
+  return true;
+}
+
 /*!
  * \brief fill a histogram by zeros in range [begin, end)
  */
@@ -145,36 +168,48 @@ struct RuntimeFlags {
   const bool first_page;
   const bool read_by_column;
   const BinTypeSize bin_type_size;
+  const bool packed;
 };
 
 template <bool _any_missing,
           bool _first_page = false,
           bool _read_by_column = false,
-          typename BinIdxTypeName = uint8_t>
+          typename BinIdxTypeName = uint8_t,
+          bool _packed = false>
 class GHistBuildingManager {
  public:
   constexpr static bool kAnyMissing = _any_missing;
   constexpr static bool kFirstPage = _first_page;
   constexpr static bool kReadByColumn = _read_by_column;
+  constexpr static bool kPacked = _packed;
   using BinIdxType = BinIdxTypeName;
 
  private:
   template <bool new_first_page>
   struct SetFirstPage {
-    using Type = GHistBuildingManager<kAnyMissing, new_first_page, kReadByColumn, BinIdxType>;
+    using Type =
+        GHistBuildingManager<kAnyMissing, new_first_page, kReadByColumn, BinIdxType, kPacked>;
   };
 
   template <bool new_read_by_column>
   struct SetReadByColumn {
-    using Type = GHistBuildingManager<kAnyMissing, kFirstPage, new_read_by_column, BinIdxType>;
+    using Type =
+        GHistBuildingManager<kAnyMissing, kFirstPage, new_read_by_column, BinIdxType, kPacked>;
   };
 
   template <typename NewBinIdxType>
   struct SetBinIdxType {
-    using Type = GHistBuildingManager<kAnyMissing, kFirstPage, kReadByColumn, NewBinIdxType>;
+    using Type =
+        GHistBuildingManager<kAnyMissing, kFirstPage, kReadByColumn, NewBinIdxType, kPacked>;
   };
 
-  using Type = GHistBuildingManager<kAnyMissing, kFirstPage, kReadByColumn, BinIdxType>;
+  template <bool new_packed>
+  struct SetPacked {
+    using Type =
+        GHistBuildingManager<kAnyMissing, kFirstPage, kReadByColumn, BinIdxType, new_packed>;
+  };
+
+  using Type = GHistBuildingManager<kAnyMissing, kFirstPage, kReadByColumn, BinIdxType, kPacked>;
 
  public:
   /* Entry point to dispatcher
@@ -193,6 +228,12 @@ class GHistBuildingManager {
         using NewBinIdxType = decltype(t);
         SetBinIdxType<NewBinIdxType>::Type::DispatchAndExecute(flags, std::forward<Fn>(fn));
       });
+    } else if (flags.packed != kPacked) {
+      if constexpr (!kAnyMissing) {
+        SetPacked<true>::Type::DispatchAndExecute(flags, std::forward<Fn>(fn));
+      } else {
+        LOG(FATAL) << "Only dense index can be packed.";
+      }
     } else {
       fn(Type());
     }
@@ -321,11 +362,126 @@ void ColsWiseBuildHistKernel(Span<GradientPair const> gpair,
   }
 }
 
+/**
+ * \brief Row-wise kernel for the 4-bit packed index, two bins are read from each byte of
+ *        the narrow features.
+ */
+template <bool do_prefetch, class BuildingManager>
+void PackedRowsWiseBuildHistKernel(Span<GradientPair const> gpair,
+                                   const RowSetCollection::Elem row_indices,
+                                   const GHistIndexMatrix &gmat, GHistRow hist) {
+  constexpr bool kFirstPage = BuildingManager::kFirstPage;
+  using BinIdxType = typename BuildingManager::BinIdxType;
+
+  const size_t size = row_indices.Size();
+  const size_t *rid = row_indices.begin;
+  auto const *pgh = reinterpret_cast<const float *>(gpair.data());
+  auto packed = gmat.index.Packed<BinIdxType>();
+  const uint32_t *offsets = gmat.index.PackedOffset();
+  auto base_rowid = gmat.base_rowid;
+  auto get_rid = [&](size_t ridx) {
+    return kFirstPage ? ridx : (ridx - base_rowid);
+  };
+
+  const size_t n_narrow = packed.n_narrow;
+  const size_t n_wide = gmat.index.OffsetSize() - n_narrow;
+  const uint32_t *wide_offsets = offsets + n_narrow;
+  auto hist_data = reinterpret_cast<double *>(hist.data());
+  const uint32_t two{2};  // Each element from 'gpair' and 'hist' contains
+                          // 2 FP values: gradient and hessian.
+
+  for (size_t i = 0; i < size; ++i) {
+    const size_t idx_gh = two * rid[i];
+    if (do_prefetch) {
+      auto const *row_prefetch = packed.Row(get_rid(rid[i + Prefetch::kPrefetchOffset]));
+      PREFETCH_READ_T0(pgh + two * rid[i + Prefetch::kPrefetchOffset]);
+      for (size_t j = 0; j < packed.row_bytes; j += Prefetch::kCacheLineSize) {
+        PREFETCH_READ_T0(row_prefetch + j);
+      }
+    }
+    auto const *row = packed.Row(get_rid(rid[i]));
+
+    // The trick with pgh_t buffer helps the compiler to generate faster binary.
+    const float pgh_t[] = {pgh[idx_gh], pgh[idx_gh + 1]};
+    auto add = [&](uint32_t bin) {
+      auto hist_local = hist_data + two * bin;
+      *(hist_local)     += pgh_t[0];
+      *(hist_local + 1) += pgh_t[1];
+    };
+    size_t k = 0;
+    for (; k + 1 < n_narrow; k += 2) {
+      const uint32_t byte = row[k / 2];
+      add((byte & 0xF) + offsets[k]);
+      add((byte >> 4) + offsets[k + 1]);
+    }
+    if (k < n_narrow) {
+      add(PackedBins<BinIdxType>::Narrow(row, k) + offsets[k]);
+    }
+    const BinIdxType *wide = packed.Wide(row);
+    for (size_t j = 0; j < n_wide; ++j) {
+      add(static_cast<uint32_t>(wide[j]) + wide_offsets[j]);
+    }
+  }
+}
+
+template <class BuildingManager>
+void PackedColsWiseBuildHistKernel(Span<GradientPair const> gpair,
+                                   const RowSetCollection::Elem row_indices,
+                                   const GHistIndexMatrix &gmat, GHistRow hist) {
+  constexpr bool kFirstPage = BuildingManager::kFirstPage;
+  using BinIdxType = typename BuildingManager::BinIdxType;
+
+  const size_t size = row_indices.Size();
+  const size_t *rid = row_indices.begin;
+  auto const *pgh = reinterpret_cast<const float *>(gpair.data());
+  auto packed = gmat.index.Packed<BinIdxType>();
+  const uint32_t *offsets = gmat.index.PackedOffset();
+  auto base_rowid = gmat.base_rowid;
+  auto get_rid = [&](size_t ridx) {
+    return kFirstPage ? ridx : (ridx - base_rowid);
+  };
+
+  const size_t n_narrow = packed.n_narrow;
+  const size_t n_columns = gmat.index.OffsetSize();
+  auto hist_data = reinterpret_cast<double *>(hist.data());
+  const uint32_t two{2};
+  // Columns are visited in the order of the packed layout.
+  for (size_t k = 0; k < n_columns; ++k) {
+    const uint32_t offset = offsets[k];
+    for (size_t i = 0; i < size; ++i) {
+      const size_t row_id = rid[i];
+      auto const *row = packed.Row(get_rid(row_id));
+      const uint32_t bin = k < n_narrow ? PackedBins<BinIdxType>::Narrow(row, k)
+                                        : static_cast<uint32_t>(packed.Wide(row)[k - n_narrow]);
+      auto hist_local = hist_data + two * (bin + offset);
+
+      const size_t idx_gh = two * row_id;
+      const float pgh_t[] = {pgh[idx_gh], pgh[idx_gh + 1]};
+      *(hist_local)     += pgh_t[0];
+      *(hist_local + 1) += pgh_t[1];
+    }
+  }
+}
+
 template <class BuildingManager>
 void BuildHistDispatch(Span<GradientPair const> gpair, const RowSetCollection::Elem row_indices,
                        const GHistIndexMatrix &gmat, GHistRow hist) {
+  auto row_kernel = [&](auto do_prefetch, RowSetCollection::Elem rows) {
+    if constexpr (BuildingManager::kPacked) {
+      PackedRowsWiseBuildHistKernel<decltype(do_prefetch)::value, BuildingManager>(gpair, rows,
+                                                                                   gmat, hist);
+    } else {
+      RowsWiseBuildHistKernel<decltype(do_prefetch)::value, BuildingManager>(gpair, rows, gmat,
+                                                                             hist);
+    }
+  };
+
   if (BuildingManager::kReadByColumn) {
-    ColsWiseBuildHistKernel<BuildingManager>(gpair, row_indices, gmat, hist);
+    if constexpr (BuildingManager::kPacked) {
+      PackedColsWiseBuildHistKernel<BuildingManager>(gpair, row_indices, gmat, hist);
+    } else {
+      ColsWiseBuildHistKernel<BuildingManager>(gpair, row_indices, gmat, hist);
+    }
   } else {
     const size_t nrows = row_indices.Size();
     const size_t no_prefetch_size = Prefetch::NoPrefetchSize(nrows);
@@ -335,16 +491,16 @@ void BuildHistDispatch(Span<GradientPair const> gpair, const RowSetCollection::E
 
     if (contiguousBlock) {
       // contiguous memory access, built-in HW prefetching is enough
-      RowsWiseBuildHistKernel<false, BuildingManager>(gpair, row_indices, gmat, hist);
+      row_kernel(std::false_type{}, row_indices);
     } else {
       const RowSetCollection::Elem span1(row_indices.begin,
                                         row_indices.end - no_prefetch_size);
       const RowSetCollection::Elem span2(row_indices.end - no_prefetch_size,
                                         row_indices.end);
 
-      RowsWiseBuildHistKernel<true, BuildingManager>(gpair, span1, gmat, hist);
+      row_kernel(std::true_type{}, span1);
       // no prefetching to avoid loading extra memory
-      RowsWiseBuildHistKernel<false, BuildingManager>(gpair, span2, gmat, hist);
+      row_kernel(std::false_type{}, span2);
     }
   }
 }
@@ -361,14 +517,124 @@ void GHistBuilder::BuildHist(Span<GradientPair const> gpair,
   bool first_page = gmat.base_rowid == 0;
   bool read_by_column = !hist_fit_to_l2 && !any_missing;
   auto bin_type_size = gmat.index.GetBinTypeSize();
+  bool packed = gmat.index.IsPacked();
 
   GHistBuildingManager<any_missing>::DispatchAndExecute(
-      {first_page, read_by_column || force_read_by_column, bin_type_size}, [&](auto t) {
+      {first_page, read_by_column || force_read_by_column, bin_type_size, packed}, [&](auto t) {
         using BuildingManager = decltype(t);
         BuildHistDispatch<BuildingManager>(gpair, row_indices, gmat, hist);
       });
 }
 
+namespace {
+/**
+ * \brief Row-wise kernel for multiple targets.
+ *
+ * \param visit    Callback that calls `add` for each global bin of a row.
+ * \param row_addr Address of the bins of a row, used for prefetching.
+ */
+template <typename Visit, typename RowAddr>
+void MultiTargetBuildHistKernel(Span<GradientPair const> gpair, bst_target_t n_targets,
+                                const RowSetCollection::Elem row_indices,
+                                const GHistIndexMatrix &gmat, GHistRow hist, Visit &&visit,
+                                RowAddr &&row_addr) {
+  const size_t size = row_indices.Size();
+  const size_t *rid = row_indices.begin;
+  auto const *pgh = reinterpret_cast<const float *>(gpair.data());
+  auto hist_data = reinterpret_cast<double *>(hist.data());
+  auto base_rowid = gmat.base_rowid;
+  // Number of FP values for each row of the gradient and each bin of the histogram.
+  const size_t n_values = 2 * static_cast<size_t>(n_targets);
+
+  for (size_t i = 0; i < size; ++i) {
+    if (i + Prefetch::kPrefetchOffset < size) {
+      auto const ridx_prefetch = rid[i + Prefetch::kPrefetchOffset];
+      auto const *gh_prefetch = pgh + n_values * ridx_prefetch;
+      for (size_t k = 0; k < n_values; k += Prefetch::GetPrefetchStep<float>()) {
+        PREFETCH_READ_T0(gh_prefetch + k);
+      }
+      PREFETCH_READ_T0(row_addr(ridx_prefetch - base_rowid));
+    }
+    auto const *row_gh = pgh + n_values * rid[i];
+    visit(rid[i] - base_rowid, [&](uint32_t bin) {
+      auto *hist_local = hist_data + n_values * bin;
+      // Targets are the innermost dimension.
+      for (size_t k = 0; k < n_values; ++k) {
+        hist_local[k] += row_gh[k];
+      }
+    });
+  }
+}
+}  // anonymous namespace
+
+template <bool any_missing>
+void GHistBuilder::BuildHist(Span<GradientPair const> gpair, bst_target_t n_targets,
+                             const RowSetCollection::Elem row_indices, const GHistIndexMatrix &gmat,
+                             GHistRow hist) const {
+  CHECK_GE(n_targets, 1);
+  CHECK_EQ(hist.size(), static_cast<size_t>(gmat.cut.TotalBins()) * n_targets);
+  if (row_indices.Size() == 0) {
+    return;
+  }
+  auto kernel = [&](auto &&visit, auto &&row_addr) {
+    MultiTargetBuildHistKernel(gpair, n_targets, row_indices, gmat, hist, visit, row_addr);
+  };
+
+  if (any_missing) {
+    auto const *index = gmat.index.data<uint32_t>();
+    auto const *row_ptr = gmat.row_ptr.data();
+    kernel(
+        [&](size_t ridx, auto &&add) {
+          for (auto j = row_ptr[ridx]; j < row_ptr[ridx + 1]; ++j) {
+            add(index[j]);
+          }
+        },
+        [&](size_t ridx) { return index + row_ptr[ridx]; });
+    return;
+  }
+
+  auto const n_features = gmat.index.OffsetSize();
+  DispatchBinType(gmat.index.GetBinTypeSize(), [&](auto t) {
+    using BinT = decltype(t);
+    if (gmat.index.IsPacked()) {
+      auto packed = gmat.index.Packed<BinT>();
+      auto const *offsets = gmat.index.PackedOffset();
+      size_t const n_narrow = packed.n_narrow;
+      kernel(
+          [&](size_t ridx, auto &&add) {
+            auto const *row = packed.Row(ridx);
+            for (size_t k = 0; k < n_narrow; ++k) {
+              add(PackedBins<BinT>::Narrow(row, k) + offsets[k]);
+            }
+            auto const *wide = packed.Wide(row);
+            for (size_t k = n_narrow; k < n_features; ++k) {
+              add(static_cast<uint32_t>(wide[k - n_narrow]) + offsets[k]);
+            }
+          },
+          [&](size_t ridx) { return packed.Row(ridx); });
+    } else {
+      auto const *index = gmat.index.data<BinT>();
+      auto const *offsets = gmat.index.Offset();
+      kernel(
+          [&](size_t ridx, auto &&add) {
+            auto const *row = index + ridx * n_features;
+            for (size_t k = 0; k < n_features; ++k) {
+              add(static_cast<uint32_t>(row[k]) + offsets[k]);
+            }
+          },
+          [&](size_t ridx) { return index + ridx * n_features; });
+    }
+  });
+}
+
+template void GHistBuilder::BuildHist<true>(Span<GradientPair const> gpair, bst_target_t n_targets,
+                                            const RowSetCollection::Elem row_indices,
+                                            const GHistIndexMatrix &gmat, GHistRow hist) const;
+
+template void GHistBuilder::BuildHist<false>(Span<GradientPair const> gpair, bst_target_t n_targets,
+                                             const RowSetCollection::Elem row_indices,
+                                             const GHistIndexMatrix &gmat, GHistRow hist) const;
+
 template void GHistBuilder::BuildHist<true>(Span<GradientPair const> gpair,
                                             const RowSetCollection::Elem row_indices,
                                             const GHistIndexMatrix &gmat, GHistRow hist,
@@ -8,13 +8,15 @@
 #define XGBOOST_COMMON_HIST_UTIL_H_
 
 #include <algorithm>
-#include <cstdint>  // for uint32_t
+#include <cstddef>  // for size_t
+#include <cstdint>  // for uint32_t, uint8_t
 #include <limits>
 #include <map>
 #include <memory>
 #include <utility>
 #include <vector>
 
+#include "allocator.h"  // for HugePageVector, HugePageAllocator
 #include "categorical.h"
 #include "common.h"
 #include "quantile.h"
@@ -24,6 +26,15 @@
 #include "xgboost/base.h"  // for bst_feature_t, bst_bin_t
 #include "xgboost/data.h"
 
+#if defined(XGBOOST_MM_PREFETCH_PRESENT)
+  #include <xmmintrin.h>
+  #define PREFETCH_READ_T0(addr) _mm_prefetch(reinterpret_cast<const char*>(addr), _MM_HINT_T0)
+#elif defined(XGBOOST_BUILTIN_PREFETCH_PRESENT)
+  #define PREFETCH_READ_T0(addr) __builtin_prefetch(reinterpret_cast<const char*>(addr), 0, 3)
+#else  // no SW pre-fetching available; PREFETCH_READ_T0 is no-op
+  #define PREFETCH_READ_T0(addr) do {} while (0)
+#endif  // defined(XGBOOST_MM_PREFETCH_PRESENT)
+
 namespace xgboost {
 class GHistIndexMatrix;
 
@@ -199,6 +210,39 @@ auto DispatchBinType(BinTypeSize type, Fn&& fn) {
   return fn(uint32_t{});
 }
 
+/**
+ * \brief Accessor for the 4-bit packed layout of a dense gradient index, see
+ *        `Index::Pack`.  The returned bins don't include the feature offset.
+ */
+template <typename BinT>
+struct PackedBins {
+  std::uint8_t const* data;
+  // Number of bytes in each row.
+  std::size_t row_bytes;
+  // Number of bytes used by the 4-bit bins at the beginning of each row.
+  std::size_t narrow_bytes;
+  bst_feature_t n_narrow;
+  // Position of each feature inside a row, the first `n_narrow` positions are 4-bit bins.
+  bst_feature_t const* slot;
+
+  [[nodiscard]] std::uint8_t const* Row(std::size_t ridx) const {
+    return data + ridx * row_bytes;
+  }
+  // Bin at position k of the narrow features.
+  [[nodiscard]] static std::uint32_t Narrow(std::uint8_t const* row, std::size_t k) {
+    return (row[k / 2] >> ((k % 2) * 4)) & 0xF;
+  }
+  // Bins of the wide features.
+  [[nodiscard]] BinT const* Wide(std::uint8_t const* row) const {
+    return reinterpret_cast<BinT const*>(row + narrow_bytes);
+  }
+  [[nodiscard]] std::uint32_t Get(std::size_t ridx, bst_feature_t fidx) const {
+    auto const* row = this->Row(ridx);
+    auto k = slot[fidx];
+    return k < n_narrow ? Narrow(row, k) : this->Wide(row)[k - n_narrow];
+  }
+};
+
 /**
  * \brief Optionally compressed gradient index. The compression works only with dense
  *        data.
@@ -235,7 +279,14 @@ struct Index {
   Index(Index&& i) = delete;
   Index& operator=(Index&& i) = delete;
   uint32_t operator[](size_t i) const {
-    if (!bin_offset_.empty()) {
+    if (this->IsPacked()) {
+      auto fidx = i % bin_offset_.size();
+      auto const* row = data_.data() + (i / bin_offset_.size()) * row_bytes_;
+      auto k = packed_slot_[fidx];
+      auto bin = k < n_narrow_ ? PackedBins<uint8_t>::Narrow(row, k)
+                               : func_(row + narrow_bytes_, k - n_narrow_);
+      return bin + bin_offset_[fidx];
+    } else if (!bin_offset_.empty()) {
       // dense, compressed
       auto fidx = i % bin_offset_.size();
       // restore the index by adding back its feature offset.
@@ -274,8 +325,52 @@ struct Index {
   }
   uint32_t const* Offset() const { return bin_offset_.data(); }
   size_t OffsetSize() const { return bin_offset_.size(); }
-  size_t Size() const { return data_.size() / (binTypeSize_); }
+  // Number of bins in the index.
+  size_t Size() const {
+    if (this->IsPacked()) {
+      return data_.size() / row_bytes_ * bin_offset_.size();
+    }
+    return data_.size() / (binTypeSize_);
+  }
+  size_t SizeBytes() const { return data_.size(); }
 
+  /**
+   * \brief Use the 4-bit packed layout for a dense index, must be called after the bin
+   *        type and the bin offset are set.
+   *
+   *   Each row starts with the bins of features having at most 16 bins, two bins in a
+   *   byte and padded to the bin type size.  The bins of the remaining features follow,
+   *   stored with the bin type.
+   *
+   * \param force Use the packed layout even if it doesn't save memory.
+   *
+   * \return Whether the packed layout is used.
+   */
+  bool Pack(std::vector<uint32_t> const& cut_ptrs, bool force = false);
+  // Go back to the uniform layout, the data is not converted.
+  void Unpack() {
+    packed_slot_.clear();
+    packed_offset_.clear();
+    n_narrow_ = 0;
+    narrow_bytes_ = 0;
+    row_bytes_ = 0;
+  }
+  [[nodiscard]] bool IsPacked() const { return !packed_slot_.empty(); }
+  // Number of bytes needed for n_bins bins with the packed layout.
+  [[nodiscard]] size_t PackedBytes(size_t n_bins) const {
+    return n_bins / bin_offset_.size() * row_bytes_;
+  }
+  template <typename T>
+  [[nodiscard]] PackedBins<T> Packed() const {
+    return {data_.data(), row_bytes_, narrow_bytes_, n_narrow_, packed_slot_.data()};
+  }
+  // Bin offsets of the features in the order of the packed layout.
+  [[nodiscard]] uint32_t const* PackedOffset() const { return packed_offset_.data(); }
+  [[nodiscard]] bst_feature_t NumNarrow() const { return n_narrow_; }
+
+  /**
+   * \brief Resize the index without initializing the new elements.
+   */
   void Resize(const size_t n_bytes) {
     data_.resize(n_bytes);
   }
@@ -284,17 +379,17 @@ struct Index {
     bin_offset_.resize(cut_ptrs.size() - 1);  // resize to number of features.
     std::copy_n(cut_ptrs.begin(), bin_offset_.size(), bin_offset_.begin());
   }
-  std::vector<uint8_t>::const_iterator begin() const {  // NOLINT
-    return data_.begin();
+  auto begin() const {  // NOLINT
+    return data_.cbegin();
   }
-  std::vector<uint8_t>::const_iterator end() const {  // NOLINT
-    return data_.end();
+  auto end() const {  // NOLINT
+    return data_.cend();
   }
 
-  std::vector<uint8_t>::iterator begin() {  // NOLINT
+  auto begin() {  // NOLINT
     return data_.begin();
   }
-  std::vector<uint8_t>::iterator end() {  // NOLINT
+  auto end() {  // NOLINT
     return data_.end();
   }
 
@@ -310,10 +405,18 @@ struct Index {
 
   using Func = uint32_t (*)(uint8_t const*, size_t);
 
-  std::vector<uint8_t> data_;
+  // Not zero-initialized on resize, the data is first written by the threads building the
+  // index so that the pages are placed on their NUMA nodes.
+  HugePageVector<uint8_t> data_;
   // starting position of each feature inside the cut values (the indptr of the CSC cut matrix
   // HistogramCuts without the last entry.) Used for bin compression.
   std::vector<uint32_t> bin_offset_;
+  // The 4-bit packed layout, empty if the index is not packed.
+  std::vector<bst_feature_t> packed_slot_;
+  std::vector<uint32_t> packed_offset_;
+  bst_feature_t n_narrow_{0};
+  size_t narrow_bytes_{0};
+  size_t row_bytes_{0};
 
   BinTypeSize binTypeSize_ {kUint8BinsTypeSize};
   Func func_;
@@ -373,8 +476,15 @@ void SubtractionHist(GHistRow dst, const GHistRow src1, const GHistRow src2, siz
 
 /*!
  * \brief histogram of gradient statistics for multiple nodes
+ *
+ *   Histograms are allocated from an arena that is kept across trees, `Init` only resets
+ *   the node assignment.  Without contiguous allocation, histograms are grouped into
+ *   chunks of at least the huge page size to reduce the number of allocations and TLB
+ *   misses.
  */
 class HistCollection {
+  using Storage = std::vector<GradientPairPrecise, HugePageAllocator<GradientPairPrecise>>;
+
  public:
   // access histogram for i-th node
   GHistRow operator[](bst_uint nid) const {
@@ -383,9 +493,10 @@ class HistCollection {
     CHECK_NE(id, kMax);
     GradientPairPrecise* ptr = nullptr;
     if (contiguous_allocation_) {
-      ptr = const_cast<GradientPairPrecise*>(data_[0].data() + nbins_*id);
+      ptr = const_cast<GradientPairPrecise*>(contiguous_.data() + nbins_ * id);
     } else {
-      ptr = const_cast<GradientPairPrecise*>(data_[id].data());
+      auto const& chunk = chunks_[id / nodes_per_chunk_];
+      ptr = const_cast<GradientPairPrecise*>(chunk.data() + nbins_ * (id % nodes_per_chunk_));
     }
     return {ptr, nbins_};
   }
@@ -403,8 +514,13 @@ class HistCollection {
   void Init(std::uint32_t n_total_bins) {
     if (nbins_ != n_total_bins) {
       nbins_ = n_total_bins;
+      nodes_per_chunk_ = std::max(
+          detail::kHugePageSize / (sizeof(GradientPairPrecise) * std::max(nbins_, 1u)),
+          static_cast<std::size_t>(1));
       // quite expensive operation, so let's do this only once
-      data_.clear();
+      chunks_.clear();
+      contiguous_.clear();
+      n_nodes_ = 0;
     }
     row_ptr_.clear();
     n_nodes_added_ = 0;
@@ -418,25 +534,27 @@ class HistCollection {
     }
     CHECK_EQ(row_ptr_[nid], kMax);
 
-    if (data_.size() < (nid + 1)) {
-      data_.resize((nid + 1));
-    }
+    n_nodes_ = std::max(n_nodes_, static_cast<std::size_t>(nid) + 1);
 
     row_ptr_[nid] = n_nodes_added_;
     n_nodes_added_++;
   }
   // allocate thread local memory i-th node
   void AllocateData(bst_uint nid) {
-    if (data_[row_ptr_[nid]].size() == 0) {
-      data_[row_ptr_[nid]].resize(nbins_, {0, 0});
+    auto chunk_idx = row_ptr_[nid] / nodes_per_chunk_;
+    if (chunks_.size() <= chunk_idx) {
+      chunks_.resize(chunk_idx + 1);
+    }
+    if (chunks_[chunk_idx].empty()) {
+      chunks_[chunk_idx].resize(nbins_ * nodes_per_chunk_, {0, 0});
     }
   }
   // allocate common buffer contiguously for all nodes, need for single Allreduce call
   void AllocateAllData() {
-    const size_t new_size = nbins_*data_.size();
+    const size_t new_size = nbins_ * n_nodes_;
     contiguous_allocation_ = true;
-    if (data_[0].size() != new_size) {
-      data_[0].resize(new_size);
+    if (contiguous_.size() < new_size) {
+      contiguous_.resize(new_size);
     }
   }
 
@@ -447,8 +565,13 @@ class HistCollection {
   uint32_t n_nodes_added_ = 0;
   /*! \brief flag to identify contiguous memory allocation */
   bool contiguous_allocation_ = false;
+  /*! \brief upper bound of node ids seen since the number of bins changed */
+  std::size_t n_nodes_{0};
+  /*! \brief number of histograms in each chunk */
+  std::size_t nodes_per_chunk_{1};
 
-  std::vector<std::vector<GradientPairPrecise>> data_;
+  std::vector<Storage> chunks_;
+  Storage contiguous_;
 
   /*! \brief row_ptr_[nid] locates bin for histogram of node nid */
   std::vector<size_t> row_ptr_;
@@ -641,6 +764,18 @@ class GHistBuilder {
   void BuildHist(Span<GradientPair const> gpair, const RowSetCollection::Elem row_indices,
                  const GHistIndexMatrix& gmat, GHistRow hist,
                  bool force_read_by_column = false) const;
+  /**
+   * \brief Build the histogram for multiple targets at once.
+   *
+   *   The bins of each row are read only once and the gradient of all targets is
+   *   accumulated into each bin, the layout of the histogram is [bin][target].
+   *
+   * \param gpair Row-major gradient matrix with the shape of [n_samples, n_targets].
+   */
+  template <bool any_missing>
+  void BuildHist(Span<GradientPair const> gpair, bst_target_t n_targets,
+                 const RowSetCollection::Elem row_indices, const GHistIndexMatrix& gmat,
+                 GHistRow hist) const;
   uint32_t GetNumBins() const {
       return nbins_;
   }
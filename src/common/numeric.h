@@ -115,7 +115,7 @@ V Reduce(Context const* ctx, It first, It second, V const& init) {
   std::size_t n = std::distance(first, second);
   auto n_threads = static_cast<std::size_t>(std::min(n, static_cast<std::size_t>(ctx->Threads())));
   common::MemStackAllocator<V, common::DefaultMaxThreads()> result_tloc(n_threads, init);
-  common::ParallelFor(n, n_threads, [&](auto i) { result_tloc[omp_get_thread_num()] += first[i]; });
+  common::ParallelFor(n, n_threads, [&](auto i) { result_tloc[ThreadIdx()] += first[i]; });
   auto result = std::accumulate(result_tloc.cbegin(), result_tloc.cbegin() + n_threads, init);
   return result;
 }
@@ -31,6 +31,8 @@ namespace xgboost::common {
 template<size_t BlockSize>
 class PartitionBuilder {
   using BitVector = RBitField8;
+  // Number of rows to look ahead when reading from the row-major gradient index.
+  static constexpr size_t kPrefetchOffset = 10;
 
  public:
   template<typename Func>
@@ -108,6 +110,88 @@ class PartitionBuilder {
     return {nleft_elems, nright_elems};
   }
 
+  /**
+   * \brief Partition the rows by reading the split bin straight from the row-major
+   *        gradient index, used when the column matrix is not built.
+   */
+  template <bool default_left, typename Predicate>
+  std::pair<size_t, size_t> PartitionRowMajorKernel(GHistIndexMatrix const& gmat,
+                                                    bst_feature_t fidx,
+                                                    common::Span<const size_t> row_indices,
+                                                    common::Span<size_t> left_part,
+                                                    common::Span<size_t> right_part,
+                                                    Predicate&& pred) {
+    size_t* p_left_part = left_part.data();
+    size_t* p_right_part = right_part.data();
+    size_t nleft_elems = 0;
+    size_t nright_elems = 0;
+
+    auto p_row_indices = row_indices.data();
+    auto n_samples = row_indices.size();
+    auto base_rowid = gmat.base_rowid;
+
+    auto partition = [&](auto get_bin, auto prefetch) {
+      for (size_t i = 0; i < n_samples; ++i) {
+        if (i + kPrefetchOffset < n_samples) {
+          prefetch(p_row_indices[i + kPrefetchOffset] - base_rowid);
+        }
+        auto rid = p_row_indices[i];
+        bst_bin_t const bin_id = get_bin(rid - base_rowid);
+        bool go_left = default_left;
+        if (bin_id != Column<std::uint32_t>::kMissingId) {
+          go_left = pred(bin_id);
+        }
+        if (go_left) {
+          p_left_part[nleft_elems++] = rid;
+        } else {
+          p_right_part[nright_elems++] = rid;
+        }
+      }
+    };
+
+    if (gmat.IsDense() && gmat.index.IsPacked()) {
+      auto bin_offset = static_cast<bst_bin_t>(gmat.index.Offset()[fidx]);
+      DispatchBinType(gmat.index.GetBinTypeSize(), [&](auto t) {
+        using BinT = decltype(t);
+        auto packed = gmat.index.Packed<BinT>();
+        auto k = packed.slot[fidx];
+        auto n_narrow = packed.n_narrow;
+        partition(
+            [&](size_t ridx) {
+              auto const* row = packed.Row(ridx);
+              auto bin = k < n_narrow ? PackedBins<BinT>::Narrow(row, k)
+                                      : static_cast<std::uint32_t>(packed.Wide(row)[k - n_narrow]);
+              return static_cast<bst_bin_t>(bin) + bin_offset;
+            },
+            [&](size_t ridx) { PREFETCH_READ_T0(packed.Row(ridx)); });
+      });
+    } else if (gmat.IsDense()) {
+      // Dense index is compressed, each row stores the local bin of every feature.
+      auto n_features = static_cast<size_t>(gmat.Features());
+      auto bin_offset = static_cast<bst_bin_t>(gmat.index.Offset()[fidx]);
+      DispatchBinType(gmat.index.GetBinTypeSize(), [&](auto t) {
+        using BinT = decltype(t);
+        BinT const* index = gmat.index.data<BinT>() + fidx;
+        partition(
+            [&](size_t ridx) {
+              return static_cast<bst_bin_t>(index[ridx * n_features]) + bin_offset;
+            },
+            [&](size_t ridx) { PREFETCH_READ_T0(index + ridx * n_features); });
+      });
+    } else {
+      auto const* row_ptr = gmat.row_ptr.data();
+      auto const* index = gmat.index.data<std::uint32_t>();
+      auto f_begin = gmat.cut.Ptrs()[fidx];
+      auto f_end = gmat.cut.Ptrs()[fidx + 1];
+      partition(
+          [&](size_t ridx) {
+            return BinarySearchBin(row_ptr[ridx], row_ptr[ridx + 1], index, f_begin, f_end);
+          },
+          [&](size_t ridx) { PREFETCH_READ_T0(index + row_ptr[ridx]); });
+    }
+    return {nleft_elems, nright_elems};
+  }
+
   template <typename BinIdxType, bool any_missing, bool any_cat, typename ExpandEntry>
   void Partition(const size_t node_in_set, std::vector<ExpandEntry> const& nodes,
                  const common::Range1d range, const bst_bin_t split_cond,
@@ -136,22 +220,23 @@ class PartitionBuilder {
       }
     };
 
-    auto pred_approx = [&](auto ridx) {
-      auto gidx = gmat.GetGindex(ridx, fid);
-      bool go_left = default_left;
-      if (gidx > -1) {
-        if (is_cat) {
-          go_left = Decision(node_cats, cut_values[gidx]);
-        } else {
-          go_left = cut_values[gidx] <= nodes[node_in_set].split.split_value;
-        }
+    auto pred_row = [&](bst_bin_t bin_id) {
+      if (any_cat && is_cat) {
+        return Decision(node_cats, cut_values[bin_id]);
+      } else {
+        return bin_id <= split_cond;
       }
-      return go_left;
     };
 
     std::pair<size_t, size_t> child_nodes_sizes;
     if (!column_matrix.IsInitialized()) {
-      child_nodes_sizes = PartitionRangeKernel(rid_span, left, right, pred_approx);
+      if (default_left) {
+        child_nodes_sizes =
+            PartitionRowMajorKernel<true>(gmat, fid, rid_span, left, right, pred_row);
+      } else {
+        child_nodes_sizes =
+            PartitionRowMajorKernel<false>(gmat, fid, rid_span, left, right, pred_row);
+      }
     } else {
       if (column_matrix.GetColumnType(fid) == xgboost::common::kDenseColumn) {
         auto column = column_matrix.DenseColumn<BinIdxType, any_missing>(fid);
@@ -33,8 +33,7 @@ SketchContainerImpl<WQSketch>::SketchContainerImpl(Context const *ctx,
   has_categorical_ = std::any_of(feature_types_.cbegin(), feature_types_.cend(), IsCatOp{});
 }
 
-namespace {
-// Function to merge hessian and sample weights
+namespace detail {
 std::vector<float> MergeWeights(MetaInfo const &info, Span<float const> hessian, bool use_group,
                                 int32_t n_threads) {
   CHECK_EQ(hessian.size(), info.num_row_);
@@ -58,7 +57,7 @@ std::vector<float> MergeWeights(MetaInfo const &info, Span<float const> hessian,
   }
   return results;
 }
-}  // anonymous namespace
+}  // namespace detail
 
 template <typename WQSketch>
 void SketchContainerImpl<WQSketch>::PushRowPage(SparsePage const &page, MetaInfo const &info,
@@ -73,8 +72,8 @@ void SketchContainerImpl<WQSketch>::PushRowPage(SparsePage const &page, MetaInfo
   auto const &weights =
       hessian.empty() ? (use_group_ind_ ? detail::UnrollGroupWeights(info)  // use group weight
                                         : info.weights_.HostVector())       // use sample weight
-                      : MergeWeights(info, hessian, use_group_ind_,
-                                     n_threads_);  // use hessian merged with group/sample weights
+                      : detail::MergeWeights(info, hessian, use_group_ind_,
+                                             n_threads_);  // use hessian merged with weights
   if (!weights.empty()) {
     CHECK_EQ(weights.size(), info.num_row_);
   }
@@ -465,8 +464,8 @@ void SortedSketchContainer::PushColPage(SparsePage const &page, MetaInfo const &
   auto const &weights =
       hessian.empty() ? (use_group_ind_ ? detail::UnrollGroupWeights(info)  // use group weight
                                         : info.weights_.HostVector())       // use sample weight
-                      : MergeWeights(info, hessian, use_group_ind_,
-                                     n_threads_);  // use hessian merged with group/sample weights
+                      : detail::MergeWeights(info, hessian, use_group_ind_,
+                                             n_threads_);  // use hessian merged with weights
   CHECK_EQ(weights.size(), info.num_row_);
 
   auto view = page.GetView();
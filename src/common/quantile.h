@@ -689,6 +689,12 @@ class WXQuantileSketch :
 };
 
 namespace detail {
+/**
+ * \brief Merge the hessian with sample weights or group weights.
+ */
+std::vector<float> MergeWeights(MetaInfo const &info, Span<float const> hessian, bool use_group,
+                                int32_t n_threads);
+
 inline std::vector<float> UnrollGroupWeights(MetaInfo const &info) {
   std::vector<float> const &group_weights = info.weights_.HostVector();
   if (group_weights.empty()) {
@@ -727,7 +733,7 @@ std::vector<bst_row_t> CalcColumnSize(Batch const &batch, bst_feature_t const n_
   }
 
   ParallelFor(batch.Size(), n_threads, [&](omp_ulong i) {
-    auto &local_column_sizes = column_sizes_tloc.at(omp_get_thread_num());
+    auto &local_column_sizes = column_sizes_tloc.at(ThreadIdx());
     auto const &line = batch.GetLine(i);
     for (size_t j = 0; j < line.Size(); ++j) {
       auto elem = line.GetElement(j);
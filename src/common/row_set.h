@@ -13,6 +13,8 @@
 #include <utility>
 #include <memory>
 
+#include "allocator.h"  // for HugePageVector
+
 namespace xgboost {
 namespace common {
 /*! \brief collection of rowset */
@@ -82,13 +84,15 @@ class RowSetCollection {
       return;
     }
 
-    const size_t* begin = dmlc::BeginPtr(row_indices_);
-    const size_t* end = dmlc::BeginPtr(row_indices_) + row_indices_.size();
+    const size_t* begin = row_indices_.data();
+    const size_t* end = row_indices_.data() + row_indices_.size();
     elem_of_each_node_.emplace_back(begin, end, 0);
   }
 
-  std::vector<size_t>* Data() { return &row_indices_; }
-  std::vector<size_t> const* Data() const { return &row_indices_; }
+  using Storage = HugePageVector<size_t>;
+
+  Storage* Data() { return &row_indices_; }
+  Storage const* Data() const { return &row_indices_; }
 
   // split rowset into two
   inline void AddSplit(unsigned node_id, unsigned left_node_id, unsigned right_node_id,
@@ -101,7 +105,7 @@ class RowSetCollection {
       CHECK_EQ(n_left, 0);
       CHECK_EQ(n_right, 0);
     } else {
-      all_begin = dmlc::BeginPtr(row_indices_);
+      all_begin = row_indices_.data();
       begin = all_begin + (e.begin - all_begin);
     }
 
@@ -122,8 +126,8 @@ class RowSetCollection {
   }
 
  private:
-  // stores the row indexes in the set
-  std::vector<size_t> row_indices_;
+  // stores the row indexes in the set, not initialized on resize as the caller fills it.
+  Storage row_indices_;
   // vector: node_id -> elements
   std::vector<Elem> elem_of_each_node_;
 };
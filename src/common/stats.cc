@@ -55,7 +55,7 @@ void Mean(Context const* ctx, linalg::Vector<float> const& v, linalg::Vector<flo
     float n = v.Size();
     MemStackAllocator<float, DefaultMaxThreads()> tloc(ctx->Threads(), 0.0f);
     ParallelFor(v.Size(), ctx->Threads(),
-                [&](auto i) { tloc[omp_get_thread_num()] += h_v(i) / n; });
+                [&](auto i) { tloc[ThreadIdx()] += h_v(i) / n; });
     auto ret = std::accumulate(tloc.cbegin(), tloc.cend(), .0f);
     out->HostView()(0) = ret;
   } else {
@@ -11,6 +11,7 @@
 #include "algorithm.h"           // for StableSort
 #include "common.h"              // AssertGPUSupport, OptionalWeights
 #include "optional_weight.h"     // OptionalWeights
+#include "threading_utils.h"     // InParallelRegion
 #include "transform_iterator.h"  // MakeIndexTransformIter
 #include "xgboost/context.h"     // Context
 #include "xgboost/linalg.h"      // TensorView,VectorView
@@ -40,7 +41,7 @@ float Quantile(Context const* ctx, double alpha, Iter const& begin, Iter const&
 
   std::vector<std::size_t> sorted_idx(n);
   std::iota(sorted_idx.begin(), sorted_idx.end(), 0);
-  if (omp_in_parallel()) {
+  if (InParallelRegion()) {
     std::stable_sort(sorted_idx.begin(), sorted_idx.end(),
                      [&](std::size_t l, std::size_t r) { return *(begin + l) < *(begin + r); });
   } else {
@@ -83,7 +84,7 @@ float WeightedQuantile(Context const* ctx, double alpha, Iter begin, Iter end, W
   }
   std::vector<size_t> sorted_idx(n);
   std::iota(sorted_idx.begin(), sorted_idx.end(), 0);
-  if (omp_in_parallel()) {
+  if (InParallelRegion()) {
     std::stable_sort(sorted_idx.begin(), sorted_idx.end(),
                      [&](std::size_t l, std::size_t r) { return *(begin + l) < *(begin + r); });
   } else {
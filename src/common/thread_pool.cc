@@ -0,0 +1,455 @@
+/**
+ * Copyright 2023 by XGBoost Contributors
+ */
+#include "thread_pool.h"
+
+#if !defined(_WIN32)
+#include <pthread.h>  // for pthread_atfork, pthread_setaffinity_np, pthread_self
+#endif                // !defined(_WIN32)
+#if defined(__linux__)
+#include <sched.h>  // for sched_getaffinity, cpu_set_t, CPU_SET, CPU_ZERO, CPU_ISSET
+#endif              // defined(__linux__)
+
+#include <algorithm>  // for min, max
+#include <atomic>     // for atomic
+#include <cstdlib>    // for getenv
+#include <exception>  // for exception_ptr, current_exception, rethrow_exception
+#include <fstream>    // for ifstream
+#include <memory>     // for unique_ptr
+#include <sstream>    // for stringstream
+#include <string>     // for string, stoi, to_string
+#include <tuple>      // for tie
+#include <utility>    // for pair
+
+#include "dmlc/omp.h"         // for omp_get_thread_num, omp_in_parallel
+#include "xgboost/logging.h"  // for CHECK, LOG
+
+namespace xgboost::common {
+namespace {
+// Slot index of the calling thread in the running pool job, -1 outside of any job.
+thread_local std::int32_t pool_thread_idx{-1};
+
+class ThreadIdxGuard {
+  std::int32_t prev_;
+
+ public:
+  explicit ThreadIdxGuard(std::int32_t idx) : prev_{pool_thread_idx} { pool_thread_idx = idx; }
+  ~ThreadIdxGuard() { pool_thread_idx = prev_; }
+};
+
+ParallelBackend DefaultBackend() {
+  auto const* env = std::getenv("XGBOOST_PARALLEL_BACKEND");
+  if (env != nullptr) {
+    std::string value{env};
+    if (value == "pool") {
+      return ParallelBackend::kThreadPool;
+    }
+    if (value == "omp" || value == "openmp") {
+      return ParallelBackend::kOpenMP;
+    }
+    LOG(WARNING) << "Unknown value for XGBOOST_PARALLEL_BACKEND: `" << value
+                 << "`, expecting `omp` or `pool`.";
+  }
+#if defined(XGBOOST_USE_THREAD_POOL)
+  return ParallelBackend::kThreadPool;
+#else
+  return ParallelBackend::kOpenMP;
+#endif  // defined(XGBOOST_USE_THREAD_POOL)
+}
+
+// Owner of the global pool, guarded by `GlobalPoolLock`.
+std::unique_ptr<ThreadPool>& GlobalPool() {
+  static std::unique_ptr<ThreadPool> pool;
+  return pool;
+}
+
+std::mutex& GlobalPoolLock() {
+  static std::mutex lock;
+  return lock;
+}
+
+bool PinFromEnv() {
+  auto const* env = std::getenv("XGBOOST_THREAD_POOL_PIN");
+  return env != nullptr && std::string{env} == "1";
+}
+
+std::atomic<std::int32_t>& Backend() {
+  static std::atomic<std::int32_t> backend{static_cast<std::int32_t>(DefaultBackend())};
+  return backend;
+}
+
+// Contiguous block of tasks for a slot, same as the OpenMP static schedule.
+std::pair<std::size_t, std::size_t> StaticBlock(std::size_t n_tasks, std::int32_t n_slots,
+                                                std::int32_t slot) {
+  auto block = n_tasks / n_slots + !!(n_tasks % n_slots);
+  auto begin = std::min(block * slot, n_tasks);
+  auto end = std::min(begin + block, n_tasks);
+  return {begin, end};
+}
+
+// Parse the CPU list format used by sysfs, for example `0-3,8-11`.
+std::vector<std::int32_t> ParseCPUList(std::string const& list) {
+  std::vector<std::int32_t> cpus;
+  std::stringstream ss{list};
+  std::string range;
+  while (std::getline(ss, range, ',')) {
+    if (range.empty()) {
+      continue;
+    }
+    auto dash = range.find('-');
+    try {
+      if (dash == std::string::npos) {
+        cpus.push_back(std::stoi(range));
+      } else {
+        auto first = std::stoi(range.substr(0, dash));
+        auto last = std::stoi(range.substr(dash + 1));
+        for (auto c = first; c <= last; ++c) {
+          cpus.push_back(c);
+        }
+      }
+    } catch (std::exception const&) {
+      return {};
+    }
+  }
+  return cpus;
+}
+}  // namespace
+
+ParallelBackend GetParallelBackend() {
+  return static_cast<ParallelBackend>(Backend().load(std::memory_order_relaxed));
+}
+
+void SetParallelBackend(ParallelBackend backend) {
+  Backend().store(static_cast<std::int32_t>(backend), std::memory_order_relaxed);
+}
+
+std::int32_t ThreadIdx() {
+  return pool_thread_idx >= 0 ? pool_thread_idx : omp_get_thread_num();
+}
+
+bool InParallelRegion() { return pool_thread_idx >= 0 || omp_in_parallel(); }
+
+namespace detail {
+void PoolParallelFor(std::size_t n_tasks, std::int32_t n_threads, bool steal, std::size_t grain,
+                     PoolKernel kernel, void* fn) {
+  ThreadPool::Global()->Run(n_tasks, n_threads, steal, grain, kernel, fn);
+}
+}  // namespace detail
+
+CPUTopology CPUTopology::Detect() {
+  CPUTopology topo;
+#if defined(__linux__)
+  cpu_set_t mask;
+  CPU_ZERO(&mask);
+  bool has_mask = sched_getaffinity(0, sizeof(mask), &mask) == 0;
+  auto allowed = [&](std::int32_t cpu) {
+    return !has_mask || (cpu < CPU_SETSIZE && CPU_ISSET(cpu, &mask));
+  };
+
+  auto read_list = [](std::string const& path) {
+    std::ifstream fin{path};
+    std::string list;
+    if (!fin || !(fin >> list)) {
+      return std::vector<std::int32_t>{};
+    }
+    return ParseCPUList(list);
+  };
+  for (auto node : read_list("/sys/devices/system/node/online")) {
+    auto path = "/sys/devices/system/node/node" + std::to_string(node) + "/cpulist";
+    for (auto cpu : read_list(path)) {
+      if (allowed(cpu)) {
+        topo.cpus.push_back(cpu);
+        topo.nodes.push_back(node);
+      }
+    }
+  }
+  if (topo.cpus.empty()) {
+    auto n_cpus = static_cast<std::int32_t>(std::thread::hardware_concurrency());
+    for (std::int32_t cpu = 0; cpu < n_cpus; ++cpu) {
+      if (allowed(cpu)) {
+        topo.cpus.push_back(cpu);
+        topo.nodes.push_back(0);
+      }
+    }
+  }
+#endif  // defined(__linux__)
+  if (topo.cpus.empty()) {
+    auto n_cpus = std::max(static_cast<std::int32_t>(std::thread::hardware_concurrency()), 1);
+    for (std::int32_t cpu = 0; cpu < n_cpus; ++cpu) {
+      topo.cpus.push_back(cpu);
+      topo.nodes.push_back(0);
+    }
+  }
+  return topo;
+}
+
+struct ThreadPool::Job {
+  struct Slot {
+    std::mutex lock;
+    // Remaining tasks owned by this slot.
+    std::size_t begin{0};
+    std::size_t end{0};
+    // NUMA node of the thread holding this slot, -1 if unknown.
+    std::atomic<std::int32_t> node{-1};
+  };
+
+  detail::PoolKernel kernel;
+  void* fn;
+  bool steal;
+  std::size_t grain;
+  std::vector<Slot> slots;
+  std::int32_t n_slots;
+  // Number of workers that still need to pick up this job, guarded by the pool lock.
+  std::int32_t n_helpers;
+
+  std::atomic<std::int32_t> next_slot{0};
+  std::atomic<std::size_t> n_remaining;
+  std::mutex done_lock;
+  std::condition_variable done_cv;
+
+  std::mutex exc_lock;
+  std::exception_ptr exc;
+
+  Job(std::size_t n_tasks, std::int32_t n_slots, bool steal, std::size_t grain,
+      detail::PoolKernel kernel, void* fn)
+      : kernel{kernel},
+        fn{fn},
+        steal{steal},
+        grain{grain},
+        slots(n_slots),
+        n_slots{n_slots},
+        n_helpers{n_slots - 1},
+        n_remaining{n_tasks} {
+    if (this->grain == 0) {
+      this->grain = std::max(n_tasks / (static_cast<std::size_t>(n_slots) * 16), std::size_t{1});
+    }
+    for (std::int32_t s = 0; s < n_slots; ++s) {
+      std::tie(slots[s].begin, slots[s].end) = StaticBlock(n_tasks, n_slots, s);
+    }
+  }
+
+  bool Pop(std::int32_t s, std::size_t* begin, std::size_t* end) {
+    auto& slot = slots[s];
+    std::lock_guard<std::mutex> guard{slot.lock};
+    if (slot.begin == slot.end) {
+      return false;
+    }
+    *begin = slot.begin;
+    *end = steal ? std::min(slot.begin + grain, slot.end) : slot.end;
+    slot.begin = *end;
+    return true;
+  }
+
+  // Steal half of the remaining tasks from another slot into slot `s`.
+  bool Steal(std::int32_t s, std::int32_t node) {
+    for (auto same_node : {true, false}) {
+      if (same_node && node < 0) {
+        continue;
+      }
+      for (std::int32_t k = 1; k < n_slots; ++k) {
+        auto& victim = slots[(s + k) % n_slots];
+        if (same_node && victim.node.load(std::memory_order_relaxed) != node) {
+          continue;
+        }
+        std::size_t begin, end;
+        {
+          std::lock_guard<std::mutex> guard{victim.lock};
+          if (victim.begin == victim.end) {
+            continue;
+          }
+          begin = victim.begin + (victim.end - victim.begin) / 2;
+          end = victim.end;
+          victim.end = begin;
+        }
+        auto& slot = slots[s];
+        std::lock_guard<std::mutex> guard{slot.lock};
+        slot.begin = begin;
+        slot.end = end;
+        return true;
+      }
+    }
+    return false;
+  }
+
+  void Execute(std::size_t begin, std::size_t end) {
+    try {
+      kernel(fn, begin, end);
+    } catch (...) {
+      std::lock_guard<std::mutex> guard{exc_lock};
+      if (!exc) {
+        exc = std::current_exception();
+      }
+    }
+    auto n = end - begin;
+    if (n_remaining.fetch_sub(n, std::memory_order_acq_rel) == n) {
+      { std::lock_guard<std::mutex> guard{done_lock}; }
+      done_cv.notify_all();
+    }
+  }
+
+  void Participate(std::int32_t node) {
+    for (;;) {
+      auto s = next_slot.fetch_add(1, std::memory_order_relaxed);
+      if (s >= n_slots) {
+        return;
+      }
+      ThreadIdxGuard idx_guard{s};
+      slots[s].node.store(node, std::memory_order_relaxed);
+      std::size_t begin, end;
+      do {
+        while (this->Pop(s, &begin, &end)) {
+          this->Execute(begin, end);
+        }
+      } while (steal && this->Steal(s, node));
+    }
+  }
+
+  void Wait() {
+    std::unique_lock<std::mutex> lk{done_lock};
+    done_cv.wait(lk, [this] { return n_remaining.load(std::memory_order_acquire) == 0; });
+  }
+};
+
+ThreadPool::ThreadPool(bool pin) : topo_{CPUTopology::Detect()}, pin_{pin} {}
+
+ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard<std::mutex> guard{lock_};
+    stop_ = true;
+  }
+  cv_.notify_all();
+  for (auto& t : workers_) {
+    t.join();
+  }
+}
+
+ThreadPool* ThreadPool::Global() {
+#if !defined(_WIN32)
+  static int registered =
+      pthread_atfork(&ThreadPool::PrepareFork, &ThreadPool::ParentAfterFork,
+                     &ThreadPool::ChildAfterFork);
+  (void)registered;
+#endif  // !defined(_WIN32)
+  std::lock_guard<std::mutex> guard{GlobalPoolLock()};
+  auto& pool = GlobalPool();
+  if (!pool) {
+    pool = std::make_unique<ThreadPool>(PinFromEnv());
+  }
+  return pool.get();
+}
+
+void ThreadPool::PrepareFork() {
+  // Hold the locks so that the child doesn't inherit them in the middle of an update.
+  GlobalPoolLock().lock();
+  if (auto& pool = GlobalPool()) {
+    pool->lock_.lock();
+  }
+}
+
+void ThreadPool::ParentAfterFork() {
+  if (auto& pool = GlobalPool()) {
+    pool->lock_.unlock();
+  }
+  GlobalPoolLock().unlock();
+}
+
+void ThreadPool::ChildAfterFork() {
+  // The workers don't exist in the child, joining them would block forever.  The old pool
+  // is leaked on purpose.
+  (void)GlobalPool().release();
+  GlobalPoolLock().unlock();
+}
+
+std::int32_t ThreadPool::NumWorkers() {
+  std::lock_guard<std::mutex> guard{lock_};
+  return static_cast<std::int32_t>(workers_.size());
+}
+
+void ThreadPool::EnsureWorkers(std::int32_t n_workers) {
+  while (static_cast<std::int32_t>(workers_.size()) < n_workers) {
+    auto worker_idx = static_cast<std::int32_t>(workers_.size());
+    workers_.emplace_back([this, worker_idx] { this->WorkerLoop(worker_idx); });
+  }
+}
+
+std::int32_t ThreadPool::WorkerNode(std::int32_t worker_idx) const {
+  // The first CPU is left for the application thread.
+  return topo_.nodes[(worker_idx + 1) % topo_.nodes.size()];
+}
+
+void ThreadPool::PinCurrentThread(std::int32_t worker_idx) const {
+#if defined(__linux__)
+  auto cpu = topo_.cpus[(worker_idx + 1) % topo_.cpus.size()];
+  cpu_set_t mask;
+  CPU_ZERO(&mask);
+  CPU_SET(cpu, &mask);
+  if (pthread_setaffinity_np(pthread_self(), sizeof(mask), &mask) != 0) {
+    LOG(WARNING) << "Failed to pin thread pool worker to CPU " << cpu;
+  }
+#else
+  (void)worker_idx;
+#endif  // defined(__linux__)
+}
+
+void ThreadPool::WorkerLoop(std::int32_t worker_idx) {
+  std::int32_t node{-1};
+  if (pin_) {
+    this->PinCurrentThread(worker_idx);
+    node = this->WorkerNode(worker_idx);
+  }
+  for (;;) {
+    std::shared_ptr<Job> job;
+    {
+      std::unique_lock<std::mutex> lk{lock_};
+      cv_.wait(lk, [this] { return stop_ || !queue_.empty(); });
+      if (stop_) {
+        return;
+      }
+      job = queue_.front();
+      if (--job->n_helpers <= 0) {
+        queue_.pop_front();
+      }
+    }
+    job->Participate(node);
+  }
+}
+
+void ThreadPool::Run(std::size_t n_tasks, std::int32_t n_threads, bool steal, std::size_t grain,
+                     detail::PoolKernel kernel, void* fn) {
+  if (n_tasks == 0) {
+    return;
+  }
+  CHECK_GE(n_threads, 1);
+  auto n_slots = static_cast<std::int32_t>(
+      std::min(static_cast<std::size_t>(n_threads), n_tasks));
+
+  if (n_slots == 1 || pool_thread_idx >= 0) {
+    // Serial execution for single thread and nested loops.  Tasks are still assigned to
+    // slots as in a parallel run so that the thread index matches the static schedule.
+    for (std::int32_t s = 0; s < n_slots; ++s) {
+      ThreadIdxGuard idx_guard{s};
+      auto [begin, end] = StaticBlock(n_tasks, n_slots, s);
+      if (begin != end) {
+        kernel(fn, begin, end);
+      }
+    }
+    return;
+  }
+
+  auto job = std::make_shared<Job>(n_tasks, n_slots, steal, grain, kernel, fn);
+  {
+    std::lock_guard<std::mutex> guard{lock_};
+    this->EnsureWorkers(n_slots - 1);
+    queue_.push_back(job);
+  }
+  for (std::int32_t i = 0; i < n_slots - 1; ++i) {
+    cv_.notify_one();
+  }
+
+  job->Participate(-1);
+  job->Wait();
+  if (job->exc) {
+    std::rethrow_exception(job->exc);
+  }
+}
+}  // namespace xgboost::common
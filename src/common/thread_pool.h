@@ -0,0 +1,103 @@
+/**
+ * Copyright 2023 by XGBoost Contributors
+ *
+ * \brief A persistent work-stealing thread pool used as an alternative backend of
+ *        `ParallelFor` and `ParallelFor2d`.
+ */
+#ifndef XGBOOST_COMMON_THREAD_POOL_H_
+#define XGBOOST_COMMON_THREAD_POOL_H_
+
+#include <condition_variable>  // for condition_variable
+#include <cstddef>             // for size_t
+#include <cstdint>             // for int32_t
+#include <deque>               // for deque
+#include <memory>              // for shared_ptr
+#include <mutex>               // for mutex
+#include <thread>              // for thread
+#include <vector>              // for vector
+
+#include "threading_utils.h"  // for detail::PoolKernel
+
+namespace xgboost::common {
+/**
+ * \brief CPUs available to the process, grouped by NUMA node.
+ */
+struct CPUTopology {
+  // CPU ids sorted by node.
+  std::vector<std::int32_t> cpus;
+  // NUMA node of each entry in `cpus`.
+  std::vector<std::int32_t> nodes;
+
+  /**
+   * \brief Read the topology from sysfs on Linux, a single node with all hardware threads
+   *        on other platforms.
+   */
+  static CPUTopology Detect();
+};
+
+/**
+ * \brief Thread pool with persistent workers.
+ *
+ *   Each parallel loop is a job divided into slots, one slot per participating thread
+ *   including the caller.  A slot owns a contiguous range of tasks, the thread holding a
+ *   slot takes tasks from the front of the range while idle threads steal half of the
+ *   remaining range from the back, preferring slots held by threads on the same NUMA
+ *   node.  The slot index is the thread index returned by `ThreadIdx`, so per-thread
+ *   buffers indexed by it are never shared by two running threads.
+ *
+ *   Loops launched from inside a job run serially on the calling thread, which prevents
+ *   oversubscription from nested parallelism.  Jobs from different application threads
+ *   share the same workers.
+ */
+class ThreadPool {
+ public:
+  struct Job;
+
+ private:
+  std::vector<std::thread> workers_;
+  std::deque<std::shared_ptr<Job>> queue_;
+  std::mutex lock_;
+  std::condition_variable cv_;
+  bool stop_{false};
+
+  CPUTopology topo_;
+  bool pin_{false};
+
+  // Handlers registered with `pthread_atfork`.  The child process has no worker threads,
+  // the inherited pool is abandoned and a new one is created on demand.
+  static void PrepareFork();
+  static void ParentAfterFork();
+  static void ChildAfterFork();
+
+  void EnsureWorkers(std::int32_t n_workers);
+  void WorkerLoop(std::int32_t worker_idx);
+  void PinCurrentThread(std::int32_t worker_idx) const;
+  [[nodiscard]] std::int32_t WorkerNode(std::int32_t worker_idx) const;
+
+ public:
+  /**
+   * \param pin Pin each worker to a CPU, workers are assigned to CPUs in NUMA node order.
+   */
+  explicit ThreadPool(bool pin);
+  ~ThreadPool();
+
+  ThreadPool(ThreadPool const&) = delete;
+  ThreadPool& operator=(ThreadPool const&) = delete;
+
+  /**
+   * \brief The process-wide pool.  Pinning is enabled by setting the
+   *        `XGBOOST_THREAD_POOL_PIN` environment variable to 1.  A forked child process
+   *        gets a fresh pool.
+   */
+  static ThreadPool* Global();
+
+  /**
+   * \brief See `detail::PoolParallelFor`.
+   */
+  void Run(std::size_t n_tasks, std::int32_t n_threads, bool steal, std::size_t grain,
+           detail::PoolKernel kernel, void* fn);
+
+  [[nodiscard]] std::int32_t NumWorkers();
+};
+}  // namespace xgboost::common
+#endif  // XGBOOST_COMMON_THREAD_POOL_H_
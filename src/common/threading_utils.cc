@@ -42,7 +42,7 @@ int32_t GetCfsCPUCount() noexcept {
 
 std::int32_t OmpGetNumThreads(std::int32_t n_threads) {
   // Don't use parallel if we are in a parallel region.
-  if (omp_in_parallel()) {
+  if (InParallelRegion()) {
     return 1;
   }
   // If -1 or 0 is specified by the user, we default to maximum number of threads.
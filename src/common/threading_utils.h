@@ -8,11 +8,13 @@
 #include <dmlc/omp.h>
 
 #include <algorithm>
+#include <cstddef>  // for size_t
 #include <cstdint>  // for int32_t
 #include <cstdlib>  // for malloc, free
 #include <limits>
 #include <new>          // for bad_alloc
 #include <type_traits>  // for is_signed
+#include <utility>      // for make_pair
 #include <vector>
 
 #include "xgboost/logging.h"
@@ -127,12 +129,75 @@ class BlockedSpace2d {
 };
 
 
+/**
+ * \brief Backend used by `ParallelFor` and `ParallelFor2d`.
+ */
+enum class ParallelBackend : std::int32_t {
+  kOpenMP = 0,
+  // The internal work-stealing thread pool, see thread_pool.h
+  kThreadPool = 1,
+};
+
+/**
+ * \brief Get the parallel backend.  The default is OpenMP unless XGBoost is built with
+ *        `USE_THREAD_POOL`, and can be overridden by the `XGBOOST_PARALLEL_BACKEND`
+ *        environment variable (`omp` or `pool`).
+ */
+ParallelBackend GetParallelBackend();
+/**
+ * \brief Set the parallel backend for the whole process.
+ */
+void SetParallelBackend(ParallelBackend backend);
+
+/**
+ * \brief Index of the calling thread inside the current parallel loop, a replacement for
+ *        `omp_get_thread_num` that works with both backends.  The index is smaller than
+ *        the number of threads passed to the loop and is unique among the threads running
+ *        the loop concurrently.
+ */
+std::int32_t ThreadIdx();
+/**
+ * \brief Whether the calling thread is running inside a parallel loop of either backend.
+ */
+bool InParallelRegion();
+
+namespace detail {
+using PoolKernel = void (*)(void* fn, std::size_t begin, std::size_t end);
+/**
+ * \brief Run the kernel on tasks [0, n_tasks) with the internal thread pool.
+ *
+ * \param n_tasks   Number of tasks.
+ * \param n_threads Maximum number of threads, including the calling thread.
+ * \param steal     Whether idle threads can steal tasks from others.  Without stealing,
+ *                  tasks are split into contiguous blocks as in OpenMP static schedule.
+ * \param grain     Number of tasks taken by a thread at once, 0 for automatic.
+ */
+void PoolParallelFor(std::size_t n_tasks, std::int32_t n_threads, bool steal, std::size_t grain,
+                     PoolKernel kernel, void* fn);
+}  // namespace detail
+
 // Wrapper to implement nested parallelism with simple omp parallel for
 template <typename Func>
 void ParallelFor2d(const BlockedSpace2d& space, int nthreads, Func func) {
   const size_t num_blocks_in_space = space.Size();
   CHECK_GE(nthreads, 1);
 
+  if (GetParallelBackend() == ParallelBackend::kThreadPool) {
+    // Static partitioning of blocks is required by the histogram buffer, which assigns
+    // nodes to threads in advance.
+    auto task = std::make_pair(&space, &func);
+    detail::PoolParallelFor(
+        num_blocks_in_space, nthreads, false, 0,
+        [](void* fn, std::size_t begin, std::size_t end) {
+          auto const& [p_space, p_func] = *static_cast<decltype(task)*>(fn);
+          for (auto i = begin; i < end; ++i) {
+            (*p_func)(p_space->GetFirstDimension(i), p_space->GetRange(i));
+          }
+        },
+        &task);
+    return;
+  }
+
   dmlc::OMPException exc;
 #pragma omp parallel num_threads(nthreads)
   {
@@ -180,6 +245,32 @@ void ParallelFor(Index size, int32_t n_threads, Sched sched, Func fn) {
   OmpInd length = static_cast<OmpInd>(size);
   CHECK_GE(n_threads, 1);
 
+  if (GetParallelBackend() == ParallelBackend::kThreadPool) {
+    if (length <= 0) {
+      return;
+    }
+    auto kernel = [](void* fn, std::size_t begin, std::size_t end) {
+      for (auto i = begin; i < end; ++i) {
+        (*static_cast<Func*>(fn))(static_cast<Index>(i));
+      }
+    };
+    auto n = static_cast<std::size_t>(length);
+    switch (sched.sched) {
+      case Sched::kStatic:
+        detail::PoolParallelFor(n, n_threads, false, 0, kernel, &fn);
+        break;
+      case Sched::kDynamic:
+        detail::PoolParallelFor(n, n_threads, true, std::max(sched.chunk, std::size_t{1}), kernel,
+                                &fn);
+        break;
+      case Sched::kAuto:
+      case Sched::kGuided:
+        detail::PoolParallelFor(n, n_threads, true, 0, kernel, &fn);
+        break;
+    }
+    return;
+  }
+
   dmlc::OMPException exc;
   switch (sched.sched) {
   case Sched::kAuto: {
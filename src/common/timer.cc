@@ -7,6 +7,7 @@
 #include <utility>
 
 #include "../collective/communicator-inl.h"
+#include "trace.h"
 
 #if defined(XGBOOST_USE_NVTX)
 #include <nvToolsExt.h>
@@ -15,7 +16,29 @@
 namespace xgboost {
 namespace common {
 
+namespace {
+void RecordTrace(char const *name, char phase) {
+  TraceEvent event;
+  event.name = name;
+  event.category = "monitor";
+  event.phase = phase;
+  event.ts = Tracer::Now();
+  Tracer::Record(event);
+}
+}  // anonymous namespace
+
+char const *Monitor::TraceName(std::string const &name) {
+  auto it = trace_names_.find(name);
+  if (it == trace_names_.cend()) {
+    it = trace_names_.emplace(name, Tracer::Intern(label_ + "::" + name)).first;
+  }
+  return it->second;
+}
+
 void Monitor::Start(std::string const &name) {
+  if (Tracer::Enabled()) {
+    RecordTrace(this->TraceName(name), 'B');
+  }
   if (ConsoleLogger::ShouldLog(ConsoleLogger::LV::kDebug)) {
     auto &stats = statistics_map_[name];
     stats.timer.Start();
@@ -27,6 +50,9 @@ void Monitor::Start(std::string const &name) {
 }
 
 void Monitor::Stop(const std::string &name) {
+  if (Tracer::Enabled()) {
+    RecordTrace(this->TraceName(name), 'E');
+  }
   if (ConsoleLogger::ShouldLog(ConsoleLogger::LV::kDebug)) {
     auto &stats = statistics_map_[name];
     stats.timer.Stop();
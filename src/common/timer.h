@@ -57,9 +57,12 @@ struct Monitor {
 
   std::string label_ = "";
   std::map<std::string, Statistics> statistics_map_;
+  // Interned trace event name of each timer, resolved on first use.
+  std::map<std::string, char const*> trace_names_;
   Timer self_timer_;
 
   void PrintStatistics(StatMap const& statistics) const;
+  char const* TraceName(std::string const& name);
 
  public:
   Monitor() { self_timer_.Start(); }
@@ -77,7 +80,10 @@ struct Monitor {
   /*! \brief Print all the statistics. */
   void Print() const;
 
-  void Init(std::string label) { this->label_ = label; }
+  void Init(std::string label) {
+    this->label_ = label;
+    this->trace_names_.clear();
+  }
   void Start(const std::string &name);
   void Stop(const std::string &name);
 };
@@ -0,0 +1,225 @@
+/**
+ * Copyright 2023 by XGBoost Contributors
+ */
+#include "trace.h"
+
+#include <algorithm>      // for min, max, remove_if
+#include <chrono>         // for steady_clock, duration_cast, nanoseconds
+#include <cstdio>         // for snprintf
+#include <memory>         // for shared_ptr, make_shared
+#include <mutex>          // for mutex, lock_guard
+#include <unordered_set>  // for unordered_set
+#include <vector>         // for vector
+
+#include "../collective/communicator-inl.h"  // for GetRank
+#include "xgboost/logging.h"                 // for CHECK_GT
+
+namespace xgboost::common {
+std::atomic<bool> Tracer::enabled_{false};
+
+namespace {
+struct TraceBuffer {
+  std::mutex lock;
+  // Ring buffer of events, grown on demand up to `capacity`.  Once it's full, the next
+  // event goes to `n_recorded % capacity`.
+  std::vector<TraceEvent> events;
+  std::size_t capacity{0};
+  std::size_t n_recorded{0};
+  // The `Start` call this buffer belongs to, events from an earlier call are discarded.
+  std::uint64_t generation{0};
+  std::int32_t tid{0};
+};
+
+struct TraceState {
+  std::mutex lock;
+  std::vector<std::shared_ptr<TraceBuffer>> buffers;
+  std::int32_t next_tid{0};
+  std::atomic<std::uint64_t> generation{0};
+  std::atomic<std::size_t> capacity{0};
+  std::atomic<std::int64_t> epoch{0};
+
+  std::mutex names_lock;
+  std::unordered_set<std::string> names;
+};
+
+// Initial number of events allocated for a thread.
+std::size_t constexpr kMinEvents = 64;
+
+TraceState& GlobalState() {
+  static TraceState state;
+  return state;
+}
+
+std::int64_t SteadyNanoseconds() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+TraceBuffer* LocalBuffer() {
+  // The registry shares the ownership, so events are still available after the thread
+  // exits.
+  thread_local std::shared_ptr<TraceBuffer> buffer = [] {
+    auto& state = GlobalState();
+    auto ptr = std::make_shared<TraceBuffer>();
+    std::lock_guard<std::mutex> guard{state.lock};
+    ptr->tid = state.next_tid++;
+    state.buffers.push_back(ptr);
+    return ptr;
+  }();
+  return buffer.get();
+}
+
+void AppendEscaped(char const* str, std::string* out) {
+  for (; str && *str != '\0'; ++str) {
+    auto c = *str;
+    if (c == '"' || c == '\\') {
+      out->push_back('\\');
+      out->push_back(c);
+    } else if (static_cast<unsigned char>(c) < 0x20) {
+      char buf[8];
+      std::snprintf(buf, sizeof(buf), "\\u%04x", static_cast<unsigned>(c));
+      out->append(buf);
+    } else {
+      out->push_back(c);
+    }
+  }
+}
+
+void AppendEvent(TraceEvent const& event, std::int32_t pid, std::int32_t tid, std::string* out) {
+  char buf[128];
+  out->append(R"({"name":")");
+  AppendEscaped(event.name, out);
+  out->append(R"(","cat":")");
+  AppendEscaped(event.category ? event.category : "xgboost", out);
+  std::snprintf(buf, sizeof(buf), R"(","ph":"%c","ts":%.3f,"pid":%d,"tid":%d)", event.phase,
+                static_cast<double>(event.ts) / 1e3, pid, tid);
+  out->append(buf);
+  if (event.phase == 'X') {
+    std::snprintf(buf, sizeof(buf), R"(,"dur":%.3f)", static_cast<double>(event.dur) / 1e3);
+    out->append(buf);
+  }
+  out->append(R"(,"args":{)");
+  bool first = true;
+  for (auto const& arg : event.args) {
+    if (arg.key == nullptr) {
+      continue;
+    }
+    if (!first) {
+      out->push_back(',');
+    }
+    first = false;
+    out->push_back('"');
+    AppendEscaped(arg.key, out);
+    std::snprintf(buf, sizeof(buf), R"(":%lld)", static_cast<long long>(arg.value));  // NOLINT
+    out->append(buf);
+  }
+  out->append("}}");
+}
+}  // anonymous namespace
+
+void Tracer::Start(std::size_t capacity) {
+  CHECK_GT(capacity, 0) << "Invalid size of trace buffer.";
+  auto& state = GlobalState();
+  state.capacity.store(capacity);
+  state.epoch.store(SteadyNanoseconds());
+  state.generation.fetch_add(1, std::memory_order_release);
+  {
+    // Events from the previous run are discarded, release the buffers of threads that have
+    // exited.  Buffers of running threads are reset on their next event.
+    std::lock_guard<std::mutex> guard{state.lock};
+    auto& buffers = state.buffers;
+    buffers.erase(std::remove_if(buffers.begin(), buffers.end(),
+                                 [](auto const& buffer) { return buffer.use_count() == 1; }),
+                  buffers.end());
+  }
+  enabled_.store(true);
+}
+
+void Tracer::Stop() { enabled_.store(false); }
+
+std::int64_t Tracer::Now() {
+  return SteadyNanoseconds() - GlobalState().epoch.load(std::memory_order_relaxed);
+}
+
+void Tracer::Record(TraceEvent const& event) {
+  auto& state = GlobalState();
+  auto* buffer = LocalBuffer();
+  auto generation = state.generation.load(std::memory_order_acquire);
+  std::lock_guard<std::mutex> guard{buffer->lock};
+  auto& events = buffer->events;
+  if (buffer->generation != generation) {
+    events.clear();
+    buffer->capacity = state.capacity.load();
+    if (events.capacity() > buffer->capacity) {
+      events.shrink_to_fit();
+    }
+    buffer->n_recorded = 0;
+    buffer->generation = generation;
+  }
+  if (events.size() < buffer->capacity) {
+    if (events.size() == events.capacity()) {
+      // Grow geometrically without exceeding the capacity.
+      events.reserve(std::min(buffer->capacity, std::max(events.size() * 2, kMinEvents)));
+    }
+    events.push_back(event);
+  } else {
+    events[buffer->n_recorded % buffer->capacity] = event;
+  }
+  buffer->n_recorded++;
+}
+
+std::size_t Tracer::MemoryUsage() {
+  auto& state = GlobalState();
+  std::lock_guard<std::mutex> guard{state.lock};
+  std::size_t n_bytes = 0;
+  for (auto const& buffer : state.buffers) {
+    std::lock_guard<std::mutex> buffer_guard{buffer->lock};
+    n_bytes += buffer->events.capacity() * sizeof(TraceEvent);
+  }
+  return n_bytes;
+}
+
+char const* Tracer::Intern(std::string const& name) {
+  auto& state = GlobalState();
+  std::lock_guard<std::mutex> guard{state.names_lock};
+  return state.names.insert(name).first->c_str();
+}
+
+std::string Tracer::Dump() {
+  auto& state = GlobalState();
+  auto generation = state.generation.load(std::memory_order_acquire);
+  std::vector<std::shared_ptr<TraceBuffer>> buffers;
+  {
+    std::lock_guard<std::mutex> guard{state.lock};
+    buffers = state.buffers;
+  }
+  auto pid = collective::GetRank();
+
+  std::string out{R"({"displayTimeUnit":"ms","traceEvents":[)"};
+  bool first = true;
+  for (auto const& buffer : buffers) {
+    std::lock_guard<std::mutex> guard{buffer->lock};
+    if (buffer->generation != generation || buffer->n_recorded == 0) {
+      continue;
+    }
+    if (!first) {
+      out.push_back(',');
+    }
+    first = false;
+    auto tid = buffer->tid;
+    out.append(R"({"name":"thread_name","ph":"M","pid":)" + std::to_string(pid) +
+               R"(,"tid":)" + std::to_string(tid) + R"(,"args":{"name":"thread )" +
+               std::to_string(tid) + R"("}})");
+
+    auto capacity = buffer->events.size();
+    auto n = std::min(buffer->n_recorded, capacity);
+    for (auto i = buffer->n_recorded - n; i < buffer->n_recorded; ++i) {
+      out.push_back(',');
+      AppendEvent(buffer->events[i % capacity], pid, tid, &out);
+    }
+  }
+  out.append("]}");
+  return out;
+}
+}  // namespace xgboost::common
@@ -0,0 +1,119 @@
+/**
+ * Copyright 2023 by XGBoost Contributors
+ * \file trace.h
+ * \brief Low overhead tracing of training and prediction, exported in the Chrome trace
+ *        event format for chrome://tracing and Perfetto.
+ */
+#ifndef XGBOOST_COMMON_TRACE_H_
+#define XGBOOST_COMMON_TRACE_H_
+
+#include <array>             // for array
+#include <atomic>            // for atomic, memory_order_relaxed
+#include <cstddef>           // for size_t
+#include <cstdint>           // for int64_t
+#include <initializer_list>  // for initializer_list
+#include <string>            // for string
+
+namespace xgboost::common {
+/**
+ * \brief An integer argument attached to an event, like the number of rows or bytes.
+ *        The key must be a string literal.
+ */
+struct TraceArg {
+  char const* key{nullptr};
+  std::int64_t value{0};
+};
+
+struct TraceEvent {
+  static constexpr std::size_t kMaxArgs = 3;
+  // Either a string literal or a string from `Tracer::Intern`.
+  char const* name{nullptr};
+  char const* category{nullptr};
+  // Nanoseconds since the tracer is started.
+  std::int64_t ts{0};
+  // Duration of complete events in nanoseconds.
+  std::int64_t dur{0};
+  // 'X' for complete events, 'B' and 'E' for the beginning and end of a duration.
+  char phase{'X'};
+  std::array<TraceArg, kMaxArgs> args;
+};
+
+/**
+ * \brief Process-wide tracer.
+ *
+ *   Each thread records events into its own ring buffer, the oldest events are overwritten
+ *   once the buffer is full.  Buffers grow with the number of events, and the buffers of
+ *   exited threads are released by the next `Start`.  Recording takes an uncontended lock
+ *   on the buffer of the calling thread, and when tracing is not started the only cost is
+ *   a relaxed atomic load.
+ */
+class Tracer {
+  static std::atomic<bool> enabled_;
+
+ public:
+  [[nodiscard]] static bool Enabled() noexcept {
+    return enabled_.load(std::memory_order_relaxed);
+  }
+  /**
+   * \brief Discard existing events and start recording.
+   *
+   * \param capacity Maximum number of events kept for each thread.
+   */
+  static void Start(std::size_t capacity);
+  /**
+   * \brief Stop recording, the recorded events are kept until the next `Start`.
+   */
+  static void Stop();
+  /**
+   * \brief Export the recorded events from all threads as a Chrome trace JSON document.
+   */
+  [[nodiscard]] static std::string Dump();
+
+  /**
+   * \brief Number of bytes allocated for the events of all threads.
+   */
+  [[nodiscard]] static std::size_t MemoryUsage();
+
+  [[nodiscard]] static std::int64_t Now();
+  static void Record(TraceEvent const& event);
+  /**
+   * \brief Get a string with static storage duration for names built at runtime.
+   */
+  [[nodiscard]] static char const* Intern(std::string const& name);
+};
+
+/**
+ * \brief Record a complete event covering the lifetime of this object.
+ */
+class TraceScope {
+  TraceEvent event_;
+  bool active_;
+
+ public:
+  TraceScope(char const* name, char const* category, std::initializer_list<TraceArg> args = {})
+      : active_{Tracer::Enabled()} {
+    if (active_) {
+      event_.name = name;
+      event_.category = category;
+      std::size_t i = 0;
+      for (auto const& arg : args) {
+        if (i == TraceEvent::kMaxArgs) {
+          break;
+        }
+        event_.args[i++] = arg;
+      }
+      event_.ts = Tracer::Now();
+    }
+  }
+  ~TraceScope() {
+    if (active_) {
+      event_.dur = Tracer::Now() - event_.ts;
+      Tracer::Record(event_);
+    }
+  }
+
+  TraceScope(TraceScope const&) = delete;
+  TraceScope& operator=(TraceScope const&) = delete;
+};
+}  // namespace xgboost::common
+#endif  // XGBOOST_COMMON_TRACE_H_
@@ -8,6 +8,7 @@
 
 #include <algorithm>
 #include <cstddef>  // std::size_t
+#include <cstdint>  // std::int32_t, std::int64_t
 #include <functional>
 #include <limits>
 #include <map>
@@ -227,6 +228,7 @@ class DenseAdapterBatch : public detail::NoMetaInfo {
   const Line GetLine(size_t idx) const {
     return Line(values_ + idx * num_features_, num_features_, idx);
   }
+  common::Span<float const> Values() const { return {values_, num_rows_ * num_features_}; }
   static constexpr bool kIsRowMajor = true;
 
  private:
@@ -283,6 +285,7 @@ class ArrayAdapterBatch : public detail::NoMetaInfo {
   size_t NumRows() const { return array_interface_.Shape(0); }
   size_t NumCols() const { return array_interface_.Shape(1); }
   size_t Size() const { return this->NumRows(); }
+  ArrayInterface<2> const& Interface() const { return array_interface_; }
 
   explicit ArrayAdapterBatch(ArrayInterface<2> array_interface)
       : array_interface_{std::move(array_interface)} {}
@@ -356,6 +359,9 @@ class CSRArrayAdapterBatch : public detail::NoMetaInfo {
   }
   size_t NumCols() const { return n_features_; }
   size_t Size() const { return this->NumRows(); }
+  ArrayInterface<1> const& Indptr() const { return indptr_; }
+  ArrayInterface<1> const& Indices() const { return indices_; }
+  ArrayInterface<1> const& Values() const { return values_; }
 
   Line const GetLine(size_t idx) const {
     auto begin_no_stride = TypedIndex<size_t, 1>{indptr_}(idx);
@@ -406,6 +412,168 @@ class CSRArrayAdapter : public detail::SingleBatchDataIter<CSRArrayAdapterBatch>
   size_t num_cols_;
 };
 
+/**
+ * \brief Dense array batch with the data type resolved at compile time, see
+ *        `DispatchTypedBatch`.
+ */
+template <typename T>
+class TypedArrayAdapterBatch : public detail::NoMetaInfo {
+  T const *data_{nullptr};
+  std::size_t row_stride_{0};
+  std::size_t col_stride_{0};
+  std::size_t n_rows_{0};
+  std::size_t n_cols_{0};
+
+  class Line {
+    T const *ptr_;
+    std::size_t stride_;
+    std::size_t size_;
+    std::size_t ridx_;
+
+   public:
+    Line(T const *ptr, std::size_t stride, std::size_t size, std::size_t ridx)
+        : ptr_{ptr}, stride_{stride}, size_{size}, ridx_{ridx} {}
+
+    [[nodiscard]] std::size_t Size() const { return size_; }
+    [[nodiscard]] COOTuple GetElement(std::size_t idx) const {
+      return {ridx_, idx, static_cast<float>(ptr_[idx * stride_])};
+    }
+  };
+
+ public:
+  static constexpr bool kIsRowMajor = true;
+
+  explicit TypedArrayAdapterBatch(ArrayInterface<2> const &array)
+      : data_{static_cast<T const *>(array.data)},
+        row_stride_{array.Stride(0)},
+        col_stride_{array.Stride(1)},
+        n_rows_{array.Shape(0)},
+        n_cols_{array.Shape(1)} {}
+
+  [[nodiscard]] Line GetLine(std::size_t ridx) const {
+    return Line{data_ + ridx * row_stride_, col_stride_, n_cols_, ridx};
+  }
+  [[nodiscard]] std::size_t NumRows() const { return n_rows_; }
+  [[nodiscard]] std::size_t NumCols() const { return n_cols_; }
+  [[nodiscard]] std::size_t Size() const { return this->NumRows(); }
+};
+
+/**
+ * \brief CSR array batch with the types of indices and values resolved at compile time,
+ *        see `DispatchTypedBatch`.
+ */
+template <typename I, typename T>
+class TypedCSRArrayAdapterBatch : public detail::NoMetaInfo {
+  ArrayInterface<1> indptr_;
+  I const *indices_{nullptr};
+  std::size_t indices_stride_{0};
+  T const *values_{nullptr};
+  std::size_t values_stride_{0};
+  bst_feature_t n_features_{0};
+
+  class Line {
+    I const *indices_;
+    std::size_t indices_stride_;
+    T const *values_;
+    std::size_t values_stride_;
+    std::size_t size_;
+    std::size_t ridx_;
+
+   public:
+    Line(I const *indices, std::size_t indices_stride, T const *values,
+         std::size_t values_stride, std::size_t size, std::size_t ridx)
+        : indices_{indices},
+          indices_stride_{indices_stride},
+          values_{values},
+          values_stride_{values_stride},
+          size_{size},
+          ridx_{ridx} {}
+
+    [[nodiscard]] std::size_t Size() const { return size_; }
+    [[nodiscard]] COOTuple GetElement(std::size_t idx) const {
+      return {ridx_, static_cast<std::size_t>(indices_[idx * indices_stride_]),
+              static_cast<float>(values_[idx * values_stride_])};
+    }
+  };
+
+ public:
+  static constexpr bool kIsRowMajor = true;
+
+  TypedCSRArrayAdapterBatch(ArrayInterface<1> const &indptr, ArrayInterface<1> const &indices,
+                            ArrayInterface<1> const &values, bst_feature_t n_features)
+      : indptr_{indptr},
+        indices_{static_cast<I const *>(indices.data)},
+        indices_stride_{indices.Stride(0)},
+        values_{static_cast<T const *>(values.data)},
+        values_stride_{values.Stride(0)},
+        n_features_{n_features} {}
+
+  [[nodiscard]] Line GetLine(std::size_t ridx) const {
+    auto beg = TypedIndex<std::size_t, 1>{indptr_}(ridx);
+    auto end = TypedIndex<std::size_t, 1>{indptr_}(ridx + 1);
+    return Line{indices_ + beg * indices_stride_, indices_stride_,
+                values_ + beg * values_stride_,   values_stride_,
+                end - beg,                        ridx};
+  }
+  [[nodiscard]] std::size_t NumRows() const {
+    std::size_t size = indptr_.Shape(0);
+    return size == 0 ? 0 : size - 1;
+  }
+  [[nodiscard]] std::size_t NumCols() const { return n_features_; }
+  [[nodiscard]] std::size_t Size() const { return this->NumRows(); }
+};
+
+/**
+ * \brief Call `fn` with a batch that has the data type resolved at compile time, so that
+ *        the type is not dispatched for every element.  Batches without a typed
+ *        counterpart are passed through.
+ */
+template <typename Batch, typename Fn>
+decltype(auto) DispatchTypedBatch(Batch const &batch, Fn &&fn) {
+  return fn(batch);
+}
+
+template <typename Fn>
+decltype(auto) DispatchTypedBatch(ArrayAdapterBatch const &batch, Fn &&fn) {
+  auto const &array = batch.Interface();
+  return DispatchCommonDType(
+      array.type,
+      [&](auto t) {
+        using T = decltype(t);
+        return fn(TypedArrayAdapterBatch<T>{array});
+      },
+      [&] { return fn(batch); });
+}
+
+template <typename Fn>
+decltype(auto) DispatchTypedBatch(CSRArrayAdapterBatch const &batch, Fn &&fn) {
+  auto dispatch = [&](auto i, auto t) {
+    using I = decltype(i);
+    using T = decltype(t);
+    return fn(TypedCSRArrayAdapterBatch<I, T>{batch.Indptr(), batch.Indices(), batch.Values(),
+                                              static_cast<bst_feature_t>(batch.NumCols())});
+  };
+  // Only the common combinations from scipy and R are specialized.
+  auto dispatch_values = [&](auto i) {
+    switch (batch.Values().type) {
+      case ArrayInterfaceHandler::kF4:
+        return dispatch(i, float{});
+      case ArrayInterfaceHandler::kF8:
+        return dispatch(i, double{});
+      default:
+        return fn(batch);
+    }
+  };
+  switch (batch.Indices().type) {
+    case ArrayInterfaceHandler::kI4:
+      return dispatch_values(std::int32_t{});
+    case ArrayInterfaceHandler::kI8:
+      return dispatch_values(std::int64_t{});
+    default:
+      return fn(batch);
+  }
+}
+
 class CSCAdapterBatch : public detail::NoMetaInfo {
  public:
   CSCAdapterBatch(const size_t* col_ptr, const unsigned* row_idx,
@@ -658,6 +658,29 @@ void DispatchDType(ArrayInterface<D> const array, std::int32_t device, Fn fn) {
   }
 }
 
+/**
+ * \brief Dispatch the most common data types to compile time types, used for lifting the
+ *        type dispatching out of hot loops.  `fallback` is called for other types.
+ */
+template <typename Fn, typename Fallback>
+decltype(auto) DispatchCommonDType(ArrayInterfaceHandler::Type type, Fn &&fn,
+                                   Fallback &&fallback) {
+  switch (type) {
+    case ArrayInterfaceHandler::kF4:
+      return fn(float{});
+    case ArrayInterfaceHandler::kF8:
+      return fn(double{});
+    case ArrayInterfaceHandler::kI1:
+      return fn(std::int8_t{});
+    case ArrayInterfaceHandler::kI4:
+      return fn(std::int32_t{});
+    case ArrayInterfaceHandler::kI8:
+      return fn(std::int64_t{});
+    default:
+      return fallback();
+  }
+}
+
 /**
  * \brief Helper for type casting.
  */
@@ -29,5 +29,14 @@ inline bool RegenGHist(BatchParam old, BatchParam p) {
   }
   return p.regen || old.ParamNotEqual(p);
 }
+
+/**
+ * \brief Can we update the existing gradient index incrementally for new hessian instead
+ *        of regenerating it?
+ */
+inline bool RebinGHist(BatchParam old, BatchParam p) {
+  return p.Initialized() && p.regen && !old.ParamNotEqual(p) && p.rebin_tolerance > 0.0 &&
+         !p.hess.empty() && !old.hess.empty();
+}
 }  // namespace xgboost::data::detail
 #endif  // XGBOOST_DATA_BATCH_UTILS_H_
@@ -1007,7 +1007,7 @@ SparsePage SparsePage::GetTranspose(int num_columns, int32_t n_threads) const {
   long batch_size = static_cast<long>(this->Size());  // NOLINT(*)
   auto page = this->GetView();
   common::ParallelFor(batch_size, n_threads, [&](long i) {  // NOLINT(*)
-    int tid = omp_get_thread_num();
+    int tid = common::ThreadIdx();
     auto inst = page[i];
     for (const auto& entry : inst) {
       builder.AddBudget(entry.index, tid);
@@ -1015,7 +1015,7 @@ SparsePage SparsePage::GetTranspose(int num_columns, int32_t n_threads) const {
   });
   builder.InitStorage();
   common::ParallelFor(batch_size, n_threads, [&](long i) {  // NOLINT(*)
-    int tid = omp_get_thread_num();
+    int tid = common::ThreadIdx();
     auto inst = page[i];
     for (const auto& entry : inst) {
       builder.Push(
@@ -1042,7 +1042,7 @@ bool SparsePage::IsIndicesSorted(int32_t n_threads) const {
   common::ParallelFor(this->Size(), n_threads, [&](auto i) {
     auto beg = h_offset[i];
     auto end = h_offset[i + 1];
-    is_sorted_tloc[omp_get_thread_num()] +=
+    is_sorted_tloc[common::ThreadIdx()] +=
         !!std::is_sorted(h_data.begin() + beg, h_data.begin() + end, Entry::CmpIndex);
   });
   auto is_sorted = std::accumulate(is_sorted_tloc.cbegin(), is_sorted_tloc.cend(),
@@ -1096,8 +1096,12 @@ void SparsePage::Push(const SparsePage &batch) {
   }
 }
 
+namespace {
 template <typename AdapterBatchT>
-uint64_t SparsePage::Push(const AdapterBatchT& batch, float missing, int nthread) {
+uint64_t PushBatch(SparsePage* page, const AdapterBatchT& batch, float missing, int nthread) {
+  auto& offset = page->offset;
+  auto& data = page->data;
+  auto const base_rowid = page->base_rowid;
   constexpr bool kIsRowMajor = AdapterBatchT::kIsRowMajor;
   // Allow threading only for row-major case as column-major requires O(nthread*batch_size) memory
   nthread = kIsRowMajor ? nthread : 1;
@@ -1107,7 +1111,7 @@ uint64_t SparsePage::Push(const AdapterBatchT& batch, float missing, int nthread
   auto& offset_vec = offset.HostVector();
   auto& data_vec = data.HostVector();
 
-  size_t builder_base_row_offset = this->Size();
+  size_t builder_base_row_offset = page->Size();
   common::ParallelGroupBuilder<
       Entry, std::remove_reference<decltype(offset_vec)>::type::value_type, kIsRowMajor>
       builder(&offset_vec, &data_vec, builder_base_row_offset);
@@ -1195,6 +1199,14 @@ uint64_t SparsePage::Push(const AdapterBatchT& batch, float missing, int nthread
   exec.Rethrow();
   return max_columns;
 }
+}  // anonymous namespace
+
+template <typename AdapterBatchT>
+uint64_t SparsePage::Push(const AdapterBatchT& batch, float missing, int nthread) {
+  return data::DispatchTypedBatch(batch, [&](auto const& typed) {
+    return PushBatch(this, typed, missing, nthread);
+  });
+}
 
 void SparsePage::PushCSC(const SparsePage &batch) {
   std::vector<xgboost::Entry>& self_data = data.HostVector();
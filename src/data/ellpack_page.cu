@@ -305,14 +305,27 @@ namespace {
 void CopyGHistToEllpack(GHistIndexMatrix const& page, common::Span<size_t const> d_row_ptr,
                         size_t row_stride, common::CompressedByteT* d_compressed_buffer,
                         size_t null) {
-  dh::device_vector<uint8_t> data(page.index.begin(), page.index.end());
+  auto bin_type = page.index.GetBinTypeSize();
+  dh::device_vector<uint8_t> data;
+  if (page.index.IsPacked()) {
+    // Unpack the 4-bit bins on host, the local bins are copied as uint32.
+    std::vector<std::uint32_t> h_bins(page.index.Size());
+    auto n_features = page.index.OffsetSize();
+    for (size_t i = 0; i < h_bins.size(); ++i) {
+      h_bins[i] = page.index[i] - page.index.Offset()[i % n_features];
+    }
+    auto const* ptr = reinterpret_cast<uint8_t const*>(h_bins.data());
+    data.assign(ptr, ptr + h_bins.size() * sizeof(std::uint32_t));
+    bin_type = common::kUint32BinsTypeSize;
+  } else {
+    data.assign(page.index.begin(), page.index.end());
+  }
   auto d_data = dh::ToSpan(data);
 
   dh::device_vector<size_t> csc_indptr(page.index.Offset(),
                                        page.index.Offset() + page.index.OffsetSize());
   auto d_csc_indptr = dh::ToSpan(csc_indptr);
 
-  auto bin_type = page.index.GetBinTypeSize();
   common::CompressedBufferWriter writer{page.cut.TotalBins() + 1};  // +1 for null value
 
   dh::LaunchN(row_stride * page.Size(), [=] __device__(size_t idx) mutable {
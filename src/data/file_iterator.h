@@ -4,6 +4,7 @@
 #ifndef XGBOOST_DATA_FILE_ITERATOR_H_
 #define XGBOOST_DATA_FILE_ITERATOR_H_
 
+#include <algorithm>
 #include <map>
 #include <memory>
 #include <string>
@@ -12,6 +13,7 @@
 
 #include "array_interface.h"
 #include "dmlc/data.h"
+#include "xgboost/base.h"
 #include "xgboost/c_api.h"
 #include "xgboost/json.h"
 #include "xgboost/linalg.h"
@@ -59,6 +61,8 @@ class FileIterator {
   uint32_t part_idx_;
   // Equals to total number of workers.
   uint32_t n_parts_;
+  // Number of columns reported to the proxy, inferred from each batch when it's 0.
+  bst_feature_t n_features_;
 
   DMatrixHandle proxy_;
 
@@ -71,8 +75,9 @@ class FileIterator {
   std::string indices_;
 
  public:
-  FileIterator(std::string uri, unsigned part_index, unsigned num_parts)
-      : uri_{std::move(uri)}, part_idx_{part_index}, n_parts_{num_parts} {
+  FileIterator(std::string uri, unsigned part_index, unsigned num_parts,
+               bst_feature_t n_features = 0)
+      : uri_{std::move(uri)}, part_idx_{part_index}, n_parts_{num_parts}, n_features_{n_features} {
     ValidateFileFormat(uri_);
     XGProxyDMatrixCreate(&proxy_);
   }
@@ -90,11 +95,16 @@ class FileIterator {
       values_ = ArrayInterfaceStr(MakeVec(row_block_.value, row_block_.offset[row_block_.size]));
       indices_ = ArrayInterfaceStr(MakeVec(row_block_.index, row_block_.offset[row_block_.size]));
 
-      size_t n_columns = *std::max_element(row_block_.index,
-                                           row_block_.index + row_block_.offset[row_block_.size]);
+      auto nnz = row_block_.offset[row_block_.size];
       // dmlc parser converts 1-based indexing back to 0-based indexing so we can ignore
       // this condition and just add 1 to n_columns
-      n_columns += 1;
+      size_t n_columns =
+          nnz == 0 ? 0 : *std::max_element(row_block_.index, row_block_.index + nnz) + 1;
+      if (n_features_ != 0) {
+        CHECK_LE(n_columns, n_features_)
+            << "Number of columns in data is greater than the number of features.";
+        n_columns = n_features_;
+      }
 
       XGProxyDMatrixSetDataCSR(proxy_, indptr_.c_str(), indices_.c_str(),
                                values_.c_str(), n_columns);
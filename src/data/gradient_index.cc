@@ -5,13 +5,17 @@
 #include "gradient_index.h"
 
 #include <algorithm>
+#include <cmath>    // for abs
+#include <cstring>  // for memset
 #include <limits>
 #include <memory>
+#include <numeric>  // for accumulate
 #include <utility>  // std::forward
 
 #include "../common/column_matrix.h"
 #include "../common/hist_util.h"
 #include "../common/numeric.h"
+#include "../common/quantile.h"  // for MergeWeights, HostSketchContainer
 #include "../common/threading_utils.h"
 #include "../common/transform_iterator.h"  // MakeIndexTransformIter
 
@@ -127,21 +131,234 @@ INSTANTIATION_PUSH(data::SparsePageAdapterBatch)
 
 #undef INSTANTIATION_PUSH
 
-void GHistIndexMatrix::ResizeIndex(const size_t n_index, const bool isDense) {
+void GHistIndexMatrix::ResizeIndex(const size_t n_index, const bool isDense, bool pack) {
   if ((MaxNumBinPerFeat() - 1 <= static_cast<int>(std::numeric_limits<uint8_t>::max())) &&
       isDense) {
     // compress dense index to uint8
     index.SetBinTypeSize(common::kUint8BinsTypeSize);
-    index.Resize((sizeof(uint8_t)) * n_index);
   } else if ((MaxNumBinPerFeat() - 1 > static_cast<int>(std::numeric_limits<uint8_t>::max()) &&
               MaxNumBinPerFeat() - 1 <= static_cast<int>(std::numeric_limits<uint16_t>::max())) &&
              isDense) {
     // compress dense index to uint16
     index.SetBinTypeSize(common::kUint16BinsTypeSize);
-    index.Resize((sizeof(uint16_t)) * n_index);
   } else {
     index.SetBinTypeSize(common::kUint32BinsTypeSize);
-    index.Resize((sizeof(uint32_t)) * n_index);
+  }
+
+  index.Unpack();
+  if (isDense && pack) {
+    index.SetBinOffset(cut.Ptrs());
+    if (index.Pack(cut.Ptrs())) {
+      index.Resize(index.PackedBytes(n_index));
+      return;
+    }
+  }
+  index.Resize(static_cast<size_t>(index.GetBinTypeSize()) * n_index);
+}
+
+void GHistIndexMatrix::FirstTouchIndex(std::size_t rbegin, std::size_t n_rows,
+                                       std::size_t n_threads) {
+  n_threads = std::max(std::min(n_threads, n_rows), static_cast<std::size_t>(1));
+  auto row_bytes = [&](std::size_t ridx) {
+    return index.IsPacked() ? index.PackedBytes(row_ptr[ridx])
+                            : row_ptr[ridx] * static_cast<std::size_t>(index.GetBinTypeSize());
+  };
+  auto data = index.data<std::uint8_t>();
+  auto block = common::DivRoundUp(n_rows, n_threads);
+  // One task for each thread, task t is run by thread t with the static schedule.
+  common::ParallelFor(n_threads, n_threads, common::Sched::Static(), [&](std::size_t t) {
+    auto begin = std::min(t * block, n_rows) + rbegin;
+    auto end = std::min((t + 1) * block, n_rows) + rbegin;
+    auto first = row_bytes(begin);
+    auto last = row_bytes(end);
+    if (last > first) {
+      std::memset(data + first, 0, last - first);
+    }
+  });
+}
+
+namespace {
+/**
+ * \brief Rank error of the existing cuts of a feature under the new weights.
+ *
+ *   The upper bound of the j^th bin should have a weighted rank of (j + 1) / n_bins.
+ */
+double CutRankError(common::Span<double const> bin_weights) {
+  auto n_bins = bin_weights.size();
+  double total = std::accumulate(bin_weights.cbegin(), bin_weights.cend(), 0.0);
+  if (total <= 0.0) {
+    return 0.0;
+  }
+  double rank = 0.0, error = 0.0;
+  for (std::size_t j = 0; j + 1 < n_bins; ++j) {
+    rank += bin_weights[j];
+    auto expected = static_cast<double>(j + 1) * total / static_cast<double>(n_bins);
+    error = std::max(error, std::abs(rank - expected) / total);
+  }
+  return error;
+}
+
+/**
+ * \brief Weighted quantiles of a sorted column with the same number of bins.
+ *
+ *   The j^th cut is the first distinct value whose weighted rank is at least
+ *   (j + 1) / n_bins.  The last cut is the upper bound of the feature and is kept.
+ *
+ * \return Whether there are enough distinct values to fill all the bins.
+ */
+bool WeightedCuts(common::Span<Entry const> column, std::vector<float> const &weights,
+                  common::Span<float> cuts) {
+  double total{0.0};
+  for (auto const &e : column) {
+    total += weights.empty() ? 1.0 : weights[e.index];
+  }
+  if (total <= 0.0 || column.empty()) {
+    return false;
+  }
+  auto n_bins = cuts.size();
+  std::size_t i = 0;
+  double rank = 0.0;
+  // Move to the next distinct value.
+  auto advance = [&] {
+    auto value = column[i].fvalue;
+    while (i < column.size() && column[i].fvalue == value) {
+      rank += weights.empty() ? 1.0 : weights[column[i].index];
+      ++i;
+    }
+  };
+  // The minimum value is not used as a cut.
+  advance();
+  for (std::size_t j = 0; j + 1 < n_bins; ++j) {
+    auto expected = static_cast<double>(j + 1) * total / static_cast<double>(n_bins);
+    while (i < column.size() && rank < expected) {
+      advance();
+    }
+    if (i == column.size() || column[i].fvalue >= cuts.back()) {
+      return false;
+    }
+    cuts[j] = column[i].fvalue;
+    advance();
+  }
+  return true;
+}
+}  // anonymous namespace
+
+bst_feature_t GHistIndexMatrix::Rebin(Context const *ctx, DMatrix *p_fmat,
+                                      common::Span<float const> hess, double tolerance) {
+  CHECK(p_fmat->SingleColBlock());
+  CHECK(!columns_ || !columns_->IsInitialized())
+      << "Re-binning is not supported with column matrix.";
+  CHECK_EQ(base_rowid, 0);
+  auto const &info = p_fmat->Info();
+  auto n_threads = ctx->Threads();
+  auto weights = common::detail::MergeWeights(
+      info, hess, common::HostSketchContainer::UseGroup(info), n_threads);
+
+  // Accumulate the new weight of each existing bin, which is a summary of the data that
+  // is much cheaper to obtain than a new sketch.
+  auto n_bins_total = cut.TotalBins();
+  auto n_samples = this->Size();
+  std::vector<double> bin_weights_tloc(static_cast<std::size_t>(n_threads) * n_bins_total, 0.0);
+  common::ParallelFor(n_samples, n_threads, common::Sched::Static(), [&](std::size_t ridx) {
+    auto *local = bin_weights_tloc.data() + common::ThreadIdx() * n_bins_total;
+    for (auto j = row_ptr[ridx]; j < row_ptr[ridx + 1]; ++j) {
+      local[index[j]] += weights[ridx];
+    }
+  });
+  std::vector<double> bin_weights(n_bins_total, 0.0);
+  common::ParallelFor(n_bins_total, n_threads, [&](std::size_t i) {
+    for (std::int32_t tid = 0; tid < n_threads; ++tid) {
+      bin_weights[i] += bin_weights_tloc[tid * n_bins_total + i];
+    }
+  });
+
+  auto const &ptrs = cut.Ptrs();
+  auto ft = info.feature_types.ConstHostSpan();
+  std::vector<bst_feature_t> moved;
+  for (bst_feature_t fidx = 0; fidx < this->Features(); ++fidx) {
+    if (common::IsCat(ft, fidx)) {
+      // Categories don't depend on the weights.
+      continue;
+    }
+    auto f_weights = common::Span<double const>{bin_weights}.subspan(
+        ptrs[fidx], ptrs[fidx + 1] - ptrs[fidx]);
+    if (CutRankError(f_weights) > tolerance) {
+      moved.push_back(fidx);
+    }
+  }
+  if (moved.empty()) {
+    return 0;
+  }
+
+  // Re-bin the moved features from the sorted columns.  The number of bins of each feature
+  // is unchanged, hence the bin offsets and the bin type stay valid.
+  auto &values = cut.cut_values_.HostVector();
+  bst_feature_t n_rebinned{0};
+  for (auto const &page : p_fmat->GetBatches<SortedCSCPage>(ctx)) {
+    auto columns = page.GetView();
+    for (auto fidx : moved) {
+      auto column = columns[fidx];
+      auto f_cuts = common::Span<float>{values}.subspan(ptrs[fidx], ptrs[fidx + 1] - ptrs[fidx]);
+      std::vector<float> new_cuts(f_cuts.cbegin(), f_cuts.cend());
+      if (!WeightedCuts(column, weights, common::Span<float>{new_cuts})) {
+        continue;
+      }
+      std::copy(new_cuts.cbegin(), new_cuts.cend(), f_cuts.begin());
+      this->RebinColumn(ctx, fidx, column);
+      ++n_rebinned;
+    }
+  }
+  return n_rebinned;
+}
+
+void GHistIndexMatrix::RebinColumn(Context const *ctx, bst_feature_t fidx,
+                                   common::Span<Entry const> column) {
+  auto const &ptrs = cut.Ptrs();
+  auto const &values = cut.Values();
+  auto f_begin = ptrs[fidx];
+  auto f_end = ptrs[fidx + 1];
+  auto n_features = this->Features();
+  // Rows are unique in a column, so threads write to different rows.
+  if (this->IsDense()) {
+    common::DispatchBinType(index.GetBinTypeSize(), [&](auto t) {
+      using BinT = decltype(t);
+      auto data = index.data<std::uint8_t>();
+      auto packed = index.Packed<BinT>();
+      common::ParallelFor(column.size(), ctx->Threads(), [&](std::size_t i) {
+        auto const &e = column[i];
+        auto bin = static_cast<std::uint32_t>(cut.SearchBin(e.fvalue, fidx, ptrs, values)) -
+                   f_begin;
+        if (!index.IsPacked()) {
+          reinterpret_cast<BinT *>(data)[e.index * n_features + fidx] = static_cast<BinT>(bin);
+          return;
+        }
+        auto row = data + e.index * packed.row_bytes;
+        auto k = packed.slot[fidx];
+        if (k < packed.n_narrow) {
+          auto shift = (k % 2) * 4;
+          row[k / 2] = static_cast<std::uint8_t>((row[k / 2] & ~(0xF << shift)) | (bin << shift));
+        } else {
+          reinterpret_cast<BinT *>(row + packed.narrow_bytes)[k - packed.n_narrow] =
+              static_cast<BinT>(bin);
+        }
+      });
+    });
+  } else {
+    auto data = index.data<std::uint32_t>();
+    common::ParallelFor(column.size(), ctx->Threads(), [&](std::size_t i) {
+      auto const &e = column[i];
+      // Entries in a row are sorted by the bin index.
+      auto beg = data + row_ptr[e.index];
+      auto end = data + row_ptr[e.index + 1];
+      auto it = std::lower_bound(beg, end, f_begin);
+      CHECK(it != end && *it < f_end);
+      *it = static_cast<std::uint32_t>(cut.SearchBin(e.fvalue, fidx, ptrs, values));
+    });
+  }
+
+  std::fill(hit_count.begin() + f_begin, hit_count.begin() + f_end, 0);
+  for (auto const &e : column) {
+    ++hit_count[cut.SearchBin(e.fvalue, fidx, ptrs, values)];
   }
 }
 
@@ -180,6 +397,15 @@ float GHistIndexMatrix::GetFvalue(std::vector<std::uint32_t> const &ptrs,
     return values[gidx];
   }
 
+  if (!columns_->IsInitialized()) {
+    // The column matrix is not built, search the bin in the row-major index instead.
+    auto gidx = GetGindex(ridx, fidx);
+    if (gidx == -1) {
+      return std::numeric_limits<float>::quiet_NaN();
+    }
+    return common::HistogramCuts::NumericBinValue(ptrs, values, mins, fidx, gidx);
+  }
+
   auto get_bin_val = [&](auto &column) {
     auto bin_idx = column[ridx];
     if (bin_idx == common::DenseColumnIter<uint8_t, true>::kMissingId) {
@@ -9,6 +9,7 @@
 #include <atomic>     // for atomic
 #include <cinttypes>  // for uint32_t
 #include <cstddef>    // for size_t
+#include <cstring>    // for memset
 #include <memory>
 #include <vector>
 
@@ -55,12 +56,16 @@ class GHistIndexMatrix {
    */
   void PushBatch(SparsePage const& batch, common::Span<FeatureType const> ft, int32_t n_threads);
 
-  template <typename Batch, typename BinIdxType, typename GetOffset, typename IsValid>
-  void SetIndexData(common::Span<BinIdxType> index_data_span, size_t rbegin,
-                    common::Span<FeatureType const> ft, size_t batch_threads, Batch const& batch,
-                    IsValid&& is_valid, size_t nbins, GetOffset&& get_offset) {
+  /**
+   * \brief Search the bins for a batch.
+   *
+   * \param assign Callback for storing a bin, called with the row index, the position of
+   *               the entry in index, the feature index and the global bin index.
+   */
+  template <typename Batch, typename Assign, typename IsValid>
+  void SetIndexData(size_t rbegin, common::Span<FeatureType const> ft, size_t batch_threads,
+                    Batch const& batch, IsValid&& is_valid, size_t nbins, Assign&& assign) {
     auto batch_size = batch.Size();
-    BinIdxType* index_data = index_data_span.data();
     auto const& ptrs = cut.Ptrs();
     auto const& values = cut.Values();
     std::atomic<bool> valid{true};
@@ -68,7 +73,7 @@ class GHistIndexMatrix {
       auto line = batch.GetLine(i);
       size_t ibegin = row_ptr[rbegin + i];  // index of first entry for current block
       size_t k = 0;
-      auto tid = omp_get_thread_num();
+      auto tid = common::ThreadIdx();
       for (size_t j = 0; j < line.Size(); ++j) {
         data::COOTuple elem = line.GetElement(j);
         if (is_valid(elem)) {
@@ -81,7 +86,7 @@ class GHistIndexMatrix {
           } else {
             bin_idx = cut.SearchBin(elem.value, elem.column_idx, ptrs, values);
           }
-          index_data[ibegin + k] = get_offset(bin_idx, j);
+          assign(rbegin + i, ibegin + k, j, bin_idx);
           ++hit_count_tloc_[tid * nbins + bin_idx];
           ++k;
         }
@@ -112,22 +117,48 @@ class GHistIndexMatrix {
 
     auto n_bins_total = cut.TotalBins();
     const size_t n_index = row_ptr[rbegin + batch.Size()];  // number of entries in this page
-    ResizeIndex(n_index, isDense_);
-    if (isDense_) {
-      index.SetBinOffset(cut.Ptrs());
-    }
-    if (isDense_) {
+    ResizeIndex(n_index, isDense_, true);
+    this->FirstTouchIndex(rbegin, batch.Size(), batch_threads);
+    if (isDense_ && index.IsPacked()) {
       common::DispatchBinType(index.GetBinTypeSize(), [&](auto dtype) {
         using T = decltype(dtype);
-        common::Span<T> index_data_span = {index.data<T>(), index.Size()};
-        SetIndexData(index_data_span, rbegin, ft, batch_threads, batch, is_valid, n_bins_total,
-                     index.MakeCompressor<T>());
+        auto packed = index.Packed<T>();
+        auto offsets = index.Offset();
+        auto data = index.data<std::uint8_t>();
+        SetIndexData(rbegin, ft, batch_threads, batch, is_valid, n_bins_total,
+                     [=](size_t ridx, size_t, size_t fidx, bst_bin_t bin_idx) {
+                       auto row = data + ridx * packed.row_bytes;
+                       if (fidx == 0) {
+                         // The 4-bit bins are or-ed into the row.
+                         std::memset(row, 0, packed.narrow_bytes);
+                       }
+                       auto bin = static_cast<std::uint32_t>(bin_idx) - offsets[fidx];
+                       auto k = packed.slot[fidx];
+                       if (k < packed.n_narrow) {
+                         row[k / 2] |= static_cast<std::uint8_t>(bin << ((k % 2) * 4));
+                       } else {
+                         reinterpret_cast<T*>(row + packed.narrow_bytes)[k - packed.n_narrow] =
+                             static_cast<T>(bin);
+                       }
+                     });
+      });
+    } else if (isDense_) {
+      common::DispatchBinType(index.GetBinTypeSize(), [&](auto dtype) {
+        using T = decltype(dtype);
+        auto index_data = index.data<T>();
+        auto compress = index.MakeCompressor<T>();
+        SetIndexData(rbegin, ft, batch_threads, batch, is_valid, n_bins_total,
+                     [=](size_t, size_t pos, size_t fidx, bst_bin_t bin_idx) {
+                       index_data[pos] = compress(bin_idx, fidx);
+                     });
       });
     } else {
-      common::Span<uint32_t> index_data_span = {index.data<uint32_t>(), n_index};
+      auto index_data = index.data<uint32_t>();
       // no compression
-      SetIndexData(index_data_span, rbegin, ft, batch_threads, batch, is_valid, n_bins_total,
-                   [](auto idx, auto) { return idx; });
+      SetIndexData(rbegin, ft, batch_threads, batch, is_valid, n_bins_total,
+                   [=](size_t, size_t pos, size_t, bst_bin_t bin_idx) {
+                     index_data[pos] = bin_idx;
+                   });
     }
     this->GatherHitCount(n_threads, n_bins_total);
   }
@@ -205,7 +236,36 @@ class GHistIndexMatrix {
   void PushAdapterBatchColumns(Context const* ctx, Batch const& batch, float missing,
                                size_t rbegin);
 
-  void ResizeIndex(const size_t n_index, const bool isDense);
+  /**
+   * \brief Choose the bin type and resize the index.
+   *
+   * \param pack Set the bin offset for dense data and use the 4-bit packed layout when it
+   *             saves memory.
+   */
+  void ResizeIndex(const size_t n_index, const bool isDense, bool pack = false);
+  /**
+   * \brief Zero the index of rows in [rbegin, rbegin + n_rows) after resize.
+   *
+   *   The rows are split into one contiguous block per thread, the same blocks each thread
+   *   gets from `ParallelFor2d` when building the histogram of the root node.  The block of
+   *   a thread is written by that thread first, so with pinned threads the pages are
+   *   placed on its NUMA node.
+   */
+  void FirstTouchIndex(std::size_t rbegin, std::size_t n_rows, std::size_t n_threads);
+
+  /**
+   * \brief Update the hessian weighted cuts and the index for the approx tree method
+   *        without sketching the data again.
+   *
+   *   The weight of each existing bin under the new hessian is accumulated from the
+   *   index.  Features whose cuts deviate from the weighted quantiles by more than
+   *   `tolerance` in rank are re-binned from the sorted columns.  The number of bins of
+   *   each feature is unchanged so the other features are left intact.
+   *
+   * \return The number of re-binned features.
+   */
+  bst_feature_t Rebin(Context const* ctx, DMatrix* p_fmat, common::Span<float const> hess,
+                      double tolerance);
 
   void GetFeatureCounts(size_t* counts) const {
     auto nfeature = cut.Ptrs().size() - 1;
@@ -246,6 +306,9 @@ class GHistIndexMatrix {
   std::unique_ptr<common::ColumnMatrix> columns_;
   std::vector<size_t> hit_count_tloc_;
   bool isDense_;
+
+  // Search the bins of a feature again after its cuts are changed.
+  void RebinColumn(Context const* ctx, bst_feature_t fidx, common::Span<Entry const> column);
 };
 
 /**
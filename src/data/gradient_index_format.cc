@@ -49,6 +49,15 @@ class GHistIndexRawFormat : public SparsePageFormat<GHistIndexMatrix> {
     if (is_dense) {
       page->index.SetBinOffset(page->cut.Ptrs());
     }
+    bool is_packed = false;
+    if (!fi->Read(&is_packed)) {
+      return false;
+    }
+    page->index.Unpack();
+    if (is_packed) {
+      CHECK(is_dense);
+      page->index.Pack(page->cut.Ptrs(), true);
+    }
 
     page->ReadColumnPage(fi);
     return true;
@@ -82,6 +91,8 @@ class GHistIndexRawFormat : public SparsePageFormat<GHistIndexMatrix> {
     bytes += sizeof(page.base_rowid);
     fo->Write(page.IsDense());
     bytes += sizeof(page.IsDense());
+    fo->Write(page.index.IsPacked());
+    bytes += sizeof(page.index.IsPacked());
 
     bytes += page.WriteColumnPage(fo);
     return bytes;
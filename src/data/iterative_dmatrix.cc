@@ -146,7 +146,7 @@ void IterativeDMatrix::InitFromCPU(Context const* ctx, BatchParam const& p,
         for (size_t j = 0; j < line.Size(); ++j) {
           data::COOTuple const& elem = line.GetElement(j);
           if (is_valid(elem)) {
-            view(omp_get_thread_num(), elem.column_idx)++;
+            view(common::ThreadIdx(), elem.column_idx)++;
           }
         }
       });
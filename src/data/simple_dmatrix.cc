@@ -164,7 +164,13 @@ BatchSet<GHistIndexMatrix> SimpleDMatrix::GetGradientIndex(Context const* ctx,
     }
     CHECK(!detail::RegenGHist(batch_param_, param)) << "Inconsistent sparse threshold.";
   }
-  if (!gradient_index_ || detail::RegenGHist(batch_param_, param)) {
+  if (gradient_index_ && detail::RebinGHist(batch_param_, param)) {
+    auto cpu_ctx = ctx->MakeCPU();
+    auto n_rebinned =
+        gradient_index_->Rebin(&cpu_ctx, this, param.hess, param.rebin_tolerance);
+    LOG(DEBUG) << "Re-binned " << n_rebinned << " features of the Gradient Index.";
+    batch_param_ = param.MakeCache();
+  } else if (!gradient_index_ || detail::RegenGHist(batch_param_, param)) {
     // GIDX page doesn't exist, generate it
     LOG(DEBUG) << "Generating new Gradient Index.";
     // These places can ask for a CSR gidx:
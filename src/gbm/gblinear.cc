@@ -8,11 +8,12 @@
 #include <dmlc/omp.h>
 #include <dmlc/parameter.h>
 
-#include <vector>
-#include <string>
-#include <sstream>
 #include <algorithm>
+#include <any>  // for any_cast
 #include <numeric>
+#include <sstream>
+#include <string>
+#include <vector>
 
 #include "xgboost/gbm.h"
 #include "xgboost/json.h"
@@ -26,6 +27,9 @@
 #include "../common/timer.h"
 #include "../common/common.h"
 #include "../common/threading_utils.h"
+#include "../data/adapter.h"          // for DenseAdapter, ArrayAdapter, IsValidFunctor
+#include "../data/array_interface.h"  // for DispatchDType
+#include "../data/proxy_dmatrix.h"    // for DMatrixProxy
 
 namespace xgboost {
 namespace gbm {
@@ -66,6 +70,96 @@ void LinearCheckLayer(unsigned layer_begin) {
   CHECK_EQ(layer_begin, 0) << "Linear booster does not support prediction range.";
 }
 
+namespace {
+// Number of rows processed by each task in the prediction kernels.
+constexpr std::size_t kBlockOfRowsSize = 64;
+// Number of independent partial sums in the dense dot product.  Splitting the reduction
+// allows the compiler to vectorize the inner loop without reassociating floating point
+// operations.
+constexpr std::size_t kDenseLanes = 8;
+
+/**
+ * \brief Accumulate a sparse row into all output groups with a single pass over the
+ *        entries.
+ */
+void AccumulateRow(GBLinearModel const &model, SparsePage::Inst const &inst,
+                   common::Span<float> out_row) {
+  auto n_features = model.learner_model_param->num_feature;
+  for (auto const &e : inst) {
+    if (e.index >= n_features) {
+      continue;
+    }
+    auto w = model[e.index];
+    for (std::size_t gid = 0; gid < out_row.size(); ++gid) {
+      out_row[gid] += e.fvalue * w[gid];
+    }
+  }
+}
+
+/**
+ * \brief Accumulate a row from an adapter batch, used for the sparse and strided inputs.
+ */
+template <typename Line>
+void AccumulateLine(GBLinearModel const &model, Line const &line,
+                    data::IsValidFunctor const &is_valid, common::Span<float> out_row) {
+  auto n_features = model.learner_model_param->num_feature;
+  for (std::size_t j = 0; j < line.Size(); ++j) {
+    auto e = line.GetElement(j);
+    if (!is_valid(e) || e.column_idx >= n_features) {
+      continue;
+    }
+    auto w = model[e.column_idx];
+    for (std::size_t gid = 0; gid < out_row.size(); ++gid) {
+      out_row[gid] += e.value * w[gid];
+    }
+  }
+}
+
+/**
+ * \brief Accumulate a row of a c-contiguous dense matrix.
+ *
+ *   Missing values are masked instead of skipped so that the single output case is a
+ *   branch free dot product.
+ */
+template <typename T>
+void AccumulateDenseRow(GBLinearModel const &model, T const *row,
+                        data::IsValidFunctor const &is_valid, common::Span<float> out_row) {
+  std::size_t n_features = model.learner_model_param->num_feature;
+  if (out_row.size() == 1) {
+    float const *w = model[0];
+    float acc[kDenseLanes]{0};
+    std::size_t j = 0;
+    for (; j + kDenseLanes <= n_features; j += kDenseLanes) {
+      for (std::size_t k = 0; k < kDenseLanes; ++k) {
+        auto v = static_cast<float>(row[j + k]);
+        acc[k] += is_valid(v) ? v * w[j + k] : 0.0f;
+      }
+    }
+    float psum = out_row[0];
+    for (; j < n_features; ++j) {
+      auto v = static_cast<float>(row[j]);
+      psum += is_valid(v) ? v * w[j] : 0.0f;
+    }
+    for (auto v : acc) {
+      psum += v;
+    }
+    out_row[0] = psum;
+    return;
+  }
+
+  for (std::size_t j = 0; j < n_features; ++j) {
+    auto v = static_cast<float>(row[j]);
+    if (!is_valid(v)) {
+      continue;
+    }
+    auto w = model[j];
+    for (std::size_t gid = 0; gid < out_row.size(); ++gid) {
+      out_row[gid] += v * w[gid];
+    }
+  }
+}
+}  // anonymous namespace
+
 /*!
  * \brief gradient boosted linear model
  */
@@ -155,6 +249,74 @@ class GBLinear : public GradientBooster {
     this->PredictBatchInternal(p_fmat, &out_preds->HostVector());
     monitor_.Stop("PredictBatch");
   }
+  void PredictBatchNoCache(DMatrix *p_fmat, PredictionCacheEntry *predts,
+                           bst_layer_t layer_begin, bst_layer_t) const override {
+    LinearCheckLayer(layer_begin);
+    CHECK(!model_.weight.empty()) << "Model is not initialized";
+    this->PredictBatchKernel(p_fmat, &predts->predictions.HostVector());
+  }
+
+  void InplacePredict(std::shared_ptr<DMatrix> p_m, float missing, PredictionCacheEntry *out_preds,
+                      bst_layer_t layer_begin, bst_layer_t) const override {
+    LinearCheckLayer(layer_begin);
+    CHECK(!model_.weight.empty()) << "Model is not initialized";
+    auto proxy = dynamic_cast<data::DMatrixProxy *>(p_m.get());
+    CHECK(proxy) << "Inplace predict accepts only DMatrixProxy as input.";
+    CHECK_EQ(proxy->DeviceIdx(), Context::kCpuId)
+        << "gblinear doesn't support inplace prediction for data on device.";
+    CHECK(!p_m->Info().IsColumnSplit())
+        << "Inplace predict support for column-wise data split is not yet implemented.";
+
+    auto base_margin = p_m->Info().base_margin_.View(Context::kCpuId);
+    auto base_score = learner_model_param_->BaseScore(Context::kCpuId)(0);
+    data::IsValidFunctor is_valid{missing};
+    auto predict = [&](std::size_t n_rows, std::size_t n_columns, auto &&accumulate) {
+      CHECK_EQ(n_columns, learner_model_param_->num_feature)
+          << "Number of columns in data must equal to trained model.";
+      p_m->Info().num_row_ = n_rows;
+      auto &preds = out_preds->predictions.HostVector();
+      preds.resize(n_rows * learner_model_param_->num_output_group);
+      this->PredictByBlockOfRows(model_, n_rows, 0, base_margin, base_score, preds, accumulate);
+    };
+    auto predict_lines = [&](auto const &batch, std::size_t n_rows, std::size_t n_columns) {
+      predict(n_rows, n_columns, [&](std::size_t i, common::Span<float> out_row) {
+        AccumulateLine(model_, batch.GetLine(i), is_valid, out_row);
+      });
+    };
+
+    auto x = proxy->Adapter();
+    if (x.type() == typeid(std::shared_ptr<data::DenseAdapter>)) {
+      auto adapter = std::any_cast<std::shared_ptr<data::DenseAdapter>>(x);
+      auto values = adapter->Value().Values();
+      auto n_columns = adapter->NumColumns();
+      predict(adapter->NumRows(), n_columns, [&](std::size_t i, common::Span<float> out_row) {
+        AccumulateDenseRow(model_, values.data() + i * n_columns, is_valid, out_row);
+      });
+    } else if (x.type() == typeid(std::shared_ptr<data::ArrayAdapter>)) {
+      auto adapter = std::any_cast<std::shared_ptr<data::ArrayAdapter>>(x);
+      auto const &array = adapter->Value().Interface();
+      if (array.Stride(1) == 1) {
+        // Hoist the type dispatching out of the kernel for contiguous rows.
+        DispatchDType(array, Context::kCpuId, [&](auto t) {
+          predict(adapter->NumRows(), adapter->NumColumns(),
+                  [&](std::size_t i, common::Span<float> out_row) {
+                    AccumulateDenseRow(model_, &t(i, 0), is_valid, out_row);
+                  });
+        });
+      } else {
+        predict_lines(adapter->Value(), adapter->NumRows(), adapter->NumColumns());
+      }
+    } else if (x.type() == typeid(std::shared_ptr<data::CSRAdapter>)) {
+      auto adapter = std::any_cast<std::shared_ptr<data::CSRAdapter>>(x);
+      predict_lines(adapter->Value(), adapter->NumRows(), adapter->NumColumns());
+    } else if (x.type() == typeid(std::shared_ptr<data::CSRArrayAdapter>)) {
+      auto adapter = std::any_cast<std::shared_ptr<data::CSRArrayAdapter>>(x);
+      predict_lines(adapter->Value(), adapter->NumRows(), adapter->NumColumns());
+    } else {
+      LOG(FATAL) << "Unsupported data type for inplace predict.";
+    }
+  }
+
   // add base margin
   void PredictInstance(const SparsePage::Inst& inst, std::vector<bst_float>* out_preds,
                        uint32_t layer_begin, uint32_t) override {
@@ -264,10 +426,53 @@ class GBLinear : public GradientBooster {
   }
 
  protected:
+  /**
+   * \brief Blocked prediction kernel shared by batch and inplace prediction.
+   *
+   *   Rows are partitioned into blocks of `kBlockOfRowsSize` and the output of each row is
+   *   initialized with the bias and base margin before `accumulate` adds the linear terms
+   *   for all output groups.
+   *
+   * \param base_rowid The global index of the first row in this batch.
+   * \param out        Output predictions with shape (n_samples, n_groups).
+   * \param accumulate Callback with signature `void(std::size_t i, Span<float> out_row)`,
+   *                   `i` is the index of the row in this batch.
+   */
+  template <typename Fn>
+  void PredictByBlockOfRows(GBLinearModel const &model, std::size_t n_rows,
+                            std::size_t base_rowid,
+                            linalg::TensorView<float const, 2> base_margin, float base_score,
+                            common::Span<float> out, Fn &&accumulate) const {
+    std::size_t n_groups = model.learner_model_param->num_output_group;
+    if (base_margin.Size() != 0) {
+      CHECK_GE(base_margin.Shape(0), base_rowid + n_rows);
+      CHECK_EQ(base_margin.Shape(1), n_groups);
+    }
+    auto n_blocks = common::DivRoundUp(n_rows, kBlockOfRowsSize);
+    common::ParallelFor(n_blocks, ctx_->Threads(), [&](std::size_t block_id) {
+      auto begin = block_id * kBlockOfRowsSize;
+      auto end = std::min(begin + kBlockOfRowsSize, n_rows);
+      for (auto i = begin; i < end; ++i) {
+        auto ridx = base_rowid + i;
+        auto out_row = out.subspan(ridx * n_groups, n_groups);
+        for (std::size_t gid = 0; gid < n_groups; ++gid) {
+          out_row[gid] = model.Bias()[gid] +
+                         ((base_margin.Size() != 0) ? base_margin(ridx, gid) : base_score);
+        }
+        accumulate(i, out_row);
+      }
+    });
+  }
+
   void PredictBatchInternal(DMatrix *p_fmat,
                             std::vector<bst_float> *out_preds) {
     monitor_.Start("PredictBatchInternal");
     model_.LazyInitModel();
+    this->PredictBatchKernel(p_fmat, out_preds);
+    monitor_.Stop("PredictBatchInternal");
+  }
+
+  void PredictBatchKernel(DMatrix *p_fmat, std::vector<bst_float> *out_preds) const {
     std::vector<bst_float> &preds = *out_preds;
     auto base_margin = p_fmat->Info().base_margin_.View(Context::kCpuId);
     // start collecting the prediction
@@ -279,21 +484,12 @@ class GBLinear : public GradientBooster {
       auto const& batch = page.GetView();
       // output convention: nrow * k, where nrow is number of rows
       // k is number of group
-      // parallel over local batch
-      const auto nsize = static_cast<omp_ulong>(batch.Size());
-      if (base_margin.Size() != 0) {
-        CHECK_EQ(base_margin.Size(), nsize * ngroup);
-      }
-      common::ParallelFor(nsize, ctx_->Threads(), [&](omp_ulong i) {
-        const size_t ridx = page.base_rowid + i;
-        // loop over output groups
-        for (int gid = 0; gid < ngroup; ++gid) {
-          float margin = (base_margin.Size() != 0) ? base_margin(ridx, gid) : base_score(0);
-          this->Pred(batch[i], &preds[ridx * ngroup], gid, margin);
-        }
-      });
+      this->PredictByBlockOfRows(model_, batch.Size(), page.base_rowid, base_margin,
+                                 base_score(0), preds,
+                                 [&](std::size_t i, common::Span<float> out_row) {
+                                   AccumulateRow(model_, batch[i], out_row);
+                                 });
     }
-    monitor_.Stop("PredictBatchInternal");
   }
 
   bool CheckConvergence() {
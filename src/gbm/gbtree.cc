@@ -608,6 +608,19 @@ void GBTree::PredictBatch(DMatrix* p_fmat, PredictionCacheEntry* out_preds, bool
   }
 }
 
+void GBTree::PredictBatchNoCache(DMatrix* p_fmat, PredictionCacheEntry* out_preds,
+                                 bst_layer_t layer_begin, bst_layer_t layer_end) const {
+  CHECK(configured_);
+  out_preds->version = 0;
+  auto const& predictor = GetPredictor(&out_preds->predictions, p_fmat);
+  predictor->InitOutPredictions(p_fmat->Info(), &out_preds->predictions, model_);
+  auto [tree_begin, tree_end] = detail::LayerToTree(model_, layer_begin, layer_end);
+  CHECK_LE(tree_end, model_.trees.size()) << "Invalid number of trees.";
+  if (tree_end > tree_begin) {
+    predictor->PredictBatch(p_fmat, out_preds, model_, tree_begin, tree_end);
+  }
+}
+
 std::unique_ptr<Predictor> const &
 GBTree::GetPredictor(HostDeviceVector<float> const *out_pred,
                      DMatrix *f_dmat) const {
@@ -760,6 +773,7 @@ class Dart : public GBTree {
     for (size_t i = 0; i < weight_drop_.size(); ++i) {
       weight_drop_[i] = get<Number const>(j_weight_drop[i]);
     }
+    tree_output_.Reset();
   }
 
   void Load(dmlc::Stream* fi) override {
@@ -768,6 +782,7 @@ class Dart : public GBTree {
     if (model_.param.num_trees != 0) {
       fi->Read(&weight_drop_);
     }
+    tree_output_.Reset();
   }
   void Save(dmlc::Stream* fo) const override {
     GBTree::Save(fo);
@@ -847,12 +862,105 @@ class Dart : public GBTree {
     }
   }
 
+  /**
+   * \brief Predict the training DMatrix using cached output of each tree.
+   *
+   *   Only the newly added trees are evaluated by the predictor, trees with changed weight
+   *   are applied to the weighted sum incrementally and the dropped trees are subtracted
+   *   from it.
+   */
+  void PredictBatchCached(DMatrix* p_fmat, PredictionCacheEntry* p_out_preds) {
+    CHECK(!this->model_.learner_model_param->IsVectorLeaf()) << "dart" << MTNotImplemented();
+    auto& predictor = this->GetPredictor(&p_out_preds->predictions, p_fmat);
+    CHECK(predictor);
+    predictor->InitOutPredictions(p_fmat->Info(), &p_out_preds->predictions, model_);
+    p_out_preds->version = 0;
+
+    auto n_groups = model_.learner_model_param->num_output_group;
+    auto n_rows = p_fmat->Info().num_row_;
+    auto n_trees = static_cast<bst_tree_t>(model_.trees.size());
+    auto& cache = tree_output_;
+    // An expired reference means the cached DMatrix is freed, a new DMatrix might be
+    // allocated at the same address.
+    if (cache.ref.expired() || cache.ref.lock().get() != p_fmat || cache.n_rows != n_rows ||
+        cache.Size() > n_trees) {
+      cache.Reset();
+      cache.ref = p_out_preds->ref;
+      cache.n_rows = n_rows;
+      cache.weighted_sum.resize(n_rows * n_groups, 0.0);
+    }
+
+    // Evaluate new trees.
+    if (cache.Size() < n_trees) {
+      PredictionCacheEntry predts;
+      predts.predictions.Resize(n_rows * n_groups, 0);
+      cache.tree_output.resize(static_cast<std::size_t>(n_trees) * n_rows);
+      for (bst_tree_t i = cache.Size(); i < n_trees; ++i) {
+        predts.predictions.Fill(0);
+        predictor->PredictBatch(p_fmat, &predts, model_, i, i + 1);
+        auto const& h_predts = predts.predictions.ConstHostVector();
+        auto group = model_.tree_info.at(i);
+        auto h_tree_output = common::Span<float>{cache.tree_output}.subspan(i * n_rows, n_rows);
+        common::ParallelFor(n_rows, ctx_->Threads(), [&](auto ridx) {
+          h_tree_output[ridx] = h_predts[ridx * n_groups + group];
+        });
+      }
+      // The weight of a new tree is accumulated as a change from 0.
+      cache.weights.resize(n_trees, 0.0f);
+    }
+
+    // Apply the changed weights to the sum.
+    for (bst_tree_t i = 0; i < n_trees; ++i) {
+      auto w = weight_drop_.at(i);
+      if (w == cache.weights[i]) {
+        continue;
+      }
+      auto delta = static_cast<double>(w) - cache.weights[i];
+      auto group = model_.tree_info[i];
+      auto h_tree_output = common::Span<float const>{cache.tree_output}.subspan(i * n_rows, n_rows);
+      common::ParallelFor(n_rows, ctx_->Threads(), [&](auto ridx) {
+        cache.weighted_sum[ridx * n_groups + group] += delta * h_tree_output[ridx];
+      });
+      cache.weights[i] = w;
+    }
+
+    // Subtract the dropped trees.
+    auto& h_out_predts = p_out_preds->predictions.HostVector();
+    CHECK_EQ(h_out_predts.size(), cache.weighted_sum.size());
+    common::ParallelFor(n_rows, ctx_->Threads(), [&](auto ridx) {
+      auto offset = ridx * n_groups;
+      for (std::size_t gidx = 0; gidx < n_groups; ++gidx) {
+        double predt = cache.weighted_sum[offset + gidx];
+        for (auto i : idx_drop_) {
+          if (model_.tree_info[i] == static_cast<int>(gidx)) {
+            predt -= static_cast<double>(weight_drop_[i]) * cache.tree_output[i * n_rows + ridx];
+          }
+        }
+        h_out_predts[offset + gidx] += static_cast<float>(predt);
+      }
+    });
+  }
+
   void PredictBatch(DMatrix* p_fmat, PredictionCacheEntry* p_out_preds, bool training,
                     bst_layer_t layer_begin, bst_layer_t layer_end) override {
     DropTrees(training);
+    auto [tree_begin, tree_end] = detail::LayerToTree(model_, layer_begin, layer_end);
+    // The cache is keyed by the DMatrix referenced by the prediction cache entry.
+    auto p_ref = p_out_preds->ref.lock();
+    if (training && dparam_.cache_tree_output && ctx_->IsCPU() && p_ref.get() == p_fmat &&
+        tree_begin == 0 && tree_end == static_cast<bst_tree_t>(model_.trees.size())) {
+      this->PredictBatchCached(p_fmat, p_out_preds);
+      return;
+    }
     this->PredictBatchImpl(p_fmat, p_out_preds, training, layer_begin, layer_end);
   }
 
+  void PredictBatchNoCache(DMatrix* p_fmat, PredictionCacheEntry* p_out_preds,
+                           bst_layer_t layer_begin, bst_layer_t layer_end) const override {
+    // Inference doesn't drop trees.
+    this->PredictBatchImpl(p_fmat, p_out_preds, false, layer_begin, layer_end);
+  }
+
   void InplacePredict(std::shared_ptr<DMatrix> p_fmat, float missing,
                       PredictionCacheEntry* p_out_preds, bst_layer_t layer_begin,
                       bst_layer_t layer_end) const override {
@@ -960,6 +1068,10 @@ class Dart : public GBTree {
  protected:
   // commit new trees all at once
   void CommitModel(TreesOneIter&& new_trees) override {
+    if (tparam_.process_type == TreeProcessType::kUpdate) {
+      // Existing trees are modified, outputs of them are no longer valid.
+      tree_output_.Reset();
+    }
     auto n_new_trees = model_.CommitModel(std::forward<TreesOneIter>(new_trees));
     size_t num_drop = NormalizeTrees(n_new_trees);
     LOG(INFO) << "drop " << num_drop << " trees, "
@@ -1070,6 +1182,28 @@ class Dart : public GBTree {
   std::vector<size_t> idx_drop_;
   // temporal storage for per thread
   std::vector<RegTree::FVec> thread_temp_;
+
+  /**
+   * \brief Output of each tree on the training DMatrix.
+   *
+   *   Dropped trees change in every iteration, without the cache the whole ensemble needs
+   *   to be predicted again for each boosting round.
+   */
+  struct TreeOutputCache {
+    // Same as the prediction cache, a weak reference detects that the DMatrix is freed.
+    std::weak_ptr<DMatrix> ref;
+    bst_row_t n_rows{0};
+    // raw output of each tree, stored as [tree][row]
+    std::vector<float> tree_output;
+    // weights of trees that have been accumulated into `weighted_sum`
+    std::vector<float> weights;
+    // sum of weighted tree outputs, stored as [row][group]
+    std::vector<double> weighted_sum;
+
+    bst_tree_t Size() const { return static_cast<bst_tree_t>(weights.size()); }
+    void Reset() { *this = TreeOutputCache{}; }
+  };
+  TreeOutputCache tree_output_;
 };
 
 // register the objective functions
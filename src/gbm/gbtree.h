@@ -111,6 +111,8 @@ struct DartTrainParam : public XGBoostParameter<DartTrainParam> {
   bool one_drop;
   /*! \brief probability of skipping the dropout during an iteration */
   float skip_drop;
+  /*! \brief whether to cache the output of each tree on the training data */
+  bool cache_tree_output;
   // declare parameters
   DMLC_DECLARE_PARAMETER(DartTrainParam) {
     DMLC_DECLARE_FIELD(sample_type)
@@ -134,6 +136,11 @@ struct DartTrainParam : public XGBoostParameter<DartTrainParam> {
         .set_range(0.0f, 1.0f)
         .set_default(0.0f)
         .describe("Probability of skipping the dropout during a boosting iteration.");
+    DMLC_DECLARE_FIELD(cache_tree_output)
+        .set_default(false)
+        .describe("Cache the output of each tree on the training data so that only the dropped "
+                  "and the re-weighted trees are evaluated in each boosting iteration.  Requires "
+                  "memory proportional to the number of training rows times the number of trees.");
   }
 };
 
@@ -248,6 +255,8 @@ class GBTree : public GradientBooster {
 
   void PredictBatch(DMatrix* p_fmat, PredictionCacheEntry* out_preds, bool training,
                     bst_layer_t layer_begin, bst_layer_t layer_end) override;
+  void PredictBatchNoCache(DMatrix* p_fmat, PredictionCacheEntry* out_preds,
+                           bst_layer_t layer_begin, bst_layer_t layer_end) const override;
 
   void InplacePredict(std::shared_ptr<DMatrix> p_m, float missing, PredictionCacheEntry* out_preds,
                       bst_layer_t layer_begin, bst_layer_t layer_end) const override {
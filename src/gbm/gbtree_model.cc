@@ -5,11 +5,13 @@
 
 #include <algorithm>                    // for transform, max_element
 #include <cstddef>                      // for size_t
+#include <memory>                       // for shared_ptr, make_shared, atomic_load, atomic_store
 #include <numeric>                      // for partial_sum
 #include <ostream>                      // for operator<<, basic_ostream
 #include <utility>                      // for move, pair
 
 #include "../common/threading_utils.h"  // for ParallelFor
+#include "../predictor/cpu_treeshap.h"  // for TreeShapPaths
 #include "dmlc/base.h"                  // for BeginPtr
 #include "dmlc/io.h"                    // for Stream
 #include "xgboost/context.h"            // for Context
@@ -83,6 +85,7 @@ void GBTreeModel::Load(dmlc::Stream* fi) {
   }
   trees.clear();
   trees_to_update.clear();
+  this->ResetShapCache();
   for (int32_t i = 0; i < param.num_trees; ++i) {
     std::unique_ptr<RegTree> ptr(new RegTree());
     ptr->Load(fi);
@@ -140,6 +143,7 @@ void GBTreeModel::LoadModel(Json const& in) {
 
   trees.clear();
   trees_to_update.clear();
+  this->ResetShapCache();
 
   auto const& jmodel = get<Object const>(in);
 
@@ -196,4 +200,19 @@ bst_tree_t GBTreeModel::CommitModel(TreesOneIter&& new_trees) {
   Validate(*this);
   return n_new_trees;
 }
+
+std::shared_ptr<TreeShapPaths const> GBTreeModel::ShapPaths(std::uint32_t tree_end) const {
+  CHECK_LE(tree_end, trees.size()) << "Invalid number of trees.";
+  auto cached = std::atomic_load(&shap_paths_);
+  bool valid = cached && cached->Match(trees);
+  if (valid && cached->NumTrees() >= tree_end) {
+    return cached;
+  }
+  // Copy the existing statistics if the model is only extended with new trees.
+  auto paths = valid ? std::make_shared<TreeShapPaths>(*cached) : std::make_shared<TreeShapPaths>();
+  paths->Extend(trees, trees.size());
+  std::shared_ptr<TreeShapPaths const> out{std::move(paths)};
+  std::atomic_store(&shap_paths_, out);
+  return out;
+}
 }  // namespace xgboost::gbm
@@ -13,12 +13,14 @@
 #include <xgboost/parameter.h>
 #include <xgboost/tree_model.h>
 
+#include <cstdint>
 #include <memory>
 #include <string>
 #include <utility>
 #include <vector>
 
 #include "../common/threading_utils.h"
+#include "../predictor/cpu_treeshap.h"
 
 namespace xgboost {
 
@@ -100,6 +102,7 @@ struct GBTreeModel : public Model {
       trees.clear();
       param.num_trees = 0;
       tree_info.clear();
+      this->ResetShapCache();
 
       iteration_indptr.clear();
       iteration_indptr.push_back(0);
@@ -134,6 +137,15 @@ struct GBTreeModel : public Model {
     param.num_trees += static_cast<int>(new_trees.size());
   }
 
+  /**
+   * \brief Get the cached tree statistics for feature contributions, which cover at least
+   *        the first `tree_end` trees.  The cache is extended as new trees are committed.
+   */
+  [[nodiscard]] std::shared_ptr<TreeShapPaths const> ShapPaths(std::uint32_t tree_end) const;
+  void ResetShapCache() {
+    std::atomic_store(&shap_paths_, std::shared_ptr<TreeShapPaths const>{});
+  }
+
   [[nodiscard]] std::int32_t BoostedRounds() const {
     if (trees.empty()) {
       CHECK_EQ(iteration_indptr.size(), 1);
@@ -163,6 +175,8 @@ struct GBTreeModel : public Model {
    * \brief Whether the stack contains multi-target tree.
    */
   Context const* ctx_;
+  // Immutable snapshot shared with running predictions, replaced when the model changes.
+  mutable std::shared_ptr<TreeShapPaths const> shap_paths_;
 };
 }  // namespace gbm
 }  // namespace xgboost
@@ -40,11 +40,13 @@
 #include "common/api_entry.h"             // for XGBAPIThreadLocalEntry
 #include "common/charconv.h"              // for to_chars, to_chars_result, NumericLimits, from_...
 #include "common/common.h"                // for ToString, Split
+#include "common/hash.h"                  // for HashBytes, HashCombine
 #include "common/io.h"                    // for PeekableInStream, ReadAll, FixedSizeStream, Mem...
 #include "common/observer.h"              // for TrainingObserver
 #include "common/random.h"                // for GlobalRandom
 #include "common/timer.h"                 // for Monitor
 #include "common/version.h"               // for Version
+#include "data/gradient_index.h"          // for GHistIndexMatrix
 #include "dmlc/endian.h"                  // for ByteSwap, DMLC_IO_NO_ENDIAN_SWAP
 #include "xgboost/base.h"                 // for Args, bst_float, GradientPair, bst_feature_t, ...
 #include "xgboost/context.h"              // for Context
@@ -78,6 +80,42 @@ T& UsePtr(T& ptr) {  // NOLINT
   CHECK(ptr);
   return ptr;
 }
+
+template <typename T>
+std::uint64_t HashVec(std::vector<T> const& vec, std::int32_t n_threads, std::uint64_t seed) {
+  return common::HashBytes(common::Span<T const>{vec.data(), vec.size()}, n_threads, seed);
+}
+
+/**
+ * \brief Hash the content of a DMatrix that affects prediction.  The result is used for
+ *        checking an imported prediction cache belongs to the DMatrix.
+ */
+std::string HashDMatrix(Context const* ctx, DMatrix* p_fmat) {
+  auto const& info = p_fmat->Info();
+  auto n_threads = ctx->Threads();
+  auto h = common::HashCombine(info.num_row_, info.num_col_);
+  h = HashVec(info.base_margin_.Data()->ConstHostVector(), n_threads, h);
+
+  if (p_fmat->SparsePageExists()) {
+    for (auto const& page : p_fmat->GetBatches<SparsePage>()) {
+      h = common::HashCombine(h, page.base_rowid);
+      h = HashVec(page.offset.ConstHostVector(), n_threads, h);
+      h = HashVec(page.data.ConstHostVector(), n_threads, h);
+    }
+  } else {
+    // QuantileDMatrix doesn't keep the raw data, use the quantized one instead.
+    for (auto const& page : p_fmat->GetBatches<GHistIndexMatrix>(ctx, BatchParam{})) {
+      h = common::HashCombine(h, page.base_rowid);
+      h = HashVec(page.cut.Values(), n_threads, h);
+      h = HashVec(page.row_ptr, n_threads, h);
+      auto const& index = page.index;
+      h = common::HashBytes(
+          common::Span<std::uint8_t const>{index.data<std::uint8_t>(), index.SizeBytes()},
+          n_threads, h);
+    }
+  }
+  return std::to_string(h);
+}
 }  // anonymous namespace
 
 /*! \brief training parameter for regression
@@ -1424,6 +1462,103 @@ class LearnerImpl : public LearnerIO {
     *out_preds = &out_predictions.predictions;
   }
 
+  std::shared_ptr<InferenceSnapshot const> Snapshot() override;
+
+  void ExportPredictionCache(std::shared_ptr<DMatrix> data, Json* p_out) override {
+    this->Configure();
+    this->CheckModelInitialized();
+
+    auto& predt = prediction_container_.Cache(data, ctx_.gpu_id);
+    this->PredictRaw(data.get(), &predt, false, 0, 0);
+    auto const& h_predt = predt.predictions.ConstHostVector();
+
+    auto& out = *p_out;
+    out = Object{};
+    out["version"] = Integer{static_cast<Integer::Int>(predt.version)};
+    out["num_row"] = Integer{static_cast<Integer::Int>(data->Info().num_row_)};
+    out["num_output"] = Integer{static_cast<Integer::Int>(learner_model_param_.OutputLength())};
+    out["data_hash"] = String{HashDMatrix(&ctx_, data.get())};
+    F32Array j_predt{h_predt.size()};
+    std::copy(h_predt.cbegin(), h_predt.cend(), j_predt.GetArray().begin());
+    out["predictions"] = std::move(j_predt);
+  }
+
+  void ImportPredictionCache(std::shared_ptr<DMatrix> data, Json const& in) override {
+    this->Configure();
+    this->CheckModelInitialized();
+
+    auto version = get<Integer const>(in["version"]);
+    CHECK_GE(version, 0);
+    CHECK_LE(version, this->BoostedRounds())
+        << "The prediction cache contains more boosted rounds than the model.";
+    CHECK_EQ(get<Integer const>(in["num_row"]),
+             static_cast<Integer::Int>(data->Info().num_row_))
+        << "The prediction cache doesn't match the DMatrix.";
+    CHECK_EQ(get<Integer const>(in["num_output"]),
+             static_cast<Integer::Int>(learner_model_param_.OutputLength()))
+        << "The prediction cache doesn't match the model.";
+    CHECK_EQ(get<String const>(in["data_hash"]), HashDMatrix(&ctx_, data.get()))
+        << "The prediction cache doesn't match the DMatrix.";
+
+    auto& predt = prediction_container_.Cache(data, ctx_.gpu_id);
+    auto n = data->Info().num_row_ * learner_model_param_.OutputLength();
+    predt.predictions.Resize(n);
+    auto& h_predt = predt.predictions.HostVector();
+    auto const& j_predt = in["predictions"];
+    if (IsA<F32Array>(j_predt)) {
+      // UBJSON
+      auto const& array = get<F32Array const>(j_predt);
+      CHECK_EQ(array.size(), n);
+      std::copy(array.cbegin(), array.cend(), h_predt.begin());
+    } else {
+      // JSON
+      auto const& array = get<Array const>(j_predt);
+      CHECK_EQ(array.size(), n);
+      std::transform(array.cbegin(), array.cend(), h_predt.begin(), [](Json const& v) {
+        return IsA<Number>(v) ? get<Number const>(v) : static_cast<float>(get<Integer const>(v));
+      });
+    }
+    predt.version = static_cast<std::uint32_t>(version);
+  }
+
+  /**
+   * \brief Prediction used by the inference snapshot.  Doesn't touch the prediction cache
+   *        nor the configuration, the learner must be configured beforehand.
+   */
+  void PredictNoCache(std::shared_ptr<DMatrix> data, bool output_margin,
+                      HostDeviceVector<bst_float>* out_preds, bst_layer_t layer_begin,
+                      bst_layer_t layer_end) const {
+    CHECK(!this->need_configuration_);
+    CHECK(gbm_ != nullptr) << "Predict must happen after Load or configuration";
+    this->CheckModelInitialized();
+    this->ValidateDMatrix(data.get(), false);
+
+    PredictionCacheEntry predts;
+    gbm_->PredictBatchNoCache(data.get(), &predts, layer_begin, layer_end);
+    *out_preds = std::move(predts.predictions);
+    if (!output_margin) {
+      obj_->PredTransform(out_preds);
+    }
+  }
+
+  void InplacePredictNoCache(std::shared_ptr<DMatrix> p_m, PredictionType type, float missing,
+                             HostDeviceVector<bst_float>* out_preds, bst_layer_t layer_begin,
+                             bst_layer_t layer_end) const {
+    CHECK(!this->need_configuration_);
+    this->CheckModelInitialized();
+
+    PredictionCacheEntry predts;
+    this->gbm_->InplacePredict(p_m, missing, &predts, layer_begin, layer_end);
+    *out_preds = std::move(predts.predictions);
+    if (type == PredictionType::kValue) {
+      obj_->PredTransform(out_preds);
+    } else if (type == PredictionType::kMargin) {
+      // do nothing
+    } else {
+      LOG(FATAL) << "Unsupported prediction type:" << static_cast<int>(type);
+    }
+  }
+
   void CalcFeatureScore(std::string const& importance_type, common::Span<int32_t const> trees,
                         std::vector<bst_feature_t>* features, std::vector<float>* scores) override {
     this->Configure();
@@ -1492,6 +1627,51 @@ class LearnerImpl : public LearnerIO {
 
 constexpr int32_t LearnerImpl::kRandSeedMagic;
 
+/**
+ * \brief Snapshot holding a private copy of the learner.  Nothing outside of this class
+ *        can reach the copy, so the const prediction methods need no synchronization.
+ */
+class InferenceSnapshotImpl : public InferenceSnapshot {
+  std::unique_ptr<LearnerImpl const> learner_;
+
+ public:
+  explicit InferenceSnapshotImpl(std::unique_ptr<LearnerImpl const> learner)
+      : learner_{std::move(learner)} {}
+
+  void Predict(std::shared_ptr<DMatrix> data, bool output_margin,
+               HostDeviceVector<bst_float>* out_preds, bst_layer_t layer_begin,
+               bst_layer_t layer_end) const override {
+    learner_->PredictNoCache(std::move(data), output_margin, out_preds, layer_begin, layer_end);
+  }
+  void InplacePredict(std::shared_ptr<DMatrix> p_m, PredictionType type, float missing,
+                      HostDeviceVector<bst_float>* out_preds, bst_layer_t layer_begin,
+                      bst_layer_t layer_end) const override {
+    learner_->InplacePredictNoCache(std::move(p_m), type, missing, out_preds, layer_begin,
+                                    layer_end);
+  }
+  [[nodiscard]] std::uint32_t Groups() const override { return learner_->Groups(); }
+  [[nodiscard]] std::int32_t BoostedRounds() const override {
+    return learner_->BoostedRounds();
+  }
+};
+
+std::shared_ptr<InferenceSnapshot const> LearnerImpl::Snapshot() {
+  this->Configure();
+  this->CheckModelInitialized();
+
+  Json model{Object()};
+  this->SaveModel(&model);
+  Json config{Object()};
+  this->SaveConfig(&config);
+
+  auto out_impl = std::make_unique<LearnerImpl>(std::vector<std::shared_ptr<DMatrix>>{});
+  out_impl->LoadModel(model);
+  out_impl->LoadConfig(config);
+  out_impl->Configure();
+  CHECK(!out_impl->need_configuration_);
+  return std::make_shared<InferenceSnapshotImpl>(std::move(out_impl));
+}
+
 Learner* Learner::Create(
     const std::vector<std::shared_ptr<DMatrix> >& cache_data) {
   return new LearnerImpl(cache_data);
@@ -13,6 +13,7 @@
 #include "xgboost/parameter.h"
 #include "./param.h"
 #include "../gbm/gblinear_model.h"
+#include "../common/common.h"
 #include "../common/random.h"
 #include "../common/threading_utils.h"
 
@@ -67,6 +68,100 @@ inline double CoordinateDeltaBias(double sum_grad, double sum_hess) {
   return -sum_grad / sum_hess;
 }
 
+/**
+ * \brief Columns shorter than this are processed by a single thread.  Opening a parallel
+ *        region costs more than walking a short column, which is the common case for wide
+ *        sparse data.
+ */
+constexpr std::size_t kMinParallelColumnSize = static_cast<std::size_t>(1) << 14;
+
+/**
+ * \brief Partition a column into one block per thread, results of each block are written
+ *        to its own slot to avoid false sharing and to keep the reduction order fixed.
+ */
+template <typename Fn>
+void ParallelForColumnBlocks(Context const *ctx, std::size_t n, Fn &&fn) {
+  auto n_blocks = static_cast<std::size_t>(std::max(ctx->Threads(), 1));
+  auto block_size = common::DivRoundUp(n, n_blocks);
+  common::ParallelFor(n_blocks, ctx->Threads(), [&](std::size_t block_idx) {
+    auto begin = std::min(block_idx * block_size, n);
+    auto end = std::min(begin + block_size, n);
+    fn(block_idx, begin, end);
+  });
+}
+
+/**
+ * \brief Get the gradient with respect to a single feature from one column of a CSC page.
+ *
+ * \param group_idx Zero-based index of the group.
+ * \param num_group Number of groups.
+ * \param col       The column of target feature.
+ * \param gpair     Gradients.
+ *
+ * \return  The gradient and diagonal Hessian entry for a given feature.
+ */
+inline std::pair<double, double> GetColumnGradient(Context const *ctx, int group_idx,
+                                                   int num_group, common::Span<Entry const> col,
+                                                   std::vector<GradientPair> const &gpair) {
+  auto accumulate = [&](std::size_t begin, std::size_t end) {
+    double sum_grad = 0.0, sum_hess = 0.0;
+    for (std::size_t j = begin; j < end; ++j) {
+      const bst_float v = col[j].fvalue;
+      auto &p = gpair[col[j].index * num_group + group_idx];
+      if (p.GetHess() < 0.0f) continue;
+      sum_grad += p.GetGrad() * v;
+      sum_hess += p.GetHess() * v * v;
+    }
+    return std::make_pair(sum_grad, sum_hess);
+  };
+  if (col.size() < kMinParallelColumnSize || ctx->Threads() == 1) {
+    return accumulate(0, col.size());
+  }
+
+  std::vector<std::pair<double, double>> sums(std::max(ctx->Threads(), 1));
+  ParallelForColumnBlocks(ctx, col.size(), [&](std::size_t block_idx, std::size_t begin,
+                                               std::size_t end) {
+    sums[block_idx] = accumulate(begin, end);
+  });
+  double sum_grad = 0.0, sum_hess = 0.0;
+  for (auto const &s : sums) {
+    sum_grad += s.first;
+    sum_hess += s.second;
+  }
+  return std::make_pair(sum_grad, sum_hess);
+}
+
+/**
+ * \brief Updates the gradient vector with respect to a change in weight using one column of
+ *        a CSC page.
+ *
+ * \param group_idx Zero-based index of the group.
+ * \param num_group Number of groups.
+ * \param dw        The change in weight.
+ * \param col       The column of target feature.
+ * \param in_gpair  The gradient vector to be updated.
+ */
+inline void UpdateColumnResidual(Context const *ctx, int group_idx, int num_group, float dw,
+                                 common::Span<Entry const> col,
+                                 std::vector<GradientPair> *in_gpair) {
+  if (dw == 0.0f) return;
+  auto update = [&](std::size_t begin, std::size_t end) {
+    for (std::size_t j = begin; j < end; ++j) {
+      GradientPair &p = (*in_gpair)[col[j].index * num_group + group_idx];
+      if (p.GetHess() < 0.0f) continue;
+      p += GradientPair(p.GetHess() * col[j].fvalue * dw, 0);
+    }
+  };
+  if (col.size() < kMinParallelColumnSize || ctx->Threads() == 1) {
+    update(0, col.size());
+    return;
+  }
+  ParallelForColumnBlocks(ctx, col.size(),
+                          [&](std::size_t, std::size_t begin, std::size_t end) {
+                            update(begin, end);
+                          });
+}
+
 /**
  * \brief Get the gradient with respect to a single feature.
  *
@@ -113,28 +208,13 @@ inline std::pair<double, double> GetGradientParallel(Context const *ctx, int gro
                                                      int num_group, int fidx,
                                                      const std::vector<GradientPair> &gpair,
                                                      DMatrix *p_fmat) {
-  std::vector<double> sum_grad_tloc(ctx->Threads(), 0.0);
-  std::vector<double> sum_hess_tloc(ctx->Threads(), 0.0);
-
+  double sum_grad = 0.0, sum_hess = 0.0;
   for (const auto &batch : p_fmat->GetBatches<CSCPage>(ctx)) {
     auto page = batch.GetView();
-    auto col = page[fidx];
-    const auto ndata = static_cast<bst_omp_uint>(col.size());
-    common::ParallelFor(ndata, ctx->Threads(), [&](size_t j) {
-      const bst_float v = col[j].fvalue;
-      auto &p = gpair[col[j].index * num_group + group_idx];
-      if (p.GetHess() < 0.0f) {
-        return;
-      }
-      auto t_idx = omp_get_thread_num();
-      sum_grad_tloc[t_idx] += p.GetGrad() * v;
-      sum_hess_tloc[t_idx] += p.GetHess() * v * v;
-    });
+    auto sums = GetColumnGradient(ctx, group_idx, num_group, page[fidx], gpair);
+    sum_grad += sums.first;
+    sum_hess += sums.second;
   }
-  double sum_grad =
-      std::accumulate(sum_grad_tloc.cbegin(), sum_grad_tloc.cend(), 0.0);
-  double sum_hess =
-      std::accumulate(sum_hess_tloc.cbegin(), sum_hess_tloc.cend(), 0.0);
   return std::make_pair(sum_grad, sum_hess);
 }
 
@@ -156,7 +236,7 @@ inline std::pair<double, double> GetBiasGradientParallel(int group_idx, int num_
   std::vector<double> sum_hess_tloc(n_threads, 0);
 
   common::ParallelFor(ndata, n_threads, [&](auto i) {
-    auto tid = omp_get_thread_num();
+    auto tid = common::ThreadIdx();
     auto &p = gpair[i * num_group + group_idx];
     if (p.GetHess() >= 0.0f) {
       sum_grad_tloc[tid] += p.GetGrad();
@@ -184,14 +264,7 @@ inline void UpdateResidualParallel(Context const *ctx, bst_feature_t fidx, int g
   if (dw == 0.0f) return;
   for (const auto &batch : p_fmat->GetBatches<CSCPage>(ctx)) {
     auto page = batch.GetView();
-    auto col = page[fidx];
-    // update grad value
-    const auto num_row = static_cast<bst_omp_uint>(col.size());
-    common::ParallelFor(num_row, ctx->Threads(), [&](auto j) {
-      GradientPair &p = (*in_gpair)[col[j].index * num_group + group_idx];
-      if (p.GetHess() < 0.0f) return;
-      p += GradientPair(p.GetHess() * col[j].fvalue * dw, 0);
-    });
+    UpdateColumnResidual(ctx, group_idx, num_group, dw, page[fidx], in_gpair);
   }
 }
 
@@ -362,16 +435,29 @@ class GreedyFeatureSelector : public FeatureSelector {
         }
       });
     }
-    // Find a feature with the largest magnitude of weight change
+    // Find a feature with the largest magnitude of weight change.  Each block keeps the
+    // first feature with the largest change and the blocks are reduced in order, so the
+    // result is the same as a serial scan.
+    std::vector<std::pair<int, double>> block_best(std::max(ctx->Threads(), 1),
+                                                   std::make_pair(0, 0.0));
+    ParallelForColumnBlocks(ctx, nfeat, [&](std::size_t block_idx, std::size_t begin,
+                                            std::size_t end) {
+      auto &best = block_best[block_idx];
+      for (auto fidx = begin; fidx < end; ++fidx) {
+        auto &s = gpair_sums_[group_idx * nfeat + fidx];
+        float dw = std::abs(static_cast<bst_float>(
+            CoordinateDelta(s.first, s.second, model[fidx][group_idx], alpha, lambda)));
+        if (dw > best.second) {
+          best = std::make_pair(static_cast<int>(fidx), static_cast<double>(dw));
+        }
+      }
+    });
     int best_fidx = 0;
     double best_weight_update = 0.0f;
-    for (bst_omp_uint fidx = 0; fidx < nfeat; ++fidx) {
-      auto &s = gpair_sums_[group_idx * nfeat + fidx];
-      float dw = std::abs(static_cast<bst_float>(
-                 CoordinateDelta(s.first, s.second, model[fidx][group_idx], alpha, lambda)));
-      if (dw > best_weight_update) {
-        best_weight_update = dw;
-        best_fidx = fidx;
+    for (auto const &best : block_best) {
+      if (best.second > best_weight_update) {
+        best_weight_update = best.second;
+        best_fidx = best.first;
       }
     }
     return best_fidx;
@@ -436,20 +522,27 @@ class ThriftyFeatureSelector : public FeatureSelector {
     std::fill(deltaw_.begin(), deltaw_.end(), 0.f);
     std::iota(sorted_idx_.begin(), sorted_idx_.end(), 0);
     bst_float *pdeltaw = &deltaw_[0];
+    // Features after the top_k are never visited, only the head needs to be ordered.
+    auto n_sorted =
+        std::min(static_cast<std::size_t>(top_k_), static_cast<std::size_t>(nfeat));
     for (bst_uint gid = 0u; gid < ngroup; ++gid) {
       // Calculate univariate weight changes
-      for (bst_omp_uint i = 0; i < nfeat; ++i) {
+      common::ParallelFor(nfeat, ctx->Threads(), [&](auto i) {
         auto ii = gid * nfeat + i;
         auto &s = gpair_sums_[ii];
         deltaw_[ii] = static_cast<bst_float>(CoordinateDelta(
                        s.first, s.second, model[i][gid], alpha, lambda));
-      }
+      });
       // sort in descending order of deltaw abs values
       auto start = sorted_idx_.begin() + gid * nfeat;
-      std::sort(start, start + nfeat,
-                [pdeltaw](size_t i, size_t j) {
-                  return std::abs(*(pdeltaw + i)) > std::abs(*(pdeltaw + j));
-                });
+      auto cmp = [pdeltaw](size_t i, size_t j) {
+        return std::abs(*(pdeltaw + i)) > std::abs(*(pdeltaw + j));
+      };
+      if (n_sorted < nfeat) {
+        std::partial_sort(start, start + n_sorted, start + nfeat, cmp);
+      } else {
+        std::sort(start, start + nfeat, cmp);
+      }
       counter_[gid] = 0u;
     }
   }
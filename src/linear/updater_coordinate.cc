@@ -62,16 +62,50 @@ class CoordinateUpdater : public LinearUpdater {
     selector_->Setup(ctx_, *model, in_gpair->ConstHostVector(), p_fmat, tparam_.reg_alpha_denorm,
                      tparam_.reg_lambda_denorm, cparam_.top_k);
     // update weights
+    if (p_fmat->SingleColBlock()) {
+      // Hold on to the only column page for all features instead of requesting the batches
+      // twice for each updated feature.
+      for (auto const &batch : p_fmat->GetBatches<CSCPage>(ctx_)) {
+        auto page = batch.GetView();
+        this->UpdateWeights(p_fmat, model, in_gpair, [&](int fidx, int group_idx) {
+          this->UpdateFeature(fidx, group_idx, &in_gpair->HostVector(), page, model);
+        });
+      }
+    } else {
+      this->UpdateWeights(p_fmat, model, in_gpair, [&](int fidx, int group_idx) {
+        this->UpdateFeature(fidx, group_idx, &in_gpair->HostVector(), p_fmat, model);
+      });
+    }
+    monitor_.Stop("UpdateFeature");
+  }
+
+  template <typename Fn>
+  void UpdateWeights(DMatrix *p_fmat, gbm::GBLinearModel *model,
+                     HostDeviceVector<GradientPair> *in_gpair, Fn &&update_feature) {
+    const int ngroup = model->learner_model_param->num_output_group;
     for (int group_idx = 0; group_idx < ngroup; ++group_idx) {
       for (unsigned i = 0U; i < model->learner_model_param->num_feature; i++) {
         int fidx =
             selector_->NextFeature(ctx_, i, *model, group_idx, in_gpair->ConstHostVector(), p_fmat,
                                    tparam_.reg_alpha_denorm, tparam_.reg_lambda_denorm);
         if (fidx < 0) break;
-        this->UpdateFeature(fidx, group_idx, &in_gpair->HostVector(), p_fmat, model);
+        update_feature(fidx, group_idx);
       }
     }
-    monitor_.Stop("UpdateFeature");
+  }
+
+  void UpdateFeature(int fidx, int group_idx, std::vector<GradientPair> *in_gpair,
+                     HostSparsePageView const &page, gbm::GBLinearModel *model) {
+    const int ngroup = model->learner_model_param->num_output_group;
+    bst_float &w = (*model)[fidx][group_idx];
+    auto col = page[fidx];
+    auto gradient = GetColumnGradient(ctx_, group_idx, ngroup, col, *in_gpair);
+    auto dw = static_cast<float>(
+        tparam_.learning_rate *
+        CoordinateDelta(gradient.first, gradient.second, w, tparam_.reg_alpha_denorm,
+                        tparam_.reg_lambda_denorm));
+    w += dw;
+    UpdateColumnResidual(ctx_, group_idx, ngroup, dw, col, in_gpair);
   }
 
   void UpdateFeature(int fidx, int group_idx, std::vector<GradientPair> *in_gpair, DMatrix *p_fmat,
@@ -249,7 +249,7 @@ std::pair<double, uint32_t> RankingAUC(Context const *ctx, std::vector<float> co
         auc = 0;
       }
     }
-    auc_tloc[omp_get_thread_num()] += auc;
+    auc_tloc[common::ThreadIdx()] += auc;
   });
   double sum_auc = std::accumulate(auc_tloc.cbegin(), auc_tloc.cend(), 0.0);
 
@@ -56,7 +56,7 @@ PackedReduceResult Reduce(Context const* ctx, MetaInfo const& info, Fn&& loss) {
     // - sqrt(1/w(sum_t0 + sum_t1 + ... + sum_tm))       // multi-target
     // - sqrt(avg_t0) + sqrt(avg_t1) + ... sqrt(avg_tm)  // distributed
     common::ParallelFor(info.labels.Size(), ctx->Threads(), [&](size_t i) {
-      auto t_idx = omp_get_thread_num();
+      auto t_idx = common::ThreadIdx();
       size_t sample_id;
       size_t target_id;
       std::tie(sample_id, target_id) = linalg::UnravelIndex(i, labels.Shape());
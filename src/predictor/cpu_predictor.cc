@@ -1,15 +1,16 @@
 /**
  * Copyright 2017-2023 by XGBoost Contributors
  */
-#include <algorithm>  // for max, fill, min
-#include <any>        // for any, any_cast
-#include <cassert>    // for assert
-#include <cstddef>    // for size_t
-#include <cstdint>    // for uint32_t, int32_t, uint64_t
-#include <memory>     // for unique_ptr, shared_ptr
-#include <ostream>    // for char_traits, operator<<, basic_ostream
-#include <typeinfo>   // for type_info
-#include <vector>     // for vector
+#include <algorithm>    // for max, fill, min, fill_n, transform
+#include <any>          // for any, any_cast
+#include <cassert>      // for assert
+#include <cstddef>      // for size_t
+#include <cstdint>      // for uint32_t, int32_t, uint64_t
+#include <memory>       // for unique_ptr, shared_ptr
+#include <ostream>      // for char_traits, operator<<, basic_ostream
+#include <type_traits>  // for remove_cv_t, remove_reference_t
+#include <typeinfo>     // for type_info
+#include <vector>       // for vector
 
 #include "../collective/communicator-inl.h"   // for Allreduce, IsDistributed
 #include "../collective/communicator.h"       // for Operation
@@ -18,13 +19,15 @@
 #include "../common/common.h"                 // for DivRoundUp
 #include "../common/math.h"                   // for CheckNAN
 #include "../common/threading_utils.h"        // for ParallelFor
+#include "../common/trace.h"                  // for TraceScope
 #include "../data/adapter.h"                  // for ArrayAdapter, CSRAdapter, CSRArrayAdapter
 #include "../data/gradient_index.h"           // for GHistIndexMatrix
 #include "../data/proxy_dmatrix.h"            // for DMatrixProxy
 #include "../gbm/gbtree_model.h"              // for GBTreeModel, GBTreeModelParam
-#include "cpu_treeshap.h"                     // for CalculateContributions
+#include "cpu_predictor.h"                    // for PredictLeafByBlockOfRows
+#include "cpu_treeshap.h"                     // for CalculateContributions, TreeShapPaths
 #include "dmlc/registry.h"                    // for DMLC_REGISTRY_FILE_TAG
-#include "predict_fn.h"                       // for GetNextNode, GetNextNodeMulti
+#include "predict_fn.h"                       // for GetNextNode, GetNextNodeMulti, CatDecision
 #include "xgboost/base.h"                     // for bst_float, bst_node_t, bst_omp_uint, bst_fe...
 #include "xgboost/context.h"                  // for Context
 #include "xgboost/data.h"                     // for Entry, DMatrix, MetaInfo, SparsePage, Batch...
@@ -230,7 +233,7 @@ struct GHistIndexMatrixView {
         base_rowid{_page.base_rowid} {}
 
   SparsePage::Inst operator[](size_t r) {
-    auto t = omp_get_thread_num();
+    auto t = common::ThreadIdx();
     auto const beg = (n_features_ * kUnroll * t) + (current_unroll_[t] * n_features_);
     size_t non_missing{static_cast<std::size_t>(beg)};
 
@@ -252,25 +255,26 @@ struct GHistIndexMatrixView {
   size_t Size() const { return page_.Size(); }
 };
 
-template <typename Adapter>
+template <typename Batch>
 class AdapterView {
-  Adapter* adapter_;
+  Batch const* batch_;
+  bst_feature_t columns_;
   float missing_;
   common::Span<Entry> workspace_;
   std::vector<size_t> current_unroll_;
 
  public:
-  explicit AdapterView(Adapter *adapter, float missing, common::Span<Entry> workplace,
-                       int32_t n_threads)
-      : adapter_{adapter},
+  explicit AdapterView(Batch const *batch, bst_feature_t columns, float missing,
+                       common::Span<Entry> workplace, int32_t n_threads)
+      : batch_{batch},
+        columns_{columns},
         missing_{missing},
         workspace_{workplace},
         current_unroll_(n_threads > 0 ? n_threads : 1, 0) {}
   SparsePage::Inst operator[](size_t i) {
-    bst_feature_t columns = adapter_->NumColumns();
-    auto const &batch = adapter_->Value();
-    auto row = batch.GetLine(i);
-    auto t = omp_get_thread_num();
+    bst_feature_t columns = columns_;
+    auto row = batch_->GetLine(i);
+    auto t = common::ThreadIdx();
     auto const beg = (columns * kUnroll * t) + (current_unroll_[t] * columns);
     size_t non_missing {beg};
     for (size_t c = 0; c < row.Size(); ++c) {
@@ -289,7 +293,7 @@ class AdapterView {
     return ret;
   }
 
-  size_t Size() const { return adapter_->NumRows(); }
+  size_t Size() const { return batch_->Size(); }
 
   bst_row_t const static base_rowid = 0;  // NOLINT
 };
@@ -309,8 +313,10 @@ void PredictBatchByBlockOfRowsKernel(DataView batch, gbm::GBTreeModel const &mod
   common::ParallelFor(n_blocks, n_threads, [&](bst_omp_uint block_id) {
     const size_t batch_offset = block_id * block_of_rows_size;
     const size_t block_size = std::min(nsize - batch_offset, block_of_rows_size);
-    const size_t fvec_offset = omp_get_thread_num() * block_of_rows_size;
+    const size_t fvec_offset = common::ThreadIdx() * block_of_rows_size;
 
+    common::TraceScope trace{"PredictBlock", "prediction",
+                             {{"rows", static_cast<std::int64_t>(block_size)}}};
     FVecFill(block_size, batch_offset, num_feature, &batch, fvec_offset, p_thread_temp);
     // process block of rows through all trees to keep cache locality
     PredictByAllTrees(model, tree_begin, tree_end, batch_offset + batch.base_rowid, thread_temp,
@@ -319,32 +325,6 @@ void PredictBatchByBlockOfRowsKernel(DataView batch, gbm::GBTreeModel const &mod
   });
 }
 
-float FillNodeMeanValues(RegTree const *tree, bst_node_t nidx, std::vector<float> *mean_values) {
-  bst_float result;
-  auto &node = (*tree)[nidx];
-  auto &node_mean_values = *mean_values;
-  if (node.IsLeaf()) {
-    result = node.LeafValue();
-  } else {
-    result = FillNodeMeanValues(tree, node.LeftChild(), mean_values) *
-             tree->Stat(node.LeftChild()).sum_hess;
-    result += FillNodeMeanValues(tree, node.RightChild(), mean_values) *
-              tree->Stat(node.RightChild()).sum_hess;
-    result /= tree->Stat(nidx).sum_hess;
-  }
-  node_mean_values[nidx] = result;
-  return result;
-}
-
-void FillNodeMeanValues(RegTree const* tree, std::vector<float>* mean_values) {
-  size_t num_nodes = tree->NumNodes();
-  if (mean_values->size() == num_nodes) {
-    return;
-  }
-  mean_values->resize(num_nodes);
-  FillNodeMeanValues(tree, 0, mean_values);
-}
-
 // init thread buffers
 static void InitThreadTemp(int nthread, std::vector<RegTree::FVec> *out) {
   int prev_thread_temp_size = out->size();
@@ -352,8 +332,80 @@ static void InitThreadTemp(int nthread, std::vector<RegTree::FVec> *out) {
     out->resize(nthread, RegTree::FVec());
   }
 }
+
+template <bool has_categorical>
+bst_node_t LeafIndexByOneTree(RegTree::FVec const &feat, RegTree const &tree,
+                              RegTree::CategoricalSplitMatrix const &cats) {
+  if (tree.IsMultiTarget()) {
+    auto const &mt_tree = *tree.GetMultiTargetTree();
+    return feat.HasMissing() ? multi::GetLeafIndex<true, has_categorical>(mt_tree, feat, cats)
+                             : multi::GetLeafIndex<false, has_categorical>(mt_tree, feat, cats);
+  }
+  return feat.HasMissing() ? scalar::GetLeafIndex<true, has_categorical>(tree, feat, cats)
+                           : scalar::GetLeafIndex<false, has_categorical>(tree, feat, cats);
+}
+
+template <typename T>
+void PredictLeafByBlockOfRowsKernel(Context const *ctx, SparsePage const &batch,
+                                    std::size_t row_begin, bst_feature_t n_features,
+                                    common::Span<RegTree const *const> trees,
+                                    linalg::MatrixView<T> out_leaf) {
+  std::size_t constexpr kBlockOfRowsSize = 64, kBlockOfTreesSize = 64;
+  auto n_rows = out_leaf.Shape(0);
+  auto n_trees = trees.size();
+  CHECK_EQ(out_leaf.Shape(1), n_trees);
+  CHECK_LE(row_begin + n_rows, batch.Size());
+  if (n_rows == 0 || n_trees == 0) {
+    return;
+  }
+
+  auto n_threads = ctx->Threads();
+  std::vector<RegTree::FVec> feat_vecs;
+  InitThreadTemp(n_threads * kBlockOfRowsSize, &feat_vecs);
+  SparsePageView view{&batch};
+
+  auto n_row_blocks = common::DivRoundUp(n_rows, kBlockOfRowsSize);
+  auto n_tree_blocks = common::DivRoundUp(n_trees, kBlockOfTreesSize);
+  // Consecutive tasks share the same block of rows.
+  common::ParallelFor(n_row_blocks * n_tree_blocks, n_threads, [&](std::size_t task) {
+    auto row_block = task / n_tree_blocks;
+    auto tree_block = task % n_tree_blocks;
+    std::size_t const batch_offset = row_begin + row_block * kBlockOfRowsSize;
+    std::size_t const block_size = std::min(n_rows - row_block * kBlockOfRowsSize,
+                                            kBlockOfRowsSize);
+    std::size_t const fvec_offset = common::ThreadIdx() * kBlockOfRowsSize;
+
+    common::TraceScope trace{"PredictLeafBlock", "prediction",
+                             {{"rows", static_cast<std::int64_t>(block_size)}}};
+    FVecFill(block_size, batch_offset, n_features, &view, fvec_offset, &feat_vecs);
+    auto tree_end = std::min(n_trees, (tree_block + 1) * kBlockOfTreesSize);
+    for (auto tree_id = tree_block * kBlockOfTreesSize; tree_id < tree_end; ++tree_id) {
+      auto const &tree = *trees[tree_id];
+      auto const &cats = tree.GetCategoriesMatrix();
+      auto out_row = batch_offset - row_begin;
+      if (tree.HasCategoricalSplit()) {
+        for (std::size_t i = 0; i < block_size; ++i) {
+          out_leaf(out_row + i, tree_id) =
+              static_cast<T>(LeafIndexByOneTree<true>(feat_vecs[fvec_offset + i], tree, cats));
+        }
+      } else {
+        for (std::size_t i = 0; i < block_size; ++i) {
+          out_leaf(out_row + i, tree_id) =
+              static_cast<T>(LeafIndexByOneTree<false>(feat_vecs[fvec_offset + i], tree, cats));
+        }
+      }
+    }
+    FVecDrop(block_size, fvec_offset, &feat_vecs);
+  });
+}
 }  // anonymous namespace
 
+void PredictLeafByBlockOfRows(Context const *ctx, SparsePage const &batch, std::size_t row_begin,
+                              bst_feature_t n_features, common::Span<RegTree const *const> trees,
+                              linalg::MatrixView<bst_node_t> out_leaf) {
+  PredictLeafByBlockOfRowsKernel(ctx, batch, row_begin, n_features, trees, out_leaf);
+}
+
 /**
  * @brief A helper class for prediction when the DMatrix is split by column.
  *
@@ -485,9 +537,7 @@ class ColumnSplitHelper {
 
       auto const fvalue = feat.GetFvalue(split_index);
       if (has_categorical && common::IsCat(cats.split_type, nid)) {
-        auto const node_categories =
-            cats.categories.subspan(cats.node_ptr[nid].beg, cats.node_ptr[nid].size);
-        if (!common::Decision(node_categories, fvalue)) {
+        if (!CatDecision(cats, nid, fvalue)) {
           decision_bits_.Set(bit_index);
         }
         continue;
@@ -567,7 +617,7 @@ class ColumnSplitHelper {
       auto const batch_offset = block_id * block_of_rows_size;
       auto const block_size = std::min(static_cast<std::size_t>(nsize - batch_offset),
                                        static_cast<std::size_t>(block_of_rows_size));
-      auto const fvec_offset = omp_get_thread_num() * block_of_rows_size;
+      auto const fvec_offset = common::ThreadIdx() * block_of_rows_size;
 
       FVecFill(block_size, batch_offset, num_feature, &batch, fvec_offset, &feat_vecs_);
       MaskAllTrees(batch_offset, fvec_offset, block_size);
@@ -647,6 +697,10 @@ class CPUPredictor : public Predictor {
  protected:
   void PredictDMatrix(DMatrix *p_fmat, std::vector<bst_float> *out_preds,
                       gbm::GBTreeModel const &model, int32_t tree_begin, int32_t tree_end) const {
+    common::TraceScope trace{"PredictDMatrix",
+                             "prediction",
+                             {{"rows", static_cast<std::int64_t>(p_fmat->Info().num_row_)},
+                              {"trees", static_cast<std::int64_t>(tree_end - tree_begin)}}};
     if (p_fmat->Info().IsColumnSplit()) {
       CHECK(!model.learner_model_param->IsVectorLeaf())
           << "Predict DMatrix with column split" << MTNotImplemented();
@@ -739,9 +793,13 @@ class CPUPredictor : public Predictor {
     InitThreadTemp(n_threads * kBlockSize, &thread_temp);
     std::size_t n_groups = model.learner_model_param->OutputLength();
     linalg::TensorView<float, 2> out_predt{predictions, {m->NumRows(), n_groups}, Context::kCpuId};
-    PredictBatchByBlockOfRowsKernel<AdapterView<Adapter>, kBlockSize>(
-        AdapterView<Adapter>(m.get(), missing, common::Span<Entry>{workspace}, n_threads), model,
-        tree_begin, tree_end, &thread_temp, n_threads, out_predt);
+    data::DispatchTypedBatch(m->Value(), [&](auto const &batch) {
+      using Batch = std::remove_cv_t<std::remove_reference_t<decltype(batch)>>;
+      PredictBatchByBlockOfRowsKernel<AdapterView<Batch>, kBlockSize>(
+          AdapterView<Batch>(&batch, m->NumColumns(), missing, common::Span<Entry>{workspace},
+                             n_threads),
+          model, tree_begin, tree_end, &thread_temp, n_threads, out_predt);
+    });
   }
 
   bool InplacePredict(std::shared_ptr<DMatrix> p_m, const gbm::GBTreeModel &model, float missing,
@@ -821,34 +879,16 @@ class CPUPredictor : public Predictor {
       return;
     }
 
-    std::vector<RegTree::FVec> feat_vecs;
+    std::vector<RegTree const *> trees(ntree_limit);
+    std::transform(model.trees.cbegin(), model.trees.cbegin() + ntree_limit, trees.begin(),
+                   [](auto const &p_tree) { return p_tree.get(); });
     const int num_feature = model.learner_model_param->num_feature;
-    InitThreadTemp(n_threads, &feat_vecs);
     // start collecting the prediction
     for (const auto &batch : p_fmat->GetBatches<SparsePage>()) {
-      // parallel over local batch
-      auto page = batch.GetView();
-      common::ParallelFor(page.Size(), n_threads, [&](auto i) {
-        const int tid = omp_get_thread_num();
-        auto ridx = static_cast<size_t>(batch.base_rowid + i);
-        RegTree::FVec &feats = feat_vecs[tid];
-        if (feats.Size() == 0) {
-          feats.Init(num_feature);
-        }
-        feats.Fill(page[i]);
-        for (std::uint32_t j = 0; j < ntree_limit; ++j) {
-          auto const &tree = *model.trees[j];
-          auto const &cats = tree.GetCategoriesMatrix();
-          bst_node_t nidx;
-          if (tree.IsMultiTarget()) {
-            nidx = multi::GetLeafIndex<true, true>(*tree.GetMultiTargetTree(), feats, cats);
-          } else {
-            nidx = scalar::GetLeafIndex<true, true>(tree, feats, cats);
-          }
-          preds[ridx * ntree_limit + j] = static_cast<bst_float>(nidx);
-        }
-        feats.Drop();
-      });
+      auto out = common::Span<float>{preds}.subspan(batch.base_rowid * ntree_limit,
+                                                    batch.Size() * ntree_limit);
+      PredictLeafByBlockOfRowsKernel(ctx_, batch, 0, num_feature, trees,
+                                     linalg::MakeTensorView(ctx_, out, batch.Size(), ntree_limit));
     }
   }
 
@@ -879,13 +919,51 @@ class CPUPredictor : public Predictor {
     // make sure contributions is zeroed, we could be reusing a previously
     // allocated one
     std::fill(contribs.begin(), contribs.end(), 0);
-    // initialize tree node mean values
-    std::vector<std::vector<float>> mean_values(ntree_limit);
-    common::ParallelFor(ntree_limit, n_threads, [&](bst_omp_uint i) {
-      FillNodeMeanValues(model.trees[i].get(), &(mean_values[i]));
-    });
     auto base_margin = info.base_margin_.View(Context::kCpuId);
     auto base_score = model.learner_model_param->BaseScore(Context::kCpuId)(0);
+    auto add_base_margin = [&](std::size_t row_idx, int gid, bst_float *p_contribs) {
+      if (base_margin.Size() != 0) {
+        CHECK_EQ(base_margin.Shape(1), ngroup);
+        p_contribs[ncolumns - 1] += base_margin(row_idx, gid);
+      } else {
+        p_contribs[ncolumns - 1] += base_score;
+      }
+    };
+
+    // Tree statistics are cached on the model.
+    auto paths = model.ShapPaths(ntree_limit);
+    if (!approximate && condition == 0) {
+      // Path-based TreeSHAP, the paths are evaluated for a block of rows at a time.
+      static_assert(kBlockOfRowsSize <= TreeShapPaths::kMaxBlockSize);
+      InitThreadTemp(n_threads * kBlockOfRowsSize, &feat_vecs);
+      for (const auto &batch : p_fmat->GetBatches<SparsePage>()) {
+        SparsePageView view{&batch};
+        const auto nsize = static_cast<bst_omp_uint>(batch.Size());
+        auto n_blocks = common::DivRoundUp(nsize, kBlockOfRowsSize);
+        common::ParallelFor(n_blocks, n_threads, [&](bst_omp_uint block_id) {
+          const size_t batch_offset = block_id * kBlockOfRowsSize;
+          const size_t block_size = std::min(nsize - batch_offset, kBlockOfRowsSize);
+          const size_t fvec_offset = common::ThreadIdx() * kBlockOfRowsSize;
+          FVecFill(block_size, batch_offset, num_feature, &view, fvec_offset, &feat_vecs);
+          auto row_begin = batch.base_rowid + batch_offset;
+          auto p_contribs = contribs.data() + row_begin * ngroup * ncolumns;
+          paths->Calculate(model.tree_info, tree_weights, ntree_limit,
+                           {feat_vecs.data() + fvec_offset, block_size}, ngroup, p_contribs);
+          FVecDrop(block_size, fvec_offset, &feat_vecs);
+          for (size_t i = 0; i < block_size; ++i) {
+            for (int gid = 0; gid < ngroup; ++gid) {
+              add_base_margin(row_begin + i, gid, p_contribs + (i * ngroup + gid) * ncolumns);
+            }
+          }
+        });
+      }
+      return;
+    }
+
+    // Per-thread buffer for the contributions of a single tree, only the split features of
+    // the tree and the bias are written and they are reset after use.
+    std::vector<std::vector<bst_float>> tree_contribs(n_threads,
+                                                      std::vector<bst_float>(ncolumns, 0));
     // start collecting the contributions
     for (const auto &batch : p_fmat->GetBatches<SparsePage>()) {
       auto page = batch.GetView();
@@ -893,44 +971,43 @@ class CPUPredictor : public Predictor {
       const auto nsize = static_cast<bst_omp_uint>(batch.Size());
       common::ParallelFor(nsize, n_threads, [&](bst_omp_uint i) {
         auto row_idx = static_cast<size_t>(batch.base_rowid + i);
-        RegTree::FVec &feats = feat_vecs[omp_get_thread_num()];
+        auto tidx = common::ThreadIdx();
+        RegTree::FVec &feats = feat_vecs[tidx];
         if (feats.Size() == 0) {
           feats.Init(num_feature);
         }
-        std::vector<bst_float> this_tree_contribs(ncolumns);
+        auto &this_tree_contribs = tree_contribs[tidx];
+        feats.Fill(page[i]);
         // loop over all classes
         for (int gid = 0; gid < ngroup; ++gid) {
           bst_float* p_contribs = &contribs[(row_idx * ngroup + gid) * ncolumns];
-          feats.Fill(page[i]);
           // calculate contributions
           for (unsigned j = 0; j < ntree_limit; ++j) {
-            auto *tree_mean_values = &mean_values.at(j);
-            std::fill(this_tree_contribs.begin(), this_tree_contribs.end(), 0);
             if (model.tree_info[j] != gid) {
               continue;
             }
+            auto const &tree_mean_values = paths->MeanValues(j);
             if (!approximate) {
-              CalculateContributions(*model.trees[j], feats, tree_mean_values,
-                                     &this_tree_contribs[0], condition, condition_feature);
+              CalculateContributions(*model.trees[j], feats, tree_mean_values, paths->MaxDepth(j),
+                                     this_tree_contribs.data(), condition, condition_feature);
             } else {
-              model.trees[j]->CalculateContributionsApprox(
-                  feats, tree_mean_values, &this_tree_contribs[0]);
+              model.trees[j]->CalculateContributionsApprox(feats, tree_mean_values,
+                                                           this_tree_contribs.data());
             }
-            for (size_t ci = 0; ci < ncolumns; ++ci) {
-              p_contribs[ci] +=
-                  this_tree_contribs[ci] *
-                  (tree_weights == nullptr ? 1 : (*tree_weights)[j]);
+            auto w = tree_weights == nullptr ? 1.0f : (*tree_weights)[j];
+            auto add = [&](std::size_t ci) {
+              p_contribs[ci] += this_tree_contribs[ci] * w;
+              this_tree_contribs[ci] = 0;
+            };
+            for (auto fidx : paths->Features(j)) {
+              add(fidx);
             }
+            add(ncolumns - 1);
           }
-          feats.Drop();
           // add base margin to BIAS
-          if (base_margin.Size() != 0) {
-            CHECK_EQ(base_margin.Shape(1), ngroup);
-            p_contribs[ncolumns - 1] += base_margin(row_idx, gid);
-          } else {
-            p_contribs[ncolumns - 1] += base_score;
-          }
+          add_base_margin(row_idx, gid, p_contribs);
         }
+        feats.Drop();
       });
     }
   }
@@ -943,50 +1020,116 @@ class CPUPredictor : public Predictor {
         << "Predict interaction contribution" << MTNotImplemented();
     CHECK(!p_fmat->Info().IsColumnSplit()) << "Predict interaction contribution support for "
                                               "column-wise data split is not yet implemented.";
+    auto const n_threads = this->ctx_->Threads();
+    auto const num_feature = model.learner_model_param->num_feature;
     const MetaInfo& info = p_fmat->Info();
+    if (ntree_limit == 0 || ntree_limit > model.trees.size()) {
+      ntree_limit = static_cast<unsigned>(model.trees.size());
+    }
     const int ngroup = model.learner_model_param->num_output_group;
-    size_t const ncolumns = model.learner_model_param->num_feature;
-    const unsigned row_chunk = ngroup * (ncolumns + 1) * (ncolumns + 1);
-    const unsigned mrow_chunk = (ncolumns + 1) * (ncolumns + 1);
-    const unsigned crow_chunk = ngroup * (ncolumns + 1);
+    CHECK_NE(ngroup, 0);
+    // number of features + bias
+    size_t const ncolumns = num_feature + 1;
+    size_t const mrow_chunk = ncolumns * ncolumns;
 
-    // allocate space for (number of features^2) times the number of rows and tmp off/on contribs
     std::vector<bst_float>& contribs = out_contribs->HostVector();
-    contribs.resize(info.num_row_ * ngroup * (ncolumns + 1) * (ncolumns + 1));
-    HostDeviceVector<bst_float> contribs_off_hdv(info.num_row_ * ngroup * (ncolumns + 1));
-    auto &contribs_off = contribs_off_hdv.HostVector();
-    HostDeviceVector<bst_float> contribs_on_hdv(info.num_row_ * ngroup * (ncolumns + 1));
-    auto &contribs_on = contribs_on_hdv.HostVector();
-    HostDeviceVector<bst_float> contribs_diag_hdv(info.num_row_ * ngroup * (ncolumns + 1));
-    auto &contribs_diag = contribs_diag_hdv.HostVector();
-
-    // Compute the difference in effects when conditioning on each of the features on and off
-    // see: Axiomatic characterizations of probabilistic and
-    //      cardinal-probabilistic interaction indices
-    PredictContribution(p_fmat, &contribs_diag_hdv, model, ntree_limit,
-                        tree_weights, approximate, 0, 0);
-    for (size_t i = 0; i < ncolumns + 1; ++i) {
-      PredictContribution(p_fmat, &contribs_off_hdv, model, ntree_limit,
-                          tree_weights, approximate, -1, i);
-      PredictContribution(p_fmat, &contribs_on_hdv, model, ntree_limit,
-                          tree_weights, approximate, 1, i);
-
-      for (size_t j = 0; j < info.num_row_; ++j) {
-        for (int l = 0; l < ngroup; ++l) {
-          const unsigned o_offset = j * row_chunk + l * mrow_chunk + i * (ncolumns + 1);
-          const unsigned c_offset = j * crow_chunk + l * (ncolumns + 1);
-          contribs[o_offset + i] = 0;
-          for (size_t k = 0; k < ncolumns + 1; ++k) {
-            // fill in the diagonal with additive effects, and off-diagonal with the interactions
-            if (k == i) {
-              contribs[o_offset + i] += contribs_diag[c_offset + k];
+    contribs.resize(info.num_row_ * ngroup * mrow_chunk);
+
+    // Conditioning on a feature that is not used by a tree has no effect on the tree, so
+    // each tree only needs to be conditioned on its own split features.
+    auto paths = model.ShapPaths(ntree_limit);
+
+    // Per-thread scratch for the contributions of a single tree, TreeShap only writes to
+    // the split features of the tree and the bias, which are reset after use.
+    std::vector<RegTree::FVec> feat_vecs;
+    InitThreadTemp(n_threads, &feat_vecs);
+    std::vector<std::vector<bst_float>> phi_buf(n_threads), on_buf(n_threads),
+        off_buf(n_threads);
+
+    auto base_margin = info.base_margin_.View(Context::kCpuId);
+    auto base_score = model.learner_model_param->BaseScore(Context::kCpuId)(0);
+    for (const auto& batch : p_fmat->GetBatches<SparsePage>()) {
+      auto page = batch.GetView();
+      const auto nsize = static_cast<bst_omp_uint>(batch.Size());
+      common::ParallelFor(nsize, n_threads, [&](bst_omp_uint i) {
+        auto row_idx = static_cast<size_t>(batch.base_rowid + i);
+        auto tidx = common::ThreadIdx();
+        RegTree::FVec& feats = feat_vecs[tidx];
+        if (feats.Size() == 0) {
+          feats.Init(num_feature);
+        }
+        auto& phi = phi_buf[tidx];
+        auto& on = on_buf[tidx];
+        auto& off = off_buf[tidx];
+        if (phi.empty()) {
+          phi.resize(ncolumns, 0);
+          on.resize(ncolumns, 0);
+          off.resize(ncolumns, 0);
+        }
+
+        feats.Fill(page[i]);
+        for (int gid = 0; gid < ngroup; ++gid) {
+          bst_float* p_contribs = &contribs[(row_idx * ngroup + gid) * mrow_chunk];
+          std::fill_n(p_contribs, mrow_chunk, 0.0f);
+          auto diag = [&](std::size_t f) -> bst_float& { return p_contribs[f * ncolumns + f]; };
+
+          for (unsigned j = 0; j < ntree_limit; ++j) {
+            if (model.tree_info[j] != gid) {
+              continue;
+            }
+            auto const& tree = *model.trees[j];
+            auto features = paths->Features(j);
+            auto const& tree_mean_values = paths->MeanValues(j);
+            auto max_depth = paths->MaxDepth(j);
+            float w = tree_weights == nullptr ? 1.0f : (*tree_weights)[j];
+
+            // Fill in the diagonal with the additive effects.
+            if (!approximate) {
+              CalculateContributions(tree, feats, tree_mean_values, max_depth, phi.data(), 0, 0);
             } else {
-              contribs[o_offset + k] = (contribs_on[c_offset + k] - contribs_off[c_offset + k])/2.0;
-              contribs[o_offset + i] -= contribs[o_offset + k];
+              tree.CalculateContributionsApprox(feats, tree_mean_values, phi.data());
+            }
+            for (auto f : features) {
+              diag(f) += phi[f] * w;
+              phi[f] = 0;
             }
+            diag(num_feature) += phi[num_feature] * w;
+            phi[num_feature] = 0;
+            if (approximate) {
+              // The approximate method doesn't support conditioning.
+              continue;
+            }
+
+            // Fill in the off-diagonal with the difference in effects when conditioning on
+            // each of the features on and off, see: Axiomatic characterizations of
+            // probabilistic and cardinal-probabilistic interaction indices
+            for (auto fi : features) {
+              CalculateContributions(tree, feats, tree_mean_values, max_depth, on.data(), 1, fi);
+              CalculateContributions(tree, feats, tree_mean_values, max_depth, off.data(), -1,
+                                     fi);
+              bst_float* p_row = p_contribs + fi * ncolumns;
+              for (auto fk : features) {
+                if (fk != fi) {
+                  auto v = (on[fk] - off[fk]) / 2.0f * w;
+                  p_row[fk] += v;
+                  p_row[fi] -= v;
+                }
+                on[fk] = 0;
+                off[fk] = 0;
+              }
+            }
+          }
+
+          // add base margin to BIAS
+          if (base_margin.Size() != 0) {
+            CHECK_EQ(base_margin.Shape(1), ngroup);
+            diag(num_feature) += base_margin(row_idx, gid);
+          } else {
+            diag(num_feature) += base_score;
           }
         }
-      }
+        feats.Drop();
+      });
     }
   }
 
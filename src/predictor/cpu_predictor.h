@@ -0,0 +1,33 @@
+/**
+ * Copyright 2023 by XGBoost Contributors
+ */
+#ifndef XGBOOST_PREDICTOR_CPU_PREDICTOR_H_
+#define XGBOOST_PREDICTOR_CPU_PREDICTOR_H_
+
+#include <cstddef>  // for size_t
+
+#include "xgboost/base.h"        // for bst_feature_t, bst_node_t
+#include "xgboost/context.h"     // for Context
+#include "xgboost/data.h"        // for SparsePage
+#include "xgboost/linalg.h"      // for MatrixView
+#include "xgboost/span.h"        // for Span
+#include "xgboost/tree_model.h"  // for RegTree
+
+namespace xgboost::predictor {
+/**
+ * \brief Find the leaf of each row for a set of trees.
+ *
+ *   Work is split into blocks of rows and blocks of trees, each block of rows goes through
+ *   a block of trees to keep the feature vectors in cache.
+ *
+ * \param batch      Input rows.
+ * \param row_begin  Index of the first row in the batch.
+ * \param n_features Number of features in the model.
+ * \param trees      Trees to be predicted.
+ * \param out_leaf   Leaf index of each row for each tree, with the shape of [n_rows, n_trees].
+ */
+void PredictLeafByBlockOfRows(Context const *ctx, SparsePage const &batch, std::size_t row_begin,
+                              bst_feature_t n_features, common::Span<RegTree const *const> trees,
+                              linalg::MatrixView<bst_node_t> out_leaf);
+}  // namespace xgboost::predictor
+#endif  // XGBOOST_PREDICTOR_CPU_PREDICTOR_H_
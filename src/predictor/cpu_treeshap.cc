@@ -3,7 +3,8 @@
  */
 #include "cpu_treeshap.h"
 
-#include <algorithm>             // copy
+#include <algorithm>             // copy, copy_n, fill_n, find, max, reverse, sort, unique
+#include <array>                 // array
 #include <cinttypes>             // std::uint32_t
 
 #include "predict_fn.h"          // GetNextNode
@@ -185,19 +186,226 @@ void TreeShap(RegTree const& tree, const RegTree::FVec& feat, float* phi, bst_no
 }
 
 void CalculateContributions(RegTree const& tree, const RegTree::FVec& feat,
-                            std::vector<float>* mean_values, float* out_contribs, int condition,
-                            std::uint32_t condition_feature) {
+                            std::vector<float> const& mean_values, std::int32_t max_depth,
+                            float* out_contribs, int condition, std::uint32_t condition_feature) {
   // find the expected value of the tree's predictions
   if (condition == 0) {
-    float node_value = (*mean_values)[0];
+    float node_value = mean_values[0];
     out_contribs[feat.Size()] += node_value;
   }
 
-  // Preallocate space for the unique path data
-  const int maxd = tree.MaxDepth(0) + 2;
-  std::vector<PathElement> unique_path_data((maxd * (maxd + 1)) / 2);
+  // Preallocate space for the unique path data, reused across calls.
+  const std::size_t maxd = max_depth + 2;
+  thread_local std::vector<PathElement> unique_path_data;
+  if (unique_path_data.size() < (maxd * (maxd + 1)) / 2) {
+    unique_path_data.resize((maxd * (maxd + 1)) / 2);
+  }
 
   TreeShap(tree, feat, out_contribs, 0, 0, unique_path_data.data(), 1, 1, -1, condition,
            condition_feature, 1);
 }
+
+namespace {
+float FillNodeMeanValues(RegTree const& tree, bst_node_t nidx, std::vector<float>* mean_values) {
+  float result;
+  auto& node = tree[nidx];
+  auto& node_mean_values = *mean_values;
+  if (node.IsLeaf()) {
+    result = node.LeafValue();
+  } else {
+    result = FillNodeMeanValues(tree, node.LeftChild(), mean_values) *
+             tree.Stat(node.LeftChild()).sum_hess;
+    result += FillNodeMeanValues(tree, node.RightChild(), mean_values) *
+              tree.Stat(node.RightChild()).sum_hess;
+    result /= tree.Stat(nidx).sum_hess;
+  }
+  node_mean_values[nidx] = result;
+  return result;
+}
+}  // anonymous namespace
+
+void TreeShapPaths::Extend(std::vector<std::unique_ptr<RegTree>> const& trees,
+                           std::uint32_t tree_end) {
+  CHECK_LE(tree_end, trees.size());
+  std::vector<std::pair<bst_node_t, bst_node_t>> edges;
+  for (auto tree_idx = this->NumTrees(); tree_idx < tree_end; ++tree_idx) {
+    auto const& tree = *trees[tree_idx];
+    trees_.push_back(&tree);
+    auto& mean_values = mean_values_.emplace_back(tree.NumNodes());
+    FillNodeMeanValues(tree, RegTree::kRoot, &mean_values);
+    max_depth_.push_back(tree.MaxDepth(RegTree::kRoot));
+
+    auto feat_beg = features_.size();
+    for (bst_node_t nidx = 0; nidx < tree.NumNodes(); ++nidx) {
+      if (!tree[nidx].IsLeaf() && !tree[nidx].IsDeleted()) {
+        features_.push_back(tree[nidx].SplitIndex());
+      }
+    }
+    std::sort(features_.begin() + feat_beg, features_.end());
+    features_.erase(std::unique(features_.begin() + feat_beg, features_.end()), features_.end());
+    features_ptr_.push_back(features_.size());
+
+    for (bst_node_t nidx = 0; nidx < tree.NumNodes(); ++nidx) {
+      auto const& leaf = tree[nidx];
+      if (!leaf.IsLeaf() || leaf.IsDeleted() || leaf.IsRoot()) {
+        continue;
+      }
+
+      edges.clear();
+      for (bst_node_t child = nidx; !tree[child].IsRoot(); child = tree[child].Parent()) {
+        edges.emplace_back(tree[child].Parent(), child);
+      }
+      std::reverse(edges.begin(), edges.end());
+
+      Path path{tree_idx, leaf.LeafValue(), elem_feature_.size(), 0};
+      // The bias element.
+      elem_feature_.push_back(-1);
+      elem_zero_fraction_.push_back(1.0f);
+      elem_split_ptr_.push_back(splits_.size());
+      // Merge splits on the same feature, ordered by the first appearance.
+      for (std::size_t i = 0; i < edges.size(); ++i) {
+        auto fidx = static_cast<std::int32_t>(tree[edges[i].first].SplitIndex());
+        auto beg = elem_feature_.cbegin() + path.elem_begin;
+        if (std::find(beg, elem_feature_.cend(), fidx) != elem_feature_.cend()) {
+          continue;
+        }
+        float zero_fraction = 1.0f;
+        for (std::size_t k = i; k < edges.size(); ++k) {
+          auto [parent, child] = edges[k];
+          if (static_cast<std::int32_t>(tree[parent].SplitIndex()) == fidx) {
+            zero_fraction *= tree.Stat(child).sum_hess / tree.Stat(parent).sum_hess;
+            splits_.push_back(edges[k]);
+          }
+        }
+        elem_feature_.push_back(fidx);
+        elem_zero_fraction_.push_back(zero_fraction);
+        elem_split_ptr_.push_back(splits_.size());
+      }
+      path.elem_end = elem_feature_.size();
+      max_length_ = std::max(max_length_, path.elem_end - path.elem_begin);
+      paths_.push_back(path);
+    }
+    tree_path_ptr_.push_back(paths_.size());
+  }
+}
+
+bool TreeShapPaths::Match(std::vector<std::unique_ptr<RegTree>> const& trees) const {
+  if (trees_.size() > trees.size()) {
+    return false;
+  }
+  for (std::size_t i = 0; i < trees_.size(); ++i) {
+    if (trees_[i] != trees[i].get()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void TreeShapPaths::Calculate(std::vector<int> const& tree_info,
+                              std::vector<float> const* tree_weights, std::uint32_t tree_end,
+                              common::Span<RegTree::FVec const> feats, std::int32_t n_groups,
+                              float* out_contribs) const {
+  auto const n_rows = feats.size();
+  CHECK_LE(n_rows, kMaxBlockSize);
+  CHECK_LE(tree_end, this->NumTrees());
+  if (n_rows == 0) {
+    return;
+  }
+  std::size_t const n_columns = feats.front().Size() + 1;
+  auto weight = [&](std::uint32_t tree_idx) {
+    return tree_weights == nullptr ? 1.0f : (*tree_weights)[tree_idx];
+  };
+  auto out_row = [&](std::size_t r, std::int32_t group) {
+    return out_contribs + (r * n_groups + group) * n_columns;
+  };
+
+  for (std::uint32_t tree_idx = 0; tree_idx < tree_end; ++tree_idx) {
+    auto expected = mean_values_[tree_idx][RegTree::kRoot] * weight(tree_idx);
+    for (std::size_t r = 0; r < n_rows; ++r) {
+      out_row(r, tree_info[tree_idx])[n_columns - 1] += expected;
+    }
+  }
+
+  // Indexed by depth then row, reused across calls.
+  thread_local std::vector<float> one_fraction, pweight;
+  if (one_fraction.size() < max_length_ * kMaxBlockSize) {
+    one_fraction.resize(max_length_ * kMaxBlockSize);
+    pweight.resize(max_length_ * kMaxBlockSize);
+  }
+  std::array<float, kMaxBlockSize> next_one_portion, total;
+
+  for (std::size_t p = 0; p < tree_path_ptr_[tree_end]; ++p) {
+    auto const& path = paths_[p];
+    auto const unique_depth = static_cast<std::int32_t>(path.elem_end - path.elem_begin) - 1;
+    if (unique_depth == 0) {
+      continue;
+    }
+    auto const& tree = *trees_[path.tree_idx];
+    auto const& cats = tree.GetCategoriesMatrix();
+    auto const group = tree_info[path.tree_idx];
+    float const scale = path.leaf_value * weight(path.tree_idx);
+    float const depth_1 = static_cast<float>(unique_depth + 1);
+
+    // Whether each row follows all the splits of an element.
+    for (std::int32_t d = 1; d <= unique_depth; ++d) {
+      auto e = path.elem_begin + d;
+      float* p_one = one_fraction.data() + d * kMaxBlockSize;
+      for (std::size_t r = 0; r < n_rows; ++r) {
+        auto const& feat = feats[r];
+        bool hot = true;
+        for (auto s = elem_split_ptr_[e]; s < elem_split_ptr_[e + 1] && hot; ++s) {
+          auto [parent, child] = splits_[s];
+          auto const& node = tree[parent];
+          auto fidx = node.SplitIndex();
+          hot = predictor::GetNextNode<true, true>(node, parent, feat.GetFvalue(fidx),
+                                                   feat.IsMissing(fidx), cats) == child;
+        }
+        p_one[r] = hot ? 1.0f : 0.0f;
+      }
+    }
+
+    // Extend the path with all elements, see `ExtendPath`.
+    std::fill_n(pweight.data(), n_rows, 1.0f);
+    for (std::int32_t d = 1; d <= unique_depth; ++d) {
+      float const zero_fraction = elem_zero_fraction_[path.elem_begin + d];
+      float const* p_one = one_fraction.data() + d * kMaxBlockSize;
+      float const denom = static_cast<float>(d + 1);
+      std::fill_n(pweight.data() + d * kMaxBlockSize, n_rows, 0.0f);
+      for (std::int32_t i = d - 1; i >= 0; --i) {
+        float* pw_i = pweight.data() + i * kMaxBlockSize;
+        float* pw_next = pw_i + kMaxBlockSize;
+        for (std::size_t r = 0; r < n_rows; ++r) {
+          pw_next[r] += p_one[r] * pw_i[r] * (i + 1) / denom;
+          pw_i[r] = zero_fraction * pw_i[r] * (d - i) / denom;
+        }
+      }
+    }
+
+    // Unwind each element from the full path, see `UnwoundPathSum`. The one fraction is
+    // either 0 or 1 as the path is not conditioned.
+    float const* pw_last = pweight.data() + unique_depth * kMaxBlockSize;
+    for (std::int32_t d = 1; d <= unique_depth; ++d) {
+      auto e = path.elem_begin + d;
+      float const zero_fraction = elem_zero_fraction_[e];
+      float const* p_one = one_fraction.data() + d * kMaxBlockSize;
+      std::copy_n(pw_last, n_rows, next_one_portion.begin());
+      std::fill_n(total.begin(), n_rows, 0.0f);
+      for (std::int32_t i = unique_depth - 1; i >= 0; --i) {
+        float const* pw_i = pweight.data() + i * kMaxBlockSize;
+        float const ratio = (unique_depth - i) / depth_1;
+        for (std::size_t r = 0; r < n_rows; ++r) {
+          float tmp = next_one_portion[r] * depth_1 / static_cast<float>(i + 1);
+          float zero_part = zero_fraction != 0 ? (pw_i[r] / zero_fraction) / ratio : 0.0f;
+          bool is_one = p_one[r] != 0;
+          total[r] += is_one ? tmp : zero_part;
+          next_one_portion[r] = is_one ? pw_i[r] - tmp * zero_fraction * ratio : 0.0f;
+        }
+      }
+      auto fidx = elem_feature_[e];
+      for (std::size_t r = 0; r < n_rows; ++r) {
+        out_row(r, group)[fidx] += total[r] * (p_one[r] - zero_fraction) * scale;
+      }
+    }
+  }
+}
 }  // namespace xgboost
@@ -3,20 +3,111 @@
 /**
  * Copyright by XGBoost Contributors 2017-2022
  */
+#include <cstddef>               // size_t
+#include <cstdint>               // int32_t
+#include <memory>                // unique_ptr
+#include <utility>               // pair
 #include <vector>                // vector
 
+#include "xgboost/base.h"        // bst_node_t, bst_feature_t
+#include "xgboost/span.h"        // Span
 #include "xgboost/tree_model.h"  // RegTree
 
 namespace xgboost {
 /**
  * \brief calculate the feature contributions (https://arxiv.org/abs/1706.06060) for the tree
  * \param feat dense feature vector, if the feature is missing the field is set to NaN
+ * \param mean_values mean value of each node in the tree
+ * \param max_depth maximum depth of the tree
  * \param out_contribs output vector to hold the contributions
  * \param condition fix one feature to either off (-1) on (1) or not fixed (0 default)
  * \param condition_feature the index of the feature to fix
  */
 void CalculateContributions(RegTree const &tree, const RegTree::FVec &feat,
-                            std::vector<float> *mean_values, bst_float *out_contribs, int condition,
-                            unsigned condition_feature);
+                            std::vector<float> const &mean_values, std::int32_t max_depth,
+                            bst_float *out_contribs, int condition, unsigned condition_feature);
+
+/**
+ * \brief Statistics of trees that don't depend on the input, used for computing the
+ *        feature contributions.
+ *
+ *   This includes the mean value of each node and the root-to-leaf paths for the
+ *   path-based TreeSHAP.  The splits on the same feature in a path are merged into a single
+ *   element, similar to GPUTreeShap.  Each path is then evaluated for a block of rows, the
+ *   permutation weights are stored row-wise for each depth so the polynomial updates are
+ *   vectorized across rows.
+ *
+ *   Trees can be appended with `Extend` as the model grows.
+ */
+class TreeShapPaths {
+  struct Path {
+    std::uint32_t tree_idx;
+    float leaf_value;
+    // Range of path elements, the first element is the bias.
+    std::size_t elem_begin;
+    std::size_t elem_end;
+  };
+
+  // Trees used to build the statistics, for validating the cache.
+  std::vector<RegTree const *> trees_;
+  std::vector<std::vector<float>> mean_values_;
+  std::vector<std::int32_t> max_depth_;
+  // Unique split features of each tree.
+  std::vector<bst_feature_t> features_;
+  std::vector<std::size_t> features_ptr_{0};
+
+  std::vector<Path> paths_;
+  // Range of paths for each tree.
+  std::vector<std::size_t> tree_path_ptr_{0};
+  // Path elements
+  std::vector<std::int32_t> elem_feature_;
+  std::vector<float> elem_zero_fraction_;
+  // Range of splits for each path element in `splits_`.
+  std::vector<std::size_t> elem_split_ptr_{0};
+  // Pairs of parent and child nodes, the row follows the path if it goes from the parent to
+  // the child for all splits of the element.
+  std::vector<std::pair<bst_node_t, bst_node_t>> splits_;
+  std::size_t max_length_{0};
+
+ public:
+  static constexpr std::size_t kMaxBlockSize = 64;
+
+  /**
+   * \brief Add statistics for trees in the range [NumTrees(), tree_end).
+   */
+  void Extend(std::vector<std::unique_ptr<RegTree>> const &trees, std::uint32_t tree_end);
+  /**
+   * \brief Whether the statistics are built from the leading trees of `trees`.
+   */
+  [[nodiscard]] bool Match(std::vector<std::unique_ptr<RegTree>> const &trees) const;
+
+  [[nodiscard]] std::uint32_t NumTrees() const {
+    return static_cast<std::uint32_t>(trees_.size());
+  }
+  [[nodiscard]] std::vector<float> const &MeanValues(std::uint32_t tree_idx) const {
+    return mean_values_[tree_idx];
+  }
+  [[nodiscard]] std::int32_t MaxDepth(std::uint32_t tree_idx) const {
+    return max_depth_[tree_idx];
+  }
+  [[nodiscard]] common::Span<bst_feature_t const> Features(std::uint32_t tree_idx) const {
+    auto beg = features_ptr_[tree_idx];
+    return {features_.data() + beg, features_ptr_[tree_idx + 1] - beg};
+  }
+  /**
+   * \brief Accumulate the feature contributions of the first `tree_end` trees for a block
+   *        of rows.
+   *
+   * \param tree_info    Output group of each tree.
+   * \param tree_weights Optional weight of each tree.
+   * \param tree_end     Number of trees to use.
+   * \param feats        Feature vectors of rows in the block, at most `kMaxBlockSize` rows.
+   * \param n_groups     Number of output groups.
+   * \param out_contribs Output with shape (n_rows, n_groups, n_features + 1).
+   */
+  void Calculate(std::vector<int> const &tree_info, std::vector<float> const *tree_weights,
+                 std::uint32_t tree_end, common::Span<RegTree::FVec const> feats,
+                 std::int32_t n_groups, float *out_contribs) const;
+};
 }  // namespace xgboost
 #endif  // XGBOOST_PREDICTOR_CPU_TREESHAP_H_
@@ -7,6 +7,29 @@
 #include "xgboost/tree_model.h"
 
 namespace xgboost::predictor {
+/**
+ * \brief Whether should it traverse to the left branch of a categorical split, uses the
+ *        compact encoding of the node when available.
+ */
+inline XGBOOST_DEVICE bool CatDecision(RegTree::CategoricalSplitMatrix const &cats,
+                                       bst_node_t nidx, float fvalue) {
+  using Encoding = RegTree::CategoricalSplitMatrix::Encoding;
+  if (!cats.compact_ptr.empty()) {
+    auto const &enc = cats.compact_ptr[nidx];
+    switch (enc.kind) {
+      case Encoding::kSorted:
+        return common::SortedDecision(cats.compact.subspan(enc.beg, enc.size), fvalue);
+      case Encoding::kHash:
+        return common::HashDecision(cats.compact.subspan(enc.beg, enc.size),
+                                    cats.compact.subspan(enc.beg + enc.size, enc.n_slots), fvalue);
+      case Encoding::kBitset:
+        break;
+    }
+  }
+  auto const &segment = cats.node_ptr[nidx];
+  return common::Decision(cats.categories.subspan(segment.beg, segment.size), fvalue);
+}
+
 template <bool has_missing, bool has_categorical>
 inline XGBOOST_DEVICE bst_node_t GetNextNode(const RegTree::Node &node, const bst_node_t nid,
                                              float fvalue, bool is_missing,
@@ -15,9 +38,7 @@ inline XGBOOST_DEVICE bst_node_t GetNextNode(const RegTree::Node &node, const bs
     return node.DefaultChild();
   } else {
     if (has_categorical && common::IsCat(cats.split_type, nid)) {
-      auto node_categories =
-          cats.categories.subspan(cats.node_ptr[nid].beg, cats.node_ptr[nid].size);
-      return common::Decision(node_categories, fvalue) ? node.LeftChild() : node.RightChild();
+      return CatDecision(cats, nid, fvalue) ? node.LeftChild() : node.RightChild();
     } else {
       return node.LeftChild() + !(fvalue < node.SplitCond());
     }
@@ -33,10 +54,7 @@ inline XGBOOST_DEVICE bst_node_t GetNextNodeMulti(MultiTargetTree const &tree,
     return tree.DefaultChild(nidx);
   } else {
     if (has_categorical && common::IsCat(cats.split_type, nidx)) {
-      auto node_categories =
-          cats.categories.subspan(cats.node_ptr[nidx].beg, cats.node_ptr[nidx].size);
-      return common::Decision(node_categories, fvalue) ? tree.LeftChild(nidx)
-                                                       : tree.RightChild(nidx);
+      return CatDecision(cats, nidx, fvalue) ? tree.LeftChild(nidx) : tree.RightChild(nidx);
     } else {
       return tree.LeftChild(nidx) + !(fvalue < tree.SplitCond(nidx));
     }
@@ -15,6 +15,7 @@
 #include "../common/linalg_op.h"  // cbegin
 #include "../common/numeric.h"  // Iota
 #include "../common/partition_builder.h"
+#include "../common/trace.h"  // TraceScope
 #include "hist/expand_entry.h"  // CPUExpandEntry
 #include "xgboost/base.h"
 #include "xgboost/context.h"    // Context
@@ -49,7 +50,7 @@ class ColumnSplitHelper {
     std::fill(missing_storage_.begin(), missing_storage_.end(), 0);
     common::ParallelFor2d(space, n_threads, [&](size_t node_in_set, common::Range1d r) {
       const int32_t nid = nodes[node_in_set].nid;
-      bst_bin_t split_cond = column_matrix.IsInitialized() ? split_conditions[node_in_set] : 0;
+      bst_bin_t split_cond = split_conditions[node_in_set];
       partition_builder_->MaskRows<BinIdxType, any_missing, any_cat>(
           node_in_set, nodes, r, split_cond, gmat, column_matrix, *p_tree,
           (*row_set_collection_)[nid].begin, &decision_bits_, &missing_bits_);
@@ -92,7 +93,7 @@ class CommonRowPartitioner {
                        bool is_col_split)
       : base_rowid{_base_rowid}, is_col_split_{is_col_split} {
     row_set_collection_.Clear();
-    std::vector<size_t>& row_indices = *row_set_collection_.Data();
+    auto& row_indices = *row_set_collection_.Data();
     row_indices.resize(num_row);
 
     std::size_t* p_row_indices = row_indices.data();
@@ -154,8 +155,9 @@ class CommonRowPartitioner {
       }
     } else {
       /* ColumnMatrix is not initilized.
-       * It means that we use 'approx' method.
-       * any_missing and any_cat don't metter in this case.
+       * It means that we use 'approx' method or 'hist' without the column matrix, rows are
+       * partitioned using the row-major gradient index.
+       * any_missing doesn't metter in this case.
        * Jump directly to the main method.
        */
       this->template UpdatePosition<uint8_t, true, true>(ctx, gmat, column_matrix, nodes, p_tree);
@@ -190,12 +192,11 @@ class CommonRowPartitioner {
                       std::vector<ExpandEntry> const& nodes, RegTree const* p_tree) {
     // 1. Find split condition for each split
     size_t n_nodes = nodes.size();
+    common::TraceScope trace{"UpdatePosition", "partition",
+                             {{"nodes", static_cast<std::int64_t>(n_nodes)}}};
 
-    std::vector<int32_t> split_conditions;
-    if (column_matrix.IsInitialized()) {
-      split_conditions.resize(n_nodes);
-      FindSplitConditions(nodes, *p_tree, gmat, &split_conditions);
-    }
+    std::vector<int32_t> split_conditions(n_nodes);
+    FindSplitConditions(nodes, *p_tree, gmat, &split_conditions);
 
     // 2.1 Create a blocked space of size SUM(samples in each node)
     common::BlockedSpace2d space(
@@ -227,7 +228,9 @@ class CommonRowPartitioner {
         const int32_t nid = nodes[node_in_set].nid;
         const size_t task_id = partition_builder_.GetTaskIdx(node_in_set, begin);
         partition_builder_.AllocateForTask(task_id);
-        bst_bin_t split_cond = column_matrix.IsInitialized() ? split_conditions[node_in_set] : 0;
+        bst_bin_t split_cond = split_conditions[node_in_set];
+        auto n_rows = static_cast<std::int64_t>(r.end() - r.begin());
+        common::TraceScope block_trace{"Partition", "partition", {{"node", nid}, {"rows", n_rows}}};
         partition_builder_.template Partition<BinIdxType, any_missing, any_cat>(
             node_in_set, nodes, r, split_cond, gmat, column_matrix, *p_tree,
             row_set_collection_[nid].begin);
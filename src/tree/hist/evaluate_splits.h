@@ -4,11 +4,12 @@
 #ifndef XGBOOST_TREE_HIST_EVALUATE_SPLITS_H_
 #define XGBOOST_TREE_HIST_EVALUATE_SPLITS_H_
 
-#include <algorithm>                   // for copy
+#include <algorithm>                   // for copy, nth_element, partial_sort, sort
 #include <cstddef>                     // for size_t
+#include <cstdint>                     // for int64_t
 #include <limits>                      // for numeric_limits
 #include <memory>                      // for shared_ptr
-#include <numeric>                     // for accumulate
+#include <numeric>                     // for accumulate, iota
 #include <utility>                     // for move
 #include <vector>                      // for vector
 
@@ -16,6 +17,7 @@
 #include "../../common/hist_util.h"    // for GHistRow, HistogramCuts
 #include "../../common/linalg_op.h"    // for cbegin, cend, begin
 #include "../../common/random.h"       // for ColumnSampler
+#include "../../common/trace.h"        // for TraceScope
 #include "../constraints.h"            // for FeatureInteractionConstraintHost
 #include "../param.h"                  // for TrainParam
 #include "../split_evaluator.h"        // for TreeEvaluator
@@ -42,6 +44,12 @@ class HistEvaluator {
   bool is_col_split_{false};
   FeatureInteractionConstraintHost interaction_constraints_;
   std::vector<NodeEntry> snode_;
+  // Buffers for sorting categories, one for each thread.
+  struct CatSortBuffer {
+    std::vector<float> weight;
+    std::vector<std::size_t> sorted_idx;
+  };
+  std::vector<CatSortBuffer> cat_sort_buffer_;
 
   // if sum of statistics for non-missing values in the node
   // is equal to sum of statistics for all values:
@@ -125,6 +133,42 @@ class HistEvaluator {
     p_best->Update(best);
   }
 
+  /**
+   * \brief Sort the categories of a feature by their weights to get contiguous partitions.
+   *
+   *   `EnumeratePart` only visits the first and the last `max_cat_threshold` categories,
+   *   the ones in between are partitioned from both ends but are not sorted.  Ties are
+   *   broken by the index, which gives the same order as a stable sort.
+   */
+  common::Span<std::size_t const> SortCategories(
+      common::GHistRow const &feat_hist, TreeEvaluator::SplitEvaluator<TrainParam> const &evaluator,
+      CatSortBuffer *p_buffer) const {
+    auto n_bins = feat_hist.size();
+    auto &weight = p_buffer->weight;
+    auto &sorted_idx = p_buffer->sorted_idx;
+    weight.resize(n_bins);
+    sorted_idx.resize(n_bins);
+    for (std::size_t i = 0; i < n_bins; ++i) {
+      weight[i] = evaluator.CalcWeightCat(*param_, feat_hist[i]);
+    }
+    std::iota(sorted_idx.begin(), sorted_idx.end(), 0);
+    auto less = [&](std::size_t l, std::size_t r) {
+      return weight[l] < weight[r] || (weight[l] == weight[r] && l < r);
+    };
+
+    auto k = std::min(static_cast<std::size_t>(param_->max_cat_threshold), n_bins);
+    auto beg = sorted_idx.begin();
+    auto end = sorted_idx.end();
+    if (k * 2 >= n_bins) {
+      std::sort(beg, end, less);
+    } else {
+      std::partial_sort(beg, beg + k, end, less);
+      std::nth_element(beg + k, end - k, end, less);
+      std::sort(end - k, end, less);
+    }
+    return {sorted_idx.data(), sorted_idx.size()};
+  }
+
   /**
    * \brief Enumerate with partition-based splits.
    *
@@ -195,7 +239,8 @@ class HistEvaluator {
       }
     }
 
-    if (best_thresh != -1) {
+    // Only build the bitset when this split is going to be used.
+    if (best_thresh != -1 && p_best->NeedReplace(best.loss_chg, best.SplitIndex())) {
       auto n = common::CatBitField::ComputeStorageSize(n_bins_feature);
       best.cat_bits = decltype(best.cat_bits)(n, 0);
       common::CatBitField cat_bits{best.cat_bits};
@@ -322,6 +367,10 @@ class HistEvaluator {
                       std::vector<CPUExpandEntry> *p_entries) {
     auto n_threads = ctx_->Threads();
     auto& entries = *p_entries;
+    common::TraceScope trace{"EvaluateSplits",
+                             "evaluation",
+                             {{"nodes", static_cast<std::int64_t>(entries.size())},
+                              {"bins", static_cast<std::int64_t>(cut.TotalBins())}}};
     // All nodes are on the same level, so we can store the shared ptr.
     std::vector<std::shared_ptr<HostDeviceVector<bst_feature_t>>> features(
         entries.size());
@@ -345,9 +394,10 @@ class HistEvaluator {
     }
     auto evaluator = tree_evaluator_.GetEvaluator();
     auto const& cut_ptrs = cut.Ptrs();
+    cat_sort_buffer_.resize(n_threads);
 
     common::ParallelFor2d(space, n_threads, [&](size_t nidx_in_set, common::Range1d r) {
-      auto tidx = omp_get_thread_num();
+      auto tidx = common::ThreadIdx();
       auto entry = &tloc_candidates[n_threads * nidx_in_set + tidx];
       auto best = &entry->split;
       auto nidx = entry->nid;
@@ -364,15 +414,8 @@ class HistEvaluator {
           if (common::UseOneHot(n_bins, param_->max_cat_to_onehot)) {
             EnumerateOneHot(cut, histogram, fidx, nidx, evaluator, best);
           } else {
-            std::vector<size_t> sorted_idx(n_bins);
-            std::iota(sorted_idx.begin(), sorted_idx.end(), 0);
             auto feat_hist = histogram.subspan(cut_ptrs[fidx], n_bins);
-            // Sort the histogram to get contiguous partitions.
-            std::stable_sort(sorted_idx.begin(), sorted_idx.end(), [&](size_t l, size_t r) {
-              auto ret = evaluator.CalcWeightCat(*param_, feat_hist[l]) <
-                         evaluator.CalcWeightCat(*param_, feat_hist[r]);
-              return ret;
-            });
+            auto sorted_idx = this->SortCategories(feat_hist, evaluator, &cat_sort_buffer_[tidx]);
             EnumeratePart<+1>(cut, sorted_idx, histogram, fidx, nidx, evaluator, best);
             EnumeratePart<-1>(cut, sorted_idx, histogram, fidx, nidx, evaluator, best);
           }
@@ -508,16 +551,20 @@ class HistMultiEvaluator {
     return left_gain + right_gain;
   }
 
+  /**
+   * \param hist Histogram of a node with the layout [bin][target].
+   */
   template <bst_bin_t d_step>
   bool EnumerateSplit(common::HistogramCuts const &cut, bst_feature_t fidx,
-                      common::Span<common::GHistRow const> hist,
+                      common::GHistRow hist,
                       linalg::VectorView<GradientPairPrecise const> parent_sum, double parent_gain,
                       SplitEntryContainer<std::vector<GradientPairPrecise>> *p_best) const {
     auto const &cut_ptr = cut.Ptrs();
     auto const &cut_val = cut.Values();
     auto const &min_val = cut.MinValues();
 
-    auto sum = linalg::Empty<GradientPairPrecise>(ctx_, 2, hist.size());
+    auto n_targets = parent_sum.Size();
+    auto sum = linalg::Empty<GradientPairPrecise>(ctx_, 2, n_targets);
     auto left_sum = sum.Slice(0, linalg::All());
     auto right_sum = sum.Slice(1, linalg::All());
 
@@ -531,17 +578,15 @@ class HistMultiEvaluator {
     }
     const auto imin = static_cast<bst_bin_t>(cut_ptr[fidx]);
 
-    auto n_targets = hist.size();
     auto weight = linalg::Empty<float>(ctx_, 2, n_targets);
     auto left_weight = weight.Slice(0, linalg::All());
     auto right_weight = weight.Slice(1, linalg::All());
 
     for (bst_bin_t i = ibegin; i != iend; i += d_step) {
+      auto bin = hist.subspan(static_cast<std::size_t>(i) * n_targets, n_targets);
       for (bst_target_t t = 0; t < n_targets; ++t) {
-        auto t_hist = hist[t];
-        auto t_p = parent_sum(t);
-        left_sum(t) += t_hist[i];
-        right_sum(t) = t_p - left_sum(t);
+        left_sum(t) += bin[t];
+        right_sum(t) = parent_sum(t) - left_sum(t);
       }
 
       if (d_step > 0) {
@@ -623,9 +668,18 @@ class HistMultiEvaluator {
   }
 
  public:
-  void EvaluateSplits(RegTree const &tree, common::Span<const common::HistCollection *> hist,
+  /**
+   * \param hist Histograms for all targets, the layout of each node is [bin][target].
+   */
+  void EvaluateSplits(RegTree const &tree, common::HistCollection const &hist,
                       common::HistogramCuts const &cut, std::vector<MultiExpandEntry> *p_entries) {
     auto &entries = *p_entries;
+    auto n_targets = tree.NumTargets();
+    common::TraceScope trace{"EvaluateSplits",
+                             "evaluation",
+                             {{"nodes", static_cast<std::int64_t>(entries.size())},
+                              {"bins", static_cast<std::int64_t>(cut.TotalBins())},
+                              {"targets", static_cast<std::int64_t>(n_targets)}}};
     std::vector<std::shared_ptr<HostDeviceVector<bst_feature_t>>> features(entries.size());
 
     for (std::size_t nidx_in_set = 0; nidx_in_set < entries.size(); ++nidx_in_set) {
@@ -647,14 +701,11 @@ class HistMultiEvaluator {
       }
     }
     common::ParallelFor2d(space, n_threads, [&](std::size_t nidx_in_set, common::Range1d r) {
-      auto tidx = omp_get_thread_num();
+      auto tidx = common::ThreadIdx();
       auto entry = &tloc_candidates[n_threads * nidx_in_set + tidx];
       auto best = &entry->split;
       auto parent_sum = stats_.Slice(entry->nid, linalg::All());
-      std::vector<common::GHistRow> node_hist;
-      for (auto t_hist : hist) {
-        node_hist.push_back((*t_hist)[entry->nid]);
-      }
+      auto node_hist = hist[entry->nid];
       auto features_set = features[nidx_in_set]->ConstHostSpan();
 
       for (auto fidx_in_set = r.begin(); fidx_in_set < r.end(); fidx_in_set++) {
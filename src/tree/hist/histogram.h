@@ -5,13 +5,16 @@
 #define XGBOOST_TREE_HIST_HISTOGRAM_H_
 
 #include <algorithm>
+#include <cstdint>
 #include <limits>
 #include <vector>
 
 #include "../../collective/communicator-inl.h"
 #include "../../common/hist_util.h"
+#include "../../common/trace.h"
 #include "../../data/gradient_index.h"
 #include "expand_entry.h"
+#include "xgboost/linalg.h"      // for MatrixView
 #include "xgboost/tree_model.h"  // for RegTree
 
 namespace xgboost {
@@ -56,14 +59,17 @@ class HistogramBuilder {
     auto DMLC_ATTRIBUTE_UNUSED __force_instantiation = &GradientPairPrecise::Reduce;
   }
 
-  template <bool any_missing>
+  template <typename BuildFn>
   void BuildLocalHistograms(size_t page_idx, common::BlockedSpace2d space,
-                            GHistIndexMatrix const &gidx,
                             std::vector<ExpandEntry> const &nodes_for_explicit_hist_build,
                             common::RowSetCollection const &row_set_collection,
-                            common::Span<GradientPair const> gpair_h, bool force_read_by_column) {
+                            BuildFn &&build_fn) {
     const size_t n_nodes = nodes_for_explicit_hist_build.size();
     CHECK_GT(n_nodes, 0);
+    common::TraceScope trace{"BuildLocalHistograms",
+                             "hist",
+                             {{"nodes", static_cast<std::int64_t>(n_nodes)},
+                              {"blocks", static_cast<std::int64_t>(space.Size())}}};
 
     std::vector<common::GHistRow> target_hists(n_nodes);
     for (size_t i = 0; i < n_nodes; ++i) {
@@ -79,7 +85,7 @@ class HistogramBuilder {
 
     // Parallel processing by nodes and data in each node
     common::ParallelFor2d(space, this->n_threads_, [&](size_t nid_in_set, common::Range1d r) {
-      const auto tid = static_cast<unsigned>(omp_get_thread_num());
+      const auto tid = static_cast<unsigned>(common::ThreadIdx());
       const int32_t nid = nodes_for_explicit_hist_build[nid_in_set].nid;
       auto elem = row_set_collection[nid];
       auto start_of_row_set = std::min(r.begin(), elem.Size());
@@ -87,9 +93,10 @@ class HistogramBuilder {
       auto rid_set = common::RowSetCollection::Elem(elem.begin + start_of_row_set,
                                                     elem.begin + end_of_row_set, nid);
       auto hist = buffer_.GetInitializedHist(tid, nid_in_set);
+      auto n_rows = static_cast<std::int64_t>(rid_set.Size());
+      common::TraceScope block_trace{"BuildHist", "hist", {{"node", nid}, {"rows", n_rows}}};
       if (rid_set.Size() != 0) {
-        builder_.template BuildHist<any_missing>(gpair_h, rid_set, gidx, hist,
-                                                 force_read_by_column);
+        build_fn(rid_set, hist);
       }
     });
   }
@@ -113,32 +120,44 @@ class HistogramBuilder {
                  std::vector<ExpandEntry> const &nodes_for_explicit_hist_build,
                  std::vector<ExpandEntry> const &nodes_for_subtraction_trick,
                  common::Span<GradientPair const> gpair, bool force_read_by_column = false) {
-    int starting_index = std::numeric_limits<int>::max();
-    int sync_count = 0;
-    if (page_id == 0) {
-      this->AddHistRows(&starting_index, &sync_count, nodes_for_explicit_hist_build,
-                        nodes_for_subtraction_trick, p_tree);
-    }
-    if (gidx.IsDense()) {
-      this->BuildLocalHistograms<false>(page_id, space, gidx, nodes_for_explicit_hist_build,
-                                        row_set_collection, gpair, force_read_by_column);
-    } else {
-      this->BuildLocalHistograms<true>(page_id, space, gidx, nodes_for_explicit_hist_build,
-                                       row_set_collection, gpair, force_read_by_column);
-    }
-
-    CHECK_GE(n_batches_, 1);
-    if (page_id != n_batches_ - 1) {
-      return;
-    }
-
-    if (is_distributed_ && !is_col_split_) {
-      this->SyncHistogramDistributed(p_tree, nodes_for_explicit_hist_build,
-                                     nodes_for_subtraction_trick,
-                                     starting_index, sync_count);
-    } else {
-      this->SyncHistogramLocal(p_tree, nodes_for_explicit_hist_build, nodes_for_subtraction_trick);
-    }
+    this->BuildHistImpl(page_id, space, p_tree, row_set_collection,
+                        nodes_for_explicit_hist_build, nodes_for_subtraction_trick,
+                        [&](auto const &rid_set, common::GHistRow hist) {
+                          if (gidx.IsDense()) {
+                            builder_.template BuildHist<false>(gpair, rid_set, gidx, hist,
+                                                               force_read_by_column);
+                          } else {
+                            builder_.template BuildHist<true>(gpair, rid_set, gidx, hist,
+                                                              force_read_by_column);
+                          }
+                        });
+  }
+  /**
+   * \brief Build the histogram for all targets at once, the layout of the histogram is
+   *        [bin][target].  The builder must be reset with the number of bins multiplied
+   *        by the number of targets.
+   *
+   * \param gpair Row-major gradient matrix.
+   */
+  void BuildHist(size_t page_id, common::BlockedSpace2d space, GHistIndexMatrix const &gidx,
+                 RegTree const *p_tree, common::RowSetCollection const &row_set_collection,
+                 std::vector<ExpandEntry> const &nodes_for_explicit_hist_build,
+                 std::vector<ExpandEntry> const &nodes_for_subtraction_trick,
+                 linalg::MatrixView<GradientPair const> gpair) {
+    CHECK(gpair.CContiguous());
+    auto n_targets = static_cast<bst_target_t>(gpair.Shape(1));
+    CHECK_EQ(builder_.GetNumBins(), gidx.cut.TotalBins() * n_targets);
+    this->BuildHistImpl(page_id, space, p_tree, row_set_collection,
+                        nodes_for_explicit_hist_build, nodes_for_subtraction_trick,
+                        [&](auto const &rid_set, common::GHistRow hist) {
+                          if (gidx.IsDense()) {
+                            builder_.template BuildHist<false>(gpair.Values(), n_targets, rid_set,
+                                                               gidx, hist);
+                          } else {
+                            builder_.template BuildHist<true>(gpair.Values(), n_targets, rid_set,
+                                                              gidx, hist);
+                          }
+                        });
   }
   /** same as the other build hist but handles only single batch data (in-core) */
   void BuildHist(size_t page_id, GHistIndexMatrix const &gidx, RegTree *p_tree,
@@ -163,6 +182,10 @@ class HistogramBuilder {
                                 std::vector<ExpandEntry> const &nodes_for_explicit_hist_build,
                                 std::vector<ExpandEntry> const &nodes_for_subtraction_trick,
                                 int starting_index, int sync_count) {
+    common::TraceScope trace{
+        "SyncHistogram",
+        "hist",
+        {{"nodes", static_cast<std::int64_t>(nodes_for_explicit_hist_build.size())}}};
     const size_t nbins = builder_.GetNumBins();
     common::BlockedSpace2d space(
         nodes_for_explicit_hist_build.size(), [&](size_t) { return nbins; }, 1024);
@@ -203,6 +226,10 @@ class HistogramBuilder {
   void SyncHistogramLocal(RegTree const *p_tree,
                           std::vector<ExpandEntry> const &nodes_for_explicit_hist_build,
                           std::vector<ExpandEntry> const &nodes_for_subtraction_trick) {
+    common::TraceScope trace{
+        "SyncHistogram",
+        "hist",
+        {{"nodes", static_cast<std::int64_t>(nodes_for_explicit_hist_build.size())}}};
     const size_t nbins = this->builder_.GetNumBins();
     common::BlockedSpace2d space(
         nodes_for_explicit_hist_build.size(), [&](size_t) { return nbins; }, 1024);
@@ -229,6 +256,35 @@ class HistogramBuilder {
   auto& Buffer() { return buffer_; }
 
  private:
+  template <typename BuildFn>
+  void BuildHistImpl(size_t page_id, common::BlockedSpace2d space, RegTree const *p_tree,
+                     common::RowSetCollection const &row_set_collection,
+                     std::vector<ExpandEntry> const &nodes_for_explicit_hist_build,
+                     std::vector<ExpandEntry> const &nodes_for_subtraction_trick,
+                     BuildFn &&build_fn) {
+    int starting_index = std::numeric_limits<int>::max();
+    int sync_count = 0;
+    if (page_id == 0) {
+      this->AddHistRows(&starting_index, &sync_count, nodes_for_explicit_hist_build,
+                        nodes_for_subtraction_trick, p_tree);
+    }
+    this->BuildLocalHistograms(page_id, space, nodes_for_explicit_hist_build, row_set_collection,
+                               build_fn);
+
+    CHECK_GE(n_batches_, 1);
+    if (page_id != n_batches_ - 1) {
+      return;
+    }
+
+    if (is_distributed_ && !is_col_split_) {
+      this->SyncHistogramDistributed(p_tree, nodes_for_explicit_hist_build,
+                                     nodes_for_subtraction_trick,
+                                     starting_index, sync_count);
+    } else {
+      this->SyncHistogramLocal(p_tree, nodes_for_explicit_hist_build, nodes_for_subtraction_trick);
+    }
+  }
+
   void
   ParallelSubtractionHist(const common::BlockedSpace2d &space,
                           const std::vector<ExpandEntry> &nodes,
@@ -83,6 +83,11 @@ struct TrainParam : public XGBoostParameter<TrainParam> {
   static constexpr double DftSparseThreshold() { return 0.2; }
 
   double sparse_threshold{DftSparseThreshold()};
+  // whether to build a column-major copy of the gradient index for partitioning rows
+  bool column_matrix{true};
+  // ------ From approx -------.
+  // tolerated rank error of the cuts before the gradient index is re-binned, 0 to disable
+  double rebin_tolerance{0.0};
 
   // declare the parameters
   DMLC_DECLARE_PARAMETER(TrainParam) {
@@ -190,6 +195,16 @@ struct TrainParam : public XGBoostParameter<TrainParam> {
         .set_range(0, 1.0)
         .set_default(DftSparseThreshold())
         .describe("percentage threshold for treating a feature as sparse");
+    DMLC_DECLARE_FIELD(column_matrix)
+        .set_default(true)
+        .describe("Build a column-major copy of the gradient index for partitioning rows, "
+                  "otherwise rows are partitioned using the row-major gradient index.");
+    DMLC_DECLARE_FIELD(rebin_tolerance)
+        .set_range(0.0, 1.0)
+        .set_default(0.0)
+        .describe("Tolerated rank error of the hessian weighted cuts for approx. When positive, "
+                  "only features whose cuts deviate more than this are re-binned in each "
+                  "iteration instead of sketching the data again.");
 
     // add alias of parameters
     DMLC_DECLARE_ALIAS(reg_lambda, lambda);
@@ -553,6 +568,11 @@ struct SplitEntryContainer {
 };
 
 using SplitEntry = SplitEntryContainer<GradStats>;
+
+/**
+ * \brief Parameter for the gradient index used by the CPU hist tree method.
+ */
+BatchParam HistBatch(TrainParam const *param);
 }  // namespace tree
 
 /*
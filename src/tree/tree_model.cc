@@ -8,11 +8,15 @@
 #include <xgboost/json.h>
 #include <xgboost/tree_model.h>
 
+#include <algorithm>
 #include <cmath>
+#include <cstdint>
 #include <iomanip>
 #include <limits>
+#include <numeric>
 #include <sstream>
 #include <type_traits>
+#include <vector>
 
 #include "../common/categorical.h"
 #include "../common/common.h"
@@ -824,6 +828,7 @@ void RegTree::ExpandNode(bst_node_t nidx, bst_feature_t split_index, float split
 
   split_types_.resize(this->Size(), FeatureType::kNumerical);
   split_categories_segments_.resize(this->Size());
+  split_categories_compact_ptr_.resize(this->Size());
   this->split_types_.at(nidx) = FeatureType::kNumerical;
 
   this->param_.num_nodes = this->p_mt_tree_->Size();
@@ -847,6 +852,121 @@ void RegTree::ExpandCategorical(bst_node_t nid, bst_feature_t split_index,
   this->split_types_.at(nid) = FeatureType::kCategorical;
   this->split_categories_segments_.at(nid).beg = orig_size;
   this->split_categories_segments_.at(nid).size = split_cat.size();
+  this->EncodeCategories(nid);
+}
+
+namespace {
+// Bitsets within a cache line are used as they are.
+constexpr std::size_t kMaxBitsetWords = 16;
+// Sets with at most this number of categories are stored as sorted lists.
+constexpr std::size_t kMaxSortedCats = 16;
+// Average number of categories in each bucket of the hash table.
+constexpr std::size_t kCatsPerBucket = 4;
+// Maximum number of seeds tried for each bucket.
+constexpr std::uint32_t kMaxBucketSeeds = 1u << 16;
+
+/**
+ * \brief Build a perfect hash table with the hash-and-displace scheme.  Buckets are
+ *        processed from the largest one, each searches for a seed that hashes all its
+ *        categories into empty slots.
+ *
+ * \return Seeds of buckets followed by the slots, empty if a bucket has no valid seed.
+ */
+std::vector<bst_cat_t> BuildCatHash(std::vector<bst_cat_t> const& cats, std::size_t n_buckets,
+                                    std::size_t n_slots) {
+  std::vector<std::vector<bst_cat_t>> buckets(n_buckets);
+  for (auto c : cats) {
+    auto h = common::CatHash(static_cast<std::uint32_t>(c), common::kCatBucketSeed);
+    buckets[h % n_buckets].push_back(c);
+  }
+  std::vector<std::size_t> sorted_idx(n_buckets);
+  std::iota(sorted_idx.begin(), sorted_idx.end(), 0);
+  std::stable_sort(sorted_idx.begin(), sorted_idx.end(), [&](std::size_t l, std::size_t r) {
+    return buckets[l].size() > buckets[r].size();
+  });
+
+  std::vector<bst_cat_t> table(n_buckets + n_slots, 0);
+  auto seeds = common::Span<bst_cat_t>{table}.subspan(0, n_buckets);
+  auto slots = common::Span<bst_cat_t>{table}.subspan(n_buckets);
+  std::fill(slots.begin(), slots.end(), -1);
+  std::vector<std::size_t> pos;
+  for (auto b : sorted_idx) {
+    auto const& bucket = buckets[b];
+    if (bucket.empty()) {
+      break;
+    }
+    bool found = false;
+    for (std::uint32_t seed = 1; seed < kMaxBucketSeeds && !found; ++seed) {
+      pos.clear();
+      for (auto c : bucket) {
+        std::size_t p = common::CatHash(static_cast<std::uint32_t>(c), seed) & (n_slots - 1);
+        if (slots[p] != -1 || std::find(pos.cbegin(), pos.cend(), p) != pos.cend()) {
+          break;
+        }
+        pos.push_back(p);
+      }
+      found = pos.size() == bucket.size();
+      if (found) {
+        seeds[b] = static_cast<bst_cat_t>(seed);
+        for (std::size_t i = 0; i < pos.size(); ++i) {
+          slots[pos[i]] = bucket[i];
+        }
+      }
+    }
+    if (!found) {
+      return {};
+    }
+  }
+  return table;
+}
+}  // anonymous namespace
+
+void RegTree::EncodeCategories(bst_node_t nidx) {
+  using Encoding = CategoricalSplitMatrix::Encoding;
+  CHECK_LT(static_cast<std::size_t>(nidx), split_categories_compact_ptr_.size());
+  auto& compact = split_categories_compact_ptr_[nidx];
+  compact = CategoricalSplitMatrix::Compact{};
+
+  auto bits = this->NodeCats(nidx);
+  if (bits.size() <= kMaxBitsetWords) {
+    return;
+  }
+  common::KCatBitField s_bits{bits};
+  std::vector<bst_cat_t> cats;
+  for (std::size_t i = 0; i < s_bits.Size(); ++i) {
+    if (s_bits.Check(i)) {
+      cats.push_back(static_cast<bst_cat_t>(i));
+    }
+  }
+
+  compact.beg = split_categories_compact_.size();
+  if (cats.size() <= kMaxSortedCats) {
+    compact.kind = Encoding::kSorted;
+    compact.size = cats.size();
+    split_categories_compact_.insert(split_categories_compact_.end(), cats.cbegin(), cats.cend());
+    return;
+  }
+
+  // Keep the load factor of the table under 0.5.
+  std::size_t n_slots = 1;
+  while (n_slots < cats.size() * 2) {
+    n_slots *= 2;
+  }
+  std::size_t n_buckets = common::DivRoundUp(cats.size(), kCatsPerBucket);
+  // Use the hash table only if it's smaller than the bitset.
+  if (n_buckets + n_slots >= bits.size()) {
+    compact.beg = 0;
+    return;
+  }
+  auto table = BuildCatHash(cats, n_buckets, n_slots);
+  if (table.empty()) {
+    compact.beg = 0;
+    return;
+  }
+  compact.kind = Encoding::kHash;
+  compact.size = n_buckets;
+  compact.n_slots = n_slots;
+  split_categories_compact_.insert(split_categories_compact_.end(), table.cbegin(), table.cend());
 }
 
 void RegTree::Load(dmlc::Stream* fi) {
@@ -882,6 +1002,7 @@ void RegTree::Load(dmlc::Stream* fi) {
 
   split_types_.resize(param_.num_nodes, FeatureType::kNumerical);
   split_categories_segments_.resize(param_.num_nodes);
+  split_categories_compact_ptr_.resize(param_.num_nodes);
 }
 
 void RegTree::Save(dmlc::Stream* fo) const {
@@ -938,6 +1059,7 @@ void RegTree::LoadCategoricalSplit(Json const& in) {
   // so far.
   split_types_.resize(n_nodes, FeatureType::kNumerical);
   split_categories_segments_.resize(n_nodes);
+  split_categories_compact_ptr_.resize(n_nodes);
   for (bst_node_t nidx = 0; nidx < n_nodes; ++nidx) {
     split_types_[nidx] = static_cast<FeatureType>(GetElem<Integer>(split_type, nidx));
     if (nidx == last_cat_node) {
@@ -967,6 +1089,7 @@ void RegTree::LoadCategoricalSplit(Json const& in) {
                 split_categories_.begin() + begin);
       split_categories_segments_[nidx].beg = begin;
       split_categories_segments_[nidx].size = cat_bits_storage.size();
+      this->EncodeCategories(nidx);
 
       ++cnt;
       if (cnt == categories_nodes.size()) {
@@ -1113,6 +1236,7 @@ void RegTree::LoadModel(Json const& in) {
 
   if (!has_cat) {
     this->split_categories_segments_.resize(this->param_.num_nodes);
+    this->split_categories_compact_ptr_.resize(this->param_.num_nodes);
     this->split_types_.resize(this->param_.num_nodes);
     std::fill(split_types_.begin(), split_types_.end(), FeatureType::kNumerical);
   }
@@ -1214,13 +1338,13 @@ void RegTree::SaveModel(Json* p_out) const {
 }
 
 void RegTree::CalculateContributionsApprox(const RegTree::FVec &feat,
-                                           std::vector<float>* mean_values,
+                                           std::vector<float> const &mean_values,
                                            bst_float *out_contribs) const {
-  CHECK_GT(mean_values->size(), 0U);
+  CHECK_GT(mean_values.size(), 0U);
   // this follows the idea of http://blog.datadive.net/interpreting-random-forests/
   unsigned split_index = 0;
   // update bias value
-  bst_float node_value = (*mean_values)[0];
+  bst_float node_value = mean_values[0];
   out_contribs[feat.Size()] += node_value;
   if ((*this)[0].IsLeaf()) {
     // nothing to do anymore
@@ -1235,7 +1359,7 @@ void RegTree::CalculateContributionsApprox(const RegTree::FVec &feat,
     nid = predictor::GetNextNode<true, true>((*this)[nid], nid,
                                              feat.GetFvalue(split_index),
                                              feat.IsMissing(split_index), cats);
-    bst_float new_value = (*mean_values)[nid];
+    bst_float new_value = mean_values[nid];
     // update feature weight
     out_contribs[split_index] += new_value - node_value;
     node_value = new_value;
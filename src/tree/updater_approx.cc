@@ -32,7 +32,10 @@ DMLC_REGISTRY_FILE_TAG(updater_approx);
 namespace {
 // Return the BatchParam used by DMatrix.
 auto BatchSpec(TrainParam const &p, common::Span<float> hess, ObjInfo const task) {
-  return BatchParam{p.max_bin, hess, !task.const_hess};
+  auto spec = BatchParam{p.max_bin, hess, !task.const_hess};
+  // Cuts are synchronized between workers only by sketching.
+  spec.rebin_tolerance = collective::IsDistributed() ? 0.0 : p.rebin_tolerance;
+  return spec;
 }
 
 auto BatchSpec(TrainParam const &p, common::Span<float> hess) {
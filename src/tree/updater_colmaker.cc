@@ -262,7 +262,7 @@ class ColMaker: public TreeUpdater {
       const MetaInfo& info = fmat.Info();
       // setup position
       common::ParallelFor(info.num_row_, ctx_->Threads(), [&](auto ridx) {
-        int32_t const tid = omp_get_thread_num();
+        int32_t const tid = common::ThreadIdx();
         if (position_[ridx] < 0) return;
         stemp_[tid][position_[ridx]].stats.Add(gpair[ridx]);
       });
@@ -445,7 +445,7 @@ class ColMaker: public TreeUpdater {
           num_features, ctx_->Threads(), common::Sched::Dyn(batch_size), [&](auto i) {
             auto evaluator = tree_evaluator_.GetEvaluator();
             bst_feature_t const fid = feat_set[i];
-            int32_t const tid = omp_get_thread_num();
+            int32_t const tid = common::ThreadIdx();
             auto c = page[fid];
             const bool ind = c.size() != 0 && c[0].fvalue == c[c.size() - 1].fvalue;
             if (colmaker_train_param_.NeedForwardSearch(column_densities_[fid], ind)) {
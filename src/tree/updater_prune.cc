@@ -6,8 +6,11 @@
  */
 #include <xgboost/tree_updater.h>
 
+#include <cstddef>
 #include <memory>
+#include <vector>
 
+#include "../common/threading_utils.h"
 #include "../common/timer.h"
 #include "./param.h"
 #include "xgboost/base.h"
@@ -35,8 +38,14 @@ class TreePruner : public TreeUpdater {
               common::Span<HostDeviceVector<bst_node_t>> out_position,
               const std::vector<RegTree*>& trees) override {
     pruner_monitor_.Start("PrunerUpdate");
-    for (auto tree : trees) {
-      this->DoPrune(param, tree);
+    // Trees are independent of each other.
+    std::vector<bst_node_t> npruned(trees.size());
+    common::ParallelFor(trees.size(), ctx_->Threads(),
+                        [&](auto i) { npruned[i] = this->DoPrune(param, trees[i]); });
+    for (std::size_t i = 0; i < trees.size(); ++i) {
+      auto const& tree = *trees[i];
+      LOG(INFO) << "tree pruning end, " << tree.NumExtraNodes() << " extra nodes, " << npruned[i]
+                << " pruned nodes, max_depth=" << tree.MaxDepth();
     }
     syncher_->Update(param, gpair, p_fmat, out_position, trees);
     pruner_monitor_.Stop("PrunerUpdate");
@@ -68,8 +77,8 @@ class TreePruner : public TreeUpdater {
       return npruned;
     }
   }
-  /*! \brief do pruning of a tree */
-  void DoPrune(TrainParam const* param, RegTree* p_tree) {
+  /*! \brief do pruning of a tree, returns the number of pruned nodes */
+  bst_node_t DoPrune(TrainParam const* param, RegTree* p_tree) {
     auto& tree = *p_tree;
     bst_node_t npruned = 0;
     for (int nid = 0; nid < tree.NumNodes(); ++nid) {
@@ -77,9 +86,7 @@ class TreePruner : public TreeUpdater {
         npruned = this->TryPruneLeaf(param, p_tree, nid, tree.GetDepth(nid), npruned);
       }
     }
-    LOG(INFO) << "tree pruning end, "
-              << tree.NumExtraNodes() << " extra nodes, " << npruned
-              << " pruned nodes, max_depth=" << tree.MaxDepth();
+    return npruned;
   }
 
  private:
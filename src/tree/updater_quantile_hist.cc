@@ -7,6 +7,7 @@
 #include <algorithm>                         // for max, copy, transform
 #include <cstddef>                           // for size_t
 #include <cstdint>                           // for uint32_t, int32_t
+#include <limits>                            // for numeric_limits
 #include <memory>                            // for unique_ptr, allocator, make_unique, shared_ptr
 #include <numeric>                           // for accumulate
 #include <ostream>                           // for basic_ostream, char_traits, operator<<
@@ -19,12 +20,11 @@
 #include "../common/hist_util.h"             // for HistogramCuts, HistCollection
 #include "../common/linalg_op.h"             // for begin, cbegin, cend
 #include "../common/random.h"                // for ColumnSampler
-#include "../common/threading_utils.h"       // for ParallelFor
+#include "../common/threading_utils.h"       // for ParallelFor, ThreadIdx
 #include "../common/timer.h"                 // for Monitor
 #include "../common/transform_iterator.h"    // for IndexTransformIter, MakeIndexTransformIter
 #include "../data/gradient_index.h"          // for GHistIndexMatrix
 #include "common_row_partitioner.h"          // for CommonRowPartitioner
-#include "dmlc/omp.h"                        // for omp_get_thread_num
 #include "dmlc/registry.h"                   // for DMLC_REGISTRY_FILE_TAG
 #include "driver.h"                          // for Driver
 #include "hist/evaluate_splits.h"            // for HistEvaluator, HistMultiEvaluator, UpdatePre...
@@ -48,7 +48,12 @@ namespace xgboost::tree {
 
 DMLC_REGISTRY_FILE_TAG(updater_quantile_hist);
 
-BatchParam HistBatch(TrainParam const *param) { return {param->max_bin, param->sparse_threshold}; }
+BatchParam HistBatch(TrainParam const *param) {
+  // The column matrix is not built when the sparse threshold is NaN.
+  auto sparse_thresh = param->column_matrix ? param->sparse_threshold
+                                            : std::numeric_limits<double>::quiet_NaN();
+  return {param->max_bin, sparse_thresh};
+}
 
 template <typename ExpandEntry, typename Updater>
 void UpdateTree(common::Monitor *monitor_, linalg::MatrixView<GradientPair const> gpair,
@@ -119,8 +124,8 @@ class MultiTargetHistBuilder {
   TrainParam const *param_{nullptr};
   std::shared_ptr<common::ColumnSampler> col_sampler_;
   std::unique_ptr<HistMultiEvaluator> evaluator_;
-  // Histogram builder for each target.
-  std::vector<HistogramBuilder<MultiExpandEntry>> histogram_builder_;
+  // Histogram builder for all targets, the layout of each node histogram is [bin][target].
+  HistogramBuilder<MultiExpandEntry> histogram_builder_;
   Context const *ctx_{nullptr};
   // Partitioner for each data batch.
   std::vector<CommonRowPartitioner> partitioner_;
@@ -164,12 +169,8 @@ class MultiTargetHistBuilder {
     }
 
     bst_target_t n_targets = p_tree->NumTargets();
-    histogram_builder_.clear();
-    for (std::size_t i = 0; i < n_targets; ++i) {
-      histogram_builder_.emplace_back();
-      histogram_builder_.back().Reset(n_total_bins, HistBatch(param_), ctx_->Threads(), page_id,
-                                      collective::IsDistributed(), p_fmat->Info().IsColumnSplit());
-    }
+    histogram_builder_.Reset(n_total_bins * n_targets, HistBatch(param_), ctx_->Threads(), page_id,
+                             collective::IsDistributed(), p_fmat->Info().IsColumnSplit());
 
     evaluator_ = std::make_unique<HistMultiEvaluator>(ctx_, p_fmat->Info(), param_, col_sampler_);
     p_last_tree_ = p_tree;
@@ -190,7 +191,7 @@ class MultiTargetHistBuilder {
     auto h_root_sum_tloc = root_sum_tloc.HostView();
     common::ParallelFor(gpair.Shape(0), ctx_->Threads(), [&](auto i) {
       for (bst_target_t t{0}; t < n_targets; ++t) {
-        h_root_sum_tloc(omp_get_thread_num(), t) += GradientPairPrecise{gpair(i, t)};
+        h_root_sum_tloc(common::ThreadIdx(), t) += GradientPairPrecise{gpair(i, t)};
       }
     });
     // Aggregate to the first row.
@@ -208,11 +209,8 @@ class MultiTargetHistBuilder {
     std::size_t i = 0;
     auto space = ConstructHistSpace(partitioner_, nodes);
     for (auto const &page : p_fmat->GetBatches<GHistIndexMatrix>(ctx_, HistBatch(param_))) {
-      for (bst_target_t t{0}; t < n_targets; ++t) {
-        auto t_gpair = gpair.Slice(linalg::All(), t);
-        histogram_builder_[t].BuildHist(i, space, page, p_tree, partitioner_.at(i).Partitions(),
-                                        nodes, {}, t_gpair.Values());
-      }
+      histogram_builder_.BuildHist(i, space, page, p_tree, partitioner_.at(i).Partitions(),
+                                   nodes, {}, gpair);
       i++;
     }
 
@@ -222,12 +220,8 @@ class MultiTargetHistBuilder {
                    [&](float w) { return w * param_->learning_rate; });
 
     p_tree->SetLeaf(RegTree::kRoot, weight_t);
-    std::vector<common::HistCollection const *> hists;
-    for (bst_target_t t{0}; t < p_tree->NumTargets(); ++t) {
-      hists.push_back(&histogram_builder_[t].Histogram());
-    }
     for (auto const &gmat : p_fmat->GetBatches<GHistIndexMatrix>(ctx_, HistBatch(param_))) {
-      evaluator_->EvaluateSplits(*p_tree, hists, gmat.cut, &nodes);
+      evaluator_->EvaluateSplits(*p_tree, histogram_builder_.Histogram(), gmat.cut, &nodes);
       break;
     }
     monitor_->Stop(__func__);
@@ -265,13 +259,8 @@ class MultiTargetHistBuilder {
     std::size_t i = 0;
     auto space = ConstructHistSpace(partitioner_, nodes_to_build);
     for (auto const &page : p_fmat->GetBatches<GHistIndexMatrix>(ctx_, HistBatch(param_))) {
-      for (std::size_t t = 0; t < p_tree->NumTargets(); ++t) {
-        auto t_gpair = gpair.Slice(linalg::All(), t);
-        // Make sure the gradient matrix is f-order.
-        CHECK(t_gpair.Contiguous());
-        histogram_builder_[t].BuildHist(i, space, page, p_tree, partitioner_.at(i).Partitions(),
-                                        nodes_to_build, nodes_to_sub, t_gpair.Values());
-      }
+      histogram_builder_.BuildHist(i, space, page, p_tree, partitioner_.at(i).Partitions(),
+                                   nodes_to_build, nodes_to_sub, gpair);
       i++;
     }
     monitor_->Stop(__func__);
@@ -280,12 +269,8 @@ class MultiTargetHistBuilder {
   void EvaluateSplits(DMatrix *p_fmat, RegTree const *p_tree,
                       std::vector<MultiExpandEntry> *best_splits) {
     monitor_->Start(__func__);
-    std::vector<common::HistCollection const *> hists;
-    for (bst_target_t t{0}; t < p_tree->NumTargets(); ++t) {
-      hists.push_back(&histogram_builder_[t].Histogram());
-    }
     for (auto const &gmat : p_fmat->GetBatches<GHistIndexMatrix>(ctx_, HistBatch(param_))) {
-      evaluator_->EvaluateSplits(*p_tree, hists, gmat.cut, best_splits);
+      evaluator_->EvaluateSplits(*p_tree, histogram_builder_.Histogram(), gmat.cut, best_splits);
       break;
     }
     monitor_->Stop(__func__);
@@ -577,14 +562,17 @@ class QuantileHistMaker : public TreeUpdater {
     auto h_sample_out = h_gpair;
     auto need_copy = [&] { return trees.size() > 1 || n_targets > 1; };
     if (need_copy()) {
-      // allocate buffer
-      sample_out = decltype(sample_out){h_gpair.Shape(), ctx_->gpu_id, linalg::Order::kF};
+      // allocate buffer, multi-target trees build histograms for all targets at once from
+      // the row-major gradient, others use a column slice for each target.
+      auto order = trees.front()->IsMultiTarget() ? linalg::Order::kC : linalg::Order::kF;
+      sample_out = decltype(sample_out){h_gpair.Shape(), ctx_->gpu_id, order};
       h_sample_out = sample_out.HostView();
     }
 
     for (auto tree_it = trees.begin(); tree_it != trees.end(); ++tree_it) {
       if (need_copy()) {
-        // Copy gradient into buffer for sampling. This converts C-order to F-order.
+        // Copy gradient into buffer for sampling. This converts C-order to F-order for
+        // single-target trees.
         std::copy(linalg::cbegin(h_gpair), linalg::cend(h_gpair), linalg::begin(h_sample_out));
       }
       SampleGradient(ctx_, *param, h_sample_out);
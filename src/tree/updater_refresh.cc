@@ -6,15 +6,17 @@
  */
 #include <xgboost/tree_updater.h>
 
-#include <limits>
+#include <algorithm>
+#include <cstddef>
 #include <vector>
 
 #include "../collective/communicator-inl.h"
 #include "../common/io.h"
 #include "../common/threading_utils.h"
-#include "../predictor/predict_fn.h"
+#include "../predictor/cpu_predictor.h"
 #include "./param.h"
 #include "xgboost/json.h"
+#include "xgboost/linalg.h"
 
 namespace xgboost::tree {
 
@@ -22,6 +24,9 @@ DMLC_REGISTRY_FILE_TAG(updater_refresh);
 
 /*! \brief pruner that prunes a tree after growing finishes */
 class TreeRefresher : public TreeUpdater {
+  // Maximum number of leaf indices held in memory.
+  static std::size_t constexpr kMaxLeafBufferSize = std::size_t{1} << 22;
+
  public:
   explicit TreeRefresher(Context const *ctx) : TreeUpdater(ctx) {}
   void Configure(const Args &) override {}
@@ -36,89 +41,85 @@ class TreeRefresher : public TreeUpdater {
               const std::vector<RegTree *> &trees) override {
     if (trees.size() == 0) return;
     const std::vector<GradientPair> &gpair_h = gpair->ConstHostVector();
-    // thread temporal space
-    std::vector<std::vector<GradStats> > stemp;
-    std::vector<RegTree::FVec> fvec_temp;
-    // setup temp space for each thread
-    const int nthread = ctx_->Threads();
-    fvec_temp.resize(nthread, RegTree::FVec());
-    stemp.resize(nthread, std::vector<GradStats>());
-    dmlc::OMPException exc;
-#pragma omp parallel num_threads(nthread)
-    {
-      exc.Run([&]() {
-        int tid = omp_get_thread_num();
-        int num_nodes = 0;
-        for (auto tree : trees) {
-          num_nodes += tree->NumNodes();
-        }
-        stemp[tid].resize(num_nodes, GradStats());
-        std::fill(stemp[tid].begin(), stemp[tid].end(), GradStats());
-        fvec_temp[tid].Init(trees[0]->NumFeatures());
-      });
+    // Offset of the statistics for each tree.
+    std::vector<std::size_t> node_ptr(trees.size() + 1, 0);
+    for (std::size_t i = 0; i < trees.size(); ++i) {
+      node_ptr[i + 1] = node_ptr[i] + trees[i]->NumNodes();
     }
-    exc.Rethrow();
-    // if it is C++11, use lazy evaluation for Allreduce,
-    // to gain speedup in recovery
-    auto lazy_get_stats = [&]() {
-      const MetaInfo &info = p_fmat->Info();
-      // start accumulating statistics
-      for (const auto &batch : p_fmat->GetBatches<SparsePage>()) {
-        auto page = batch.GetView();
-        CHECK_LT(batch.Size(), std::numeric_limits<unsigned>::max());
-        const auto nbatch = static_cast<bst_omp_uint>(batch.Size());
-        common::ParallelFor(nbatch, ctx_->Threads(), [&](bst_omp_uint i) {
-          SparsePage::Inst inst = page[i];
-          const int tid = omp_get_thread_num();
-          const auto ridx = static_cast<bst_uint>(batch.base_rowid + i);
-          RegTree::FVec &feats = fvec_temp[tid];
-          feats.Fill(inst);
-          int offset = 0;
-          for (auto tree : trees) {
-            AddStats(*tree, feats, gpair_h, info, ridx,
-                     dmlc::BeginPtr(stemp[tid]) + offset);
-            offset += tree->NumNodes();
-          }
-          feats.Drop();
-        });
+    std::vector<GradStats> stats(node_ptr.back());
+    this->AddLeafStats(gpair_h, p_fmat, trees, node_ptr, &stats);
+    collective::Allreduce<collective::Operation::kSum>(&dmlc::BeginPtr(stats)->sum_grad,
+                                                       stats.size() * 2);
+    common::ParallelFor(trees.size(), ctx_->Threads(), [&](auto i) {
+      auto *gstats = dmlc::BeginPtr(stats) + node_ptr[i];
+      SumSubtree(*trees[i], RegTree::kRoot, gstats);
+      this->Refresh(param, gstats, RegTree::kRoot, trees[i]);
+    });
+  }
+
+ private:
+  /**
+   * \brief Accumulate the gradient of each row into the leaf it reaches.  Leaf indices are
+   *        obtained with the blocked leaf prediction for a chunk of rows at a time.
+   *
+   *   When there are at least as many trees as threads, each tree is accumulated by a
+   *   single thread.  Otherwise, rows are split among threads, each thread accumulates into
+   *   its own copy of the statistics and the copies are reduced afterwards.
+   */
+  void AddLeafStats(std::vector<GradientPair> const &gpair, DMatrix *p_fmat,
+                    std::vector<RegTree *> const &trees, std::vector<std::size_t> const &node_ptr,
+                    std::vector<GradStats> *p_stats) const {
+    auto &stats = *p_stats;
+    std::vector<RegTree const *> const_trees(trees.cbegin(), trees.cend());
+    auto n_trees = trees.size();
+    auto n_nodes = node_ptr.back();
+    auto n_features = trees.front()->NumFeatures();
+    auto n_threads = static_cast<std::size_t>(ctx_->Threads());
+    bool by_tree = n_trees >= n_threads;
+    // Thread local statistics, only used when rows are split among threads.
+    std::vector<GradStats> tloc(by_tree ? 0 : n_threads * n_nodes);
+    // Limit the size of the leaf index buffer.
+    auto n_rows_per_chunk = std::max<std::size_t>(1, kMaxLeafBufferSize / n_trees);
+    for (auto const &batch : p_fmat->GetBatches<SparsePage>()) {
+      for (std::size_t beg = 0; beg < batch.Size(); beg += n_rows_per_chunk) {
+        auto n_rows = std::min(n_rows_per_chunk, batch.Size() - beg);
+        // Column-major, so rows of the same tree are contiguous.
+        linalg::Matrix<bst_node_t> leaf{{n_rows, n_trees}, Context::kCpuId, linalg::Order::kF};
+        auto h_leaf = leaf.HostView();
+        predictor::PredictLeafByBlockOfRows(ctx_, batch, beg, n_features, const_trees, h_leaf);
+        auto row_begin = batch.base_rowid + beg;
+        if (by_tree) {
+          common::ParallelFor(n_trees, ctx_->Threads(), [&](auto t) {
+            auto *gstats = dmlc::BeginPtr(stats) + node_ptr[t];
+            for (std::size_t i = 0; i < n_rows; ++i) {
+              gstats[h_leaf(i, t)].Add(gpair[row_begin + i]);
+            }
+          });
+        } else {
+          common::ParallelFor(n_rows, ctx_->Threads(), [&](auto i) {
+            auto *gstats = dmlc::BeginPtr(tloc) + common::ThreadIdx() * n_nodes;
+            for (std::size_t t = 0; t < n_trees; ++t) {
+              gstats[node_ptr[t] + h_leaf(i, t)].Add(gpair[row_begin + i]);
+            }
+          });
+        }
       }
-      // aggregate the statistics
-      auto num_nodes = static_cast<int>(stemp[0].size());
-      common::ParallelFor(num_nodes, ctx_->Threads(), [&](int nid) {
-        for (int tid = 1; tid < nthread; ++tid) {
-          stemp[0][nid].Add(stemp[tid][nid]);
+    }
+    if (!by_tree) {
+      common::ParallelFor(n_nodes, ctx_->Threads(), [&](auto nidx) {
+        for (std::size_t tid = 0; tid < n_threads; ++tid) {
+          stats[nidx].Add(tloc[tid * n_nodes + nidx]);
         }
       });
-    };
-    lazy_get_stats();
-    collective::Allreduce<collective::Operation::kSum>(&dmlc::BeginPtr(stemp[0])->sum_grad,
-                                                       stemp[0].size() * 2);
-    int offset = 0;
-    for (auto tree : trees) {
-      this->Refresh(param, dmlc::BeginPtr(stemp[0]) + offset, 0, tree);
-      offset += tree->NumNodes();
     }
   }
-
- private:
-  inline static void AddStats(const RegTree &tree,
-                              const RegTree::FVec &feat,
-                              const std::vector<GradientPair> &gpair,
-                              const MetaInfo&,
-                              const bst_uint ridx,
-                              GradStats *gstats) {
-    // start from groups that belongs to current data
-    auto pid = 0;
-    gstats[pid].Add(gpair[ridx]);
-    auto const& cats = tree.GetCategoriesMatrix();
-    // traverse tree
-    while (!tree[pid].IsLeaf()) {
-      unsigned split_index = tree[pid].SplitIndex();
-      pid = predictor::GetNextNode<true, true>(
-          tree[pid], pid, feat.GetFvalue(split_index), feat.IsMissing(split_index),
-          cats);
-      gstats[pid].Add(gpair[ridx]);
+  // Sum the statistics of leaves into their ancestors.
+  static GradStats const &SumSubtree(RegTree const &tree, bst_node_t nid, GradStats *gstats) {
+    if (!tree[nid].IsLeaf()) {
+      gstats[nid] = SumSubtree(tree, tree[nid].LeftChild(), gstats);
+      gstats[nid].Add(SumSubtree(tree, tree[nid].RightChild(), gstats));
     }
+    return gstats[nid];
   }
   inline void Refresh(TrainParam const *param, const GradStats *gstats, int nid, RegTree *p_tree) {
     RegTree &tree = *p_tree;
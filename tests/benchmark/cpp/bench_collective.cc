@@ -0,0 +1,51 @@
+/**
+ * Copyright 2023 by XGBoost contributors
+ */
+#include <benchmark/benchmark.h>
+
+#include <cstddef>  // for size_t
+#include <cstdint>  // for int32_t
+#include <thread>   // for thread
+#include <vector>   // for vector
+
+#include "../../../src/collective/communicator.h"            // for DataType, Operation
+#include "../../../src/collective/in_memory_communicator.h"  // for InMemoryCommunicator
+
+namespace xgboost::collective {
+namespace {
+std::int32_t constexpr kWorldSize = 4;
+std::int32_t constexpr kRounds = 16;
+
+/**
+ * \brief Sum a buffer of doubles across workers running in threads, the size of the
+ *        buffer is the number of elements in a histogram.
+ */
+void InMemoryAllreduce(benchmark::State& state) {
+  auto n = static_cast<std::size_t>(state.range(0));
+  for (auto _ : state) {
+    std::vector<std::thread> workers;
+    for (std::int32_t rank = 0; rank < kWorldSize; ++rank) {
+      workers.emplace_back([=] {
+        InMemoryCommunicator comm{kWorldSize, rank};
+        std::vector<double> buffer(n, static_cast<double>(rank));
+        for (std::int32_t i = 0; i < kRounds; ++i) {
+          comm.AllReduce(buffer.data(), buffer.size(), DataType::kDouble, Operation::kSum);
+        }
+        benchmark::DoNotOptimize(buffer.data());
+      });
+    }
+    for (auto& t : workers) {
+      t.join();
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * kRounds);
+  state.SetBytesProcessed(state.iterations() * kRounds * n * sizeof(double));
+}
+}  // anonymous namespace
+
+BENCHMARK(InMemoryAllreduce)
+    ->RangeMultiplier(16)
+    ->Range(1 << 8, 1 << 20)
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+}  // namespace xgboost::collective
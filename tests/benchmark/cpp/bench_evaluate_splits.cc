@@ -0,0 +1,73 @@
+/**
+ * Copyright 2023 by XGBoost contributors
+ */
+#include <benchmark/benchmark.h>
+#include <xgboost/base.h>        // for GradientPairPrecise, Args
+#include <xgboost/context.h>     // for Context
+#include <xgboost/data.h>        // for BatchParam
+#include <xgboost/tree_model.h>  // for RegTree
+
+#include <cstddef>  // for size_t
+#include <memory>   // for make_shared
+#include <numeric>  // for iota
+#include <vector>   // for vector
+
+#include "../../../src/common/hist_util.h"           // for GHistBuilder, HistCollection
+#include "../../../src/common/random.h"              // for ColumnSampler
+#include "../../../src/common/row_set.h"             // for RowSetCollection
+#include "../../../src/data/gradient_index.h"        // for GHistIndexMatrix
+#include "../../../src/tree/hist/evaluate_splits.h"  // for HistEvaluator
+#include "../../../src/tree/hist/expand_entry.h"     // for CPUExpandEntry
+#include "../../../src/tree/param.h"                 // for TrainParam, GradStats
+#include "helpers.h"                                 // for CachedDMatrix, GenerateGradients
+
+namespace xgboost::tree {
+namespace {
+std::size_t constexpr kRows = 1 << 14;
+
+/**
+ * \brief Find the best split of the root node from its histogram.
+ */
+void EvaluateSplits(benchmark::State& state, bst_feature_t n_features, bst_bin_t max_bin) {
+  Context ctx;
+  ctx.UpdateAllowUnknown(Args{});
+  TrainParam param;
+  param.UpdateAllowUnknown(Args{});
+
+  auto p_fmat = bench::CachedDMatrix(kRows, n_features, 0.0f);
+  auto const& gmat = *p_fmat->GetBatches<GHistIndexMatrix>(&ctx, BatchParam{max_bin, 0.5}).begin();
+  auto gpair = bench::GenerateGradients(kRows);
+
+  std::vector<std::size_t> rows(kRows);
+  std::iota(rows.begin(), rows.end(), 0);
+  auto n_bins = gmat.cut.Ptrs().back();
+  common::HistCollection hist;
+  hist.Init(n_bins);
+  hist.AddHistRow(RegTree::kRoot);
+  hist.AllocateAllData();
+  common::GHistBuilder builder{n_bins};
+  builder.BuildHist<false>(gpair, {rows.data(), rows.data() + rows.size(), RegTree::kRoot}, gmat,
+                           hist[RegTree::kRoot]);
+
+  GradientPairPrecise root_sum;
+  for (auto const& g : gpair) {
+    root_sum += GradientPairPrecise{g};
+  }
+
+  RegTree tree;
+  HistEvaluator evaluator{&ctx, &param, p_fmat->Info(), std::make_shared<common::ColumnSampler>()};
+  std::vector<CPUExpandEntry> entries(1);
+  for (auto _ : state) {
+    entries.front() = CPUExpandEntry{RegTree::kRoot, 0};
+    evaluator.InitRoot(GradStats{root_sum});
+    evaluator.EvaluateSplits(hist, gmat.cut, {}, tree, &entries);
+    benchmark::DoNotOptimize(entries.front().split.loss_chg);
+  }
+  state.SetItemsProcessed(state.iterations() * n_bins);
+}
+}  // anonymous namespace
+
+BENCHMARK_CAPTURE(EvaluateSplits, f64_bin256, 64, 256)->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(EvaluateSplits, f512_bin256, 512, 256)->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(EvaluateSplits, f64_bin1024, 64, 1024)->Unit(benchmark::kMicrosecond);
+}  // namespace xgboost::tree
@@ -0,0 +1,63 @@
+/**
+ * Copyright 2023 by XGBoost contributors
+ */
+#include <benchmark/benchmark.h>
+#include <xgboost/base.h>     // for GradientPairPrecise, bst_bin_t
+#include <xgboost/context.h>  // for Context
+#include <xgboost/data.h>     // for BatchParam
+
+#include <algorithm>  // for fill
+#include <cstddef>    // for size_t
+#include <numeric>    // for iota
+#include <vector>     // for vector
+
+#include "../../../src/common/hist_util.h"     // for GHistBuilder, GHistRow
+#include "../../../src/common/row_set.h"       // for RowSetCollection
+#include "../../../src/data/gradient_index.h"  // for GHistIndexMatrix
+#include "helpers.h"                           // for CachedDMatrix, GenerateGradients
+
+namespace xgboost::common {
+namespace {
+std::size_t constexpr kRows = 1 << 17;
+bst_feature_t constexpr kCols = 64;
+
+/**
+ * \brief Build the histogram for a node containing all rows with a single thread.
+ *
+ *   Dense data with at most 256 bins is stored as uint8, with at most 65536 bins as
+ *   uint16.  Data with missing values is always stored as uint32.
+ */
+void BuildHist(benchmark::State& state, float sparsity, bst_bin_t max_bin) {
+  Context ctx;
+  auto p_fmat = bench::CachedDMatrix(kRows, kCols, sparsity);
+  auto const& gmat = *p_fmat->GetBatches<GHistIndexMatrix>(&ctx, BatchParam{max_bin, 0.5}).begin();
+  auto gpair = bench::GenerateGradients(kRows);
+
+  std::vector<std::size_t> rows(kRows);
+  std::iota(rows.begin(), rows.end(), 0);
+  RowSetCollection::Elem elem{rows.data(), rows.data() + rows.size(), 0};
+
+  auto n_bins = gmat.cut.Ptrs().back();
+  std::vector<GradientPairPrecise> hist(n_bins);
+  GHistBuilder builder{n_bins};
+  for (auto _ : state) {
+    std::fill(hist.begin(), hist.end(), GradientPairPrecise{});
+    if (sparsity == 0.0f) {
+      builder.BuildHist<false>(gpair, elem, gmat, GHistRow{hist.data(), hist.size()});
+    } else {
+      builder.BuildHist<true>(gpair, elem, gmat, GHistRow{hist.data(), hist.size()});
+    }
+    benchmark::DoNotOptimize(hist.data());
+    benchmark::ClobberMemory();
+  }
+
+  state.SetItemsProcessed(state.iterations() * kRows);
+  state.SetBytesProcessed(state.iterations() * gmat.index.SizeBytes());
+  state.counters["bin_type_size"] = static_cast<double>(gmat.index.GetBinTypeSize());
+}
+}  // anonymous namespace
+
+BENCHMARK_CAPTURE(BuildHist, dense_uint8, 0.0f, 256)->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BuildHist, dense_uint16, 0.0f, 1024)->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BuildHist, sparse_uint32, 0.4f, 256)->Unit(benchmark::kMillisecond);
+}  // namespace xgboost::common
@@ -0,0 +1,50 @@
+/**
+ * Copyright 2023 by XGBoost contributors
+ */
+#include <benchmark/benchmark.h>
+#include <xgboost/json.h>         // for Json
+#include <xgboost/learner.h>      // for Learner
+#include <xgboost/string_view.h>  // for StringView
+
+#include <ios>     // for ios
+#include <memory>  // for unique_ptr
+#include <vector>  // for vector
+
+#include "helpers.h"  // for CachedModel
+
+namespace xgboost {
+namespace {
+/**
+ * \brief Parse a serialized model and load it into a booster.
+ */
+void LoadModel(benchmark::State& state, std::ios::openmode mode) {
+  std::vector<char> buffer;
+  Json::Dump(bench::CachedModel(), &buffer, mode);
+  for (auto _ : state) {
+    auto model = Json::Load(StringView{buffer.data(), buffer.size()}, mode);
+    std::unique_ptr<Learner> learner{Learner::Create({})};
+    learner->LoadModel(model);
+    benchmark::DoNotOptimize(learner.get());
+  }
+  state.SetBytesProcessed(state.iterations() * buffer.size());
+}
+
+/**
+ * \brief Parse a serialized model into a JSON document.
+ */
+void ParseModel(benchmark::State& state, std::ios::openmode mode) {
+  std::vector<char> buffer;
+  Json::Dump(bench::CachedModel(), &buffer, mode);
+  for (auto _ : state) {
+    auto model = Json::Load(StringView{buffer.data(), buffer.size()}, mode);
+    benchmark::DoNotOptimize(model);
+  }
+  state.SetBytesProcessed(state.iterations() * buffer.size());
+}
+}  // anonymous namespace
+
+BENCHMARK_CAPTURE(ParseModel, json, std::ios::in)->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(ParseModel, ubj, std::ios::binary)->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(LoadModel, json, std::ios::in)->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(LoadModel, ubj, std::ios::binary)->Unit(benchmark::kMillisecond);
+}  // namespace xgboost
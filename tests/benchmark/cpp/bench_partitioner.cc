@@ -0,0 +1,56 @@
+/**
+ * Copyright 2023 by XGBoost contributors
+ */
+#include <benchmark/benchmark.h>
+#include <xgboost/context.h>     // for Context
+#include <xgboost/data.h>        // for BatchParam
+#include <xgboost/tree_model.h>  // for RegTree
+
+#include <cstddef>  // for size_t
+#include <vector>   // for vector
+
+#include "../../../src/data/gradient_index.h"          // for GHistIndexMatrix
+#include "../../../src/tree/common_row_partitioner.h"  // for CommonRowPartitioner
+#include "../../../src/tree/hist/expand_entry.h"       // for CPUExpandEntry
+#include "../../../src/tree/param.h"                   // for GradStats
+#include "helpers.h"                                   // for CachedDMatrix
+
+namespace xgboost::tree {
+namespace {
+std::size_t constexpr kRows = 1 << 20;
+bst_feature_t constexpr kCols = 16;
+
+/**
+ * \brief Partition all rows of the root node with the `PartitionBuilder` used by hist.
+ */
+void UpdatePosition(benchmark::State& state, float sparsity) {
+  Context ctx;
+  ctx.UpdateAllowUnknown(Args{});
+  auto p_fmat = bench::CachedDMatrix(kRows, kCols, sparsity);
+  auto const& gmat = *p_fmat->GetBatches<GHistIndexMatrix>(&ctx, BatchParam{256, 0.5}).begin();
+
+  // Split the first feature at its median bin.
+  bst_feature_t constexpr kSplitFeature = 0;
+  auto const& ptrs = gmat.cut.Ptrs();
+  auto split_value = gmat.cut.Values()[(ptrs[kSplitFeature] + ptrs[kSplitFeature + 1]) / 2];
+  RegTree tree;
+  tree.ExpandNode(RegTree::kRoot, kSplitFeature, split_value, true, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f,
+                  0.0f, 0.0f);
+  std::vector<CPUExpandEntry> candidates{{RegTree::kRoot, 0}};
+  candidates.front().split.Update(1.0f, kSplitFeature, split_value, true, false, GradStats{},
+                                  GradStats{});
+
+  for (auto _ : state) {
+    state.PauseTiming();
+    CommonRowPartitioner partitioner{&ctx, kRows, 0, false};
+    state.ResumeTiming();
+    partitioner.UpdatePosition(&ctx, gmat, candidates, &tree);
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * kRows);
+}
+}  // anonymous namespace
+
+BENCHMARK_CAPTURE(UpdatePosition, dense, 0.0f)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK_CAPTURE(UpdatePosition, sparse, 0.4f)->Unit(benchmark::kMillisecond)->UseRealTime();
+}  // namespace xgboost::tree
@@ -0,0 +1,82 @@
+/**
+ * Copyright 2023 by XGBoost contributors
+ */
+#include <benchmark/benchmark.h>
+#include <xgboost/context.h>    // for Context
+#include <xgboost/data.h>       // for SparsePage
+#include <xgboost/json.h>       // for Json, get
+#include <xgboost/learner.h>    // for LearnerModelParam
+#include <xgboost/linalg.h>     // for Tensor
+#include <xgboost/predictor.h>  // for Predictor, PredictionCacheEntry
+
+#include <cstddef>  // for size_t
+#include <memory>   // for unique_ptr, make_unique
+#include <vector>   // for vector
+
+#include "../../../src/gbm/gbtree_model.h"  // for GBTreeModel
+#include "helpers.h"                        // for CachedModel, CachedDMatrix
+
+namespace xgboost::predictor {
+namespace {
+class PredictorFixture {
+  Context ctx_;
+  LearnerModelParam mparam_;
+  std::unique_ptr<gbm::GBTreeModel> model_;
+  std::unique_ptr<Predictor> predictor_;
+
+ public:
+  PredictorFixture() {
+    ctx_.UpdateAllowUnknown(Args{});
+    std::size_t shape[1]{1};
+    auto const& j_model = bench::CachedModel();
+    mparam_ = LearnerModelParam{bench::kModelCols,
+                                linalg::Tensor<float, 1>{{0.5f}, shape, Context::kCpuId}, 1, 1,
+                                MultiStrategy::kOneOutputPerTree};
+    model_ = std::make_unique<gbm::GBTreeModel>(&mparam_, &ctx_);
+    model_->LoadModel(j_model["learner"]["gradient_booster"]["model"]);
+    predictor_.reset(Predictor::Create("cpu_predictor", &ctx_));
+    predictor_->Configure({});
+  }
+
+  [[nodiscard]] gbm::GBTreeModel const& Model() const { return *model_; }
+  [[nodiscard]] Predictor const& Get() const { return *predictor_; }
+};
+
+/**
+ * \brief Predict the training data with all trees.
+ */
+void PredictBatch(benchmark::State& state) {
+  PredictorFixture predictor;
+  auto p_fmat = bench::CachedDMatrix(bench::kModelRows, bench::kModelCols, 0.0f);
+  PredictionCacheEntry predts;
+  for (auto _ : state) {
+    predts.version = 0;
+    predictor.Get().InitOutPredictions(p_fmat->Info(), &predts.predictions, predictor.Model());
+    predictor.Get().PredictBatch(p_fmat.get(), &predts, predictor.Model(), 0);
+    benchmark::DoNotOptimize(predts.predictions.HostPointer());
+  }
+  state.SetItemsProcessed(state.iterations() * p_fmat->Info().num_row_);
+}
+
+/**
+ * \brief Predict one row at a time with all trees.
+ */
+void PredictInstance(benchmark::State& state) {
+  PredictorFixture predictor;
+  auto p_fmat = bench::CachedDMatrix(bench::kModelRows, bench::kModelCols, 0.0f);
+  auto const& page = *p_fmat->GetBatches<SparsePage>().begin();
+  auto batch = page.GetView();
+  std::vector<float> out;
+  std::size_t i = 0;
+  for (auto _ : state) {
+    predictor.Get().PredictInstance(batch[i], &out, predictor.Model());
+    benchmark::DoNotOptimize(out.data());
+    i = (i + 1) % batch.Size();
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+}  // anonymous namespace
+
+BENCHMARK(PredictBatch)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(PredictInstance)->Unit(benchmark::kMicrosecond);
+}  // namespace xgboost::predictor
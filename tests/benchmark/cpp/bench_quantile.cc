@@ -0,0 +1,42 @@
+/**
+ * Copyright 2023 by XGBoost contributors
+ */
+#include <benchmark/benchmark.h>
+#include <xgboost/base.h>     // for Args, bst_bin_t
+#include <xgboost/context.h>  // for Context
+
+#include <cstddef>  // for size_t
+
+#include "../../../src/common/hist_util.h"  // for SketchOnDMatrix
+#include "helpers.h"                        // for CachedDMatrix
+
+namespace xgboost::common {
+namespace {
+std::size_t constexpr kRows = 1 << 18;
+bst_feature_t constexpr kCols = 32;
+
+/**
+ * \brief Generate histogram cuts for an in-memory DMatrix.
+ */
+void SketchOnDMatrix(benchmark::State& state, float sparsity, bool use_sorted) {
+  Context ctx;
+  ctx.UpdateAllowUnknown(Args{});
+  auto p_fmat = bench::CachedDMatrix(kRows, kCols, sparsity);
+  for (auto _ : state) {
+    auto cuts = common::SketchOnDMatrix(&ctx, p_fmat.get(), 256, use_sorted);
+    benchmark::DoNotOptimize(cuts.Values().data());
+  }
+  state.SetItemsProcessed(state.iterations() * p_fmat->Info().num_nonzero_);
+}
+}  // anonymous namespace
+
+BENCHMARK_CAPTURE(SketchOnDMatrix, dense, 0.0f, false)
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+BENCHMARK_CAPTURE(SketchOnDMatrix, sparse, 0.4f, false)
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+BENCHMARK_CAPTURE(SketchOnDMatrix, dense_sorted, 0.0f, true)
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+}  // namespace xgboost::common
@@ -0,0 +1,119 @@
+/**
+ * Copyright 2023 by XGBoost contributors
+ *
+ * \brief Synthetic data for the C++ benchmarks.
+ */
+#ifndef XGBOOST_BENCHMARK_HELPERS_H_
+#define XGBOOST_BENCHMARK_HELPERS_H_
+
+#include <xgboost/base.h>     // for bst_feature_t, GradientPair, Args
+#include <xgboost/context.h>  // for Context
+#include <xgboost/data.h>     // for DMatrix
+#include <xgboost/json.h>     // for Json, Object
+#include <xgboost/learner.h>  // for Learner
+
+#include <cstddef>  // for size_t
+#include <cstdint>  // for uint64_t, int32_t
+#include <limits>   // for numeric_limits
+#include <map>      // for map
+#include <memory>   // for shared_ptr, unique_ptr
+#include <mutex>    // for mutex, lock_guard
+#include <random>   // for mt19937_64, uniform_real_distribution
+#include <tuple>    // for tuple
+#include <vector>   // for vector
+
+#include "../../../src/data/adapter.h"  // for DenseAdapter
+
+namespace xgboost::bench {
+/**
+ * \brief Generate a DMatrix with features drawn from U(0, 1).
+ *
+ * \param sparsity Fraction of missing values.
+ */
+inline std::shared_ptr<DMatrix> GenerateDMatrix(std::size_t n_samples, bst_feature_t n_features,
+                                                float sparsity, std::uint64_t seed = 0) {
+  std::mt19937_64 rng{seed};
+  std::uniform_real_distribution<float> dist{0.0f, 1.0f};
+  auto constexpr kMissing = std::numeric_limits<float>::quiet_NaN();
+
+  std::vector<float> data(n_samples * n_features);
+  for (auto& v : data) {
+    v = dist(rng);
+    if (sparsity != 0.0f && dist(rng) < sparsity) {
+      v = kMissing;
+    }
+  }
+  data::DenseAdapter adapter{data.data(), n_samples, n_features};
+  std::shared_ptr<DMatrix> p_fmat{DMatrix::Create(&adapter, kMissing, Context{}.Threads())};
+
+  auto& labels = p_fmat->Info().labels;
+  labels.Reshape(n_samples);
+  auto& h_labels = labels.Data()->HostVector();
+  for (auto& v : h_labels) {
+    v = dist(rng);
+  }
+  return p_fmat;
+}
+
+/**
+ * \brief Same as `GenerateDMatrix`, but the DMatrix is created once for each shape and
+ *        shared between benchmarks.  Google benchmark runs a case several times to
+ *        determine the number of iterations, generating data and quantiles in each run
+ *        would dominate the total time.
+ */
+inline std::shared_ptr<DMatrix> CachedDMatrix(std::size_t n_samples, bst_feature_t n_features,
+                                              float sparsity) {
+  static std::map<std::tuple<std::size_t, bst_feature_t, float>, std::shared_ptr<DMatrix>> cache;
+  static std::mutex lock;
+  std::lock_guard<std::mutex> guard{lock};
+  auto key = std::make_tuple(n_samples, n_features, sparsity);
+  auto it = cache.find(key);
+  if (it == cache.cend()) {
+    it = cache.emplace(key, GenerateDMatrix(n_samples, n_features, sparsity)).first;
+  }
+  return it->second;
+}
+
+inline std::vector<GradientPair> GenerateGradients(std::size_t n_samples,
+                                                   std::uint64_t seed = 0) {
+  std::mt19937_64 rng{seed};
+  std::uniform_real_distribution<float> dist{0.0f, 1.0f};
+  std::vector<GradientPair> gpair(n_samples);
+  for (auto& g : gpair) {
+    g = GradientPair{dist(rng) - 0.5f, dist(rng)};
+  }
+  return gpair;
+}
+
+/**
+ * \brief Train a tree model with the hist tree method.
+ */
+inline std::unique_ptr<Learner> TrainModel(std::shared_ptr<DMatrix> p_fmat, std::int32_t n_rounds,
+                                           Args const& args = {}) {
+  std::unique_ptr<Learner> learner{Learner::Create({p_fmat})};
+  learner->SetParams(Args{{"tree_method", "hist"}, {"max_depth", "6"}});
+  learner->SetParams(args);
+  for (std::int32_t i = 0; i < n_rounds; ++i) {
+    learner->UpdateOneIter(i, p_fmat);
+  }
+  return learner;
+}
+
+std::size_t constexpr kModelRows = 1 << 16;
+bst_feature_t constexpr kModelCols = 32;
+
+/**
+ * \brief A regression model with 100 trees of depth 6 trained on
+ *        `CachedDMatrix(kModelRows, kModelCols, 0)`, saved as JSON.
+ */
+inline Json const& CachedModel() {
+  static Json model = [] {
+    auto learner = TrainModel(CachedDMatrix(kModelRows, kModelCols, 0.0f), 100);
+    Json out{Object{}};
+    learner->SaveModel(&out);
+    return out;
+  }();
+  return model;
+}
+}  // namespace xgboost::bench
+#endif  // XGBOOST_BENCHMARK_HELPERS_H_
@@ -10,6 +10,7 @@
 
 #include <cstddef>  // std::size_t
 #include <limits>   // std::numeric_limits
+#include <memory>   // std::unique_ptr
 #include <string>   // std::string
 #include <vector>
 
@@ -217,6 +218,214 @@ TEST(CAPI, JsonModelIO) {
   ASSERT_EQ(XGBoosterSaveModelToBuffer(handle, R"({"format": "foo"})", &len, &data), -1);
 }
 
+TEST(CAPI, PredictInto) {
+  bst_row_t constexpr kRows = 32;
+  bst_feature_t constexpr kCols = 8;
+  std::size_t constexpr kClasses = 3;
+
+  HostDeviceVector<float> storage;
+  auto X = RandomDataGenerator{kRows, kCols, 0}.GenerateArrayInterface(&storage);
+  auto p_dmat = RandomDataGenerator{kRows, kCols, 0}.GenerateDMatrix();
+  auto &h_labels = p_dmat->Info().labels.Data()->HostVector();
+  h_labels.resize(kRows);
+  for (std::size_t i = 0; i < kRows; ++i) {
+    h_labels[i] = i % kClasses;
+  }
+  p_dmat->Info().labels.Reshape(kRows);
+
+  std::unique_ptr<Learner> learner{Learner::Create({p_dmat})};
+  learner->SetParams(
+      Args{{"objective", "multi:softprob"}, {"num_class", std::to_string(kClasses)}});
+  learner->UpdateOneIter(0, p_dmat);
+  BoosterHandle handle = learner.get();
+  DMatrixHandle dmat = &p_dmat;
+
+  Json config{Object{}};
+  config["type"] = Integer{0};
+  config["training"] = Boolean{false};
+  config["iteration_begin"] = Integer{0};
+  config["iteration_end"] = Integer{0};
+  config["strict_shape"] = Boolean{false};
+  config["cache_id"] = Integer{0};
+  config["missing"] = Number{std::numeric_limits<float>::quiet_NaN()};
+  std::string str_config;
+  Json::Dump(config, &str_config);
+
+  bst_ulong const *out_shape;
+  bst_ulong out_dim;
+  float const *out_result;
+  ASSERT_EQ(XGBoosterPredictFromDMatrix(handle, dmat, str_config.c_str(), &out_shape, &out_dim,
+                                        &out_result),
+            0);
+  ASSERT_EQ(out_dim, 2);
+  std::vector<float> expected(out_result, out_result + kRows * kClasses);
+
+  // Column-major float64 output.
+  linalg::Matrix<double> out{{kRows, kClasses}, Context::kCpuId, linalg::Order::kF};
+  auto str_out = linalg::ArrayInterfaceStr(out.HostView());
+  ASSERT_EQ(XGBoosterPredictFromDMatrixInto(handle, dmat, str_config.c_str(), str_out.c_str()), 0);
+  auto h_out = out.HostView();
+  for (std::size_t i = 0; i < kRows; ++i) {
+    for (std::size_t j = 0; j < kClasses; ++j) {
+      ASSERT_EQ(h_out(i, j), static_cast<double>(expected[i * kClasses + j]));
+    }
+  }
+
+  // Inplace prediction with float32 output.
+  linalg::Matrix<float> out_f32{{kRows, kClasses}, Context::kCpuId};
+  str_out = linalg::ArrayInterfaceStr(out_f32.HostView());
+  ASSERT_EQ(XGBoosterPredictFromDenseInto(handle, X.c_str(), str_config.c_str(), nullptr,
+                                          str_out.c_str()),
+            0);
+  auto h_out_f32 = out_f32.Data()->ConstHostVector();
+  for (std::size_t i = 0; i < expected.size(); ++i) {
+    ASSERT_NEAR(h_out_f32[i], expected[i], kRtEps);
+  }
+
+  // Fully column-major 4-dim output for SHAP interactions.
+  config["type"] = Integer{4};
+  config["strict_shape"] = Boolean{true};
+  Json::Dump(config, &str_config);
+  ASSERT_EQ(XGBoosterPredictFromDMatrix(handle, dmat, str_config.c_str(), &out_shape, &out_dim,
+                                        &out_result),
+            0);
+  ASSERT_EQ(out_dim, 4);
+  std::size_t constexpr kContribs = kCols + 1;
+  ASSERT_EQ(out_shape[1], kClasses);
+  ASSERT_EQ(out_shape[2], kContribs);
+  expected.assign(out_result, out_result + kRows * kClasses * kContribs * kContribs);
+  linalg::Tensor<float, 4> out_4d{
+      {kRows, kClasses, kContribs, kContribs}, Context::kCpuId, linalg::Order::kF};
+  str_out = linalg::ArrayInterfaceStr(out_4d.HostView());
+  ASSERT_EQ(XGBoosterPredictFromDMatrixInto(handle, dmat, str_config.c_str(), str_out.c_str()), 0);
+  auto h_out_4d = out_4d.HostView();
+  ASSERT_TRUE(h_out_4d.FContiguous());
+  for (std::size_t i = 0; i < expected.size(); ++i) {
+    auto [r, g, c0, c1] = linalg::UnravelIndex(i, h_out_4d.Shape());
+    ASSERT_EQ(h_out_4d(r, g, c0, c1), expected[i]);
+  }
+  config["type"] = Integer{0};
+  config["strict_shape"] = Boolean{false};
+  Json::Dump(config, &str_config);
+
+  // Invalid shape.
+  linalg::Matrix<float> invalid{{kRows, kClasses + 1}, Context::kCpuId};
+  str_out = linalg::ArrayInterfaceStr(invalid.HostView());
+  ASSERT_EQ(XGBoosterPredictFromDMatrixInto(handle, dmat, str_config.c_str(), str_out.c_str()), -1);
+  // Read-only buffer.
+  str_out = linalg::ArrayInterfaceStr(out_f32.View(Context::kCpuId));
+  auto j_out = Json::Load(StringView{str_out});
+  j_out["data"][1] = Boolean{true};
+  str_out.clear();
+  Json::Dump(j_out, &str_out);
+  ASSERT_EQ(XGBoosterPredictFromDMatrixInto(handle, dmat, str_config.c_str(), str_out.c_str()), -1);
+}
+
+namespace {
+struct PredictIter {
+  DMatrixHandle proxy;
+  std::vector<std::string> batches;
+  std::size_t n_batches{0};
+  std::vector<float> predt;
+  std::size_t n_outputs{0};
+};
+
+int PredictIterNext(DataIterHandle handle) {
+  auto *iter = static_cast<PredictIter *>(handle);
+  if (iter->n_batches == iter->batches.size()) {
+    return 0;
+  }
+  XGProxyDMatrixSetDataDense(iter->proxy, iter->batches[iter->n_batches++].c_str());
+  return 1;
+}
+
+int PredictIterOutput(DataIterHandle handle, bst_ulong const *shape, bst_ulong dim,
+                      float const *result) {
+  auto *iter = static_cast<PredictIter *>(handle);
+  bst_ulong n = 1;
+  for (bst_ulong i = 0; i < dim; ++i) {
+    n *= shape[i];
+  }
+  iter->predt.insert(iter->predt.end(), result, result + n);
+  iter->n_outputs++;
+  return 0;
+}
+
+int PredictIterOutputFail(DataIterHandle, bst_ulong const *, bst_ulong, float const *) {
+  XGBAPISetLastError("Output is closed.");
+  return -1;
+}
+
+int PredictIterOutputFailSilently(DataIterHandle, bst_ulong const *, bst_ulong, float const *) {
+  return -1;
+}
+}  // anonymous namespace
+
+TEST(CAPI, PredictFromCallback) {
+  bst_row_t constexpr kRows = 96;
+  bst_feature_t constexpr kCols = 8;
+  std::size_t constexpr kBatches = 3;
+
+  auto p_dmat = RandomDataGenerator{kRows, kCols, 0}.GenerateDMatrix(true);
+  std::unique_ptr<Learner> learner{Learner::Create({p_dmat})};
+  learner->UpdateOneIter(0, p_dmat);
+  BoosterHandle handle = learner.get();
+
+  HostDeviceVector<float> storage;
+  auto [batches, whole] =
+      RandomDataGenerator{kRows, kCols, 0.2}.GenerateArrayInterfaceBatch(&storage, kBatches);
+
+  Json config{Object{}};
+  config["type"] = Integer{0};
+  config["iteration_begin"] = Integer{0};
+  config["iteration_end"] = Integer{0};
+  config["strict_shape"] = Boolean{false};
+  config["cache_id"] = Integer{0};
+  config["missing"] = Number{std::numeric_limits<float>::quiet_NaN()};
+  std::string str_config;
+  Json::Dump(config, &str_config);
+
+  bst_ulong const *out_shape;
+  bst_ulong out_dim;
+  float const *out_result;
+  ASSERT_EQ(XGBoosterPredictFromDense(handle, whole.c_str(), str_config.c_str(), nullptr,
+                                      &out_shape, &out_dim, &out_result),
+            0);
+  std::vector<float> expected(out_result, out_result + kRows);
+
+  PredictIter iter;
+  iter.batches = batches;
+  ASSERT_EQ(XGProxyDMatrixCreate(&iter.proxy), 0);
+  ASSERT_EQ(XGBoosterPredictFromCallback(handle, &iter, iter.proxy, PredictIterNext,
+                                         str_config.c_str(), PredictIterOutput),
+            0);
+  ASSERT_EQ(iter.n_outputs, kBatches);
+  ASSERT_EQ(iter.predt.size(), expected.size());
+  for (std::size_t i = 0; i < expected.size(); ++i) {
+    ASSERT_NEAR(iter.predt[i], expected[i], kRtEps);
+  }
+
+  // The error set by the output callback is kept.
+  iter.n_batches = 0;
+  ASSERT_EQ(XGBoosterPredictFromCallback(handle, &iter, iter.proxy, PredictIterNext,
+                                         str_config.c_str(), PredictIterOutputFail),
+            -1);
+  ASSERT_STREQ(XGBGetLastError(), "Output is closed.");
+  ASSERT_EQ(iter.n_batches, 1);
+  iter.n_batches = 0;
+  ASSERT_EQ(XGBoosterPredictFromCallback(handle, &iter, iter.proxy, PredictIterNext,
+                                         str_config.c_str(), PredictIterOutputFailSilently),
+            -1);
+  ASSERT_STREQ(XGBGetLastError(), "Failed to consume the prediction of a batch.");
+
+  // Not a proxy.
+  DMatrixHandle dmat = &p_dmat;
+  ASSERT_EQ(XGBoosterPredictFromCallback(handle, &iter, dmat, PredictIterNext,
+                                         str_config.c_str(), PredictIterOutput),
+            -1);
+  XGDMatrixFree(iter.proxy);
+}
+
 TEST(CAPI, CatchDMLCError) {
   DMatrixHandle out;
   ASSERT_EQ(XGDMatrixCreateFromFile("foo", 0, &out), -1);
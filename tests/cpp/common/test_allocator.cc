@@ -0,0 +1,61 @@
+/**
+ * Copyright 2023 by XGBoost Contributors
+ */
+#include <gtest/gtest.h>
+
+#include <cstddef>  // for size_t
+#include <cstdint>  // for uint8_t, uintptr_t
+#include <string>   // for string
+#include <vector>   // for vector
+
+#include "../../../src/common/allocator.h"
+
+namespace xgboost::common {
+TEST(DefaultInitAllocator, Basic) {
+  std::vector<std::uint8_t, DefaultInitAllocator<std::uint8_t>> vec(16, 3);
+  for (auto v : vec) {
+    ASSERT_EQ(v, 3);
+  }
+  // Existing elements are preserved by resize.
+  vec.resize(1024);
+  for (std::size_t i = 0; i < 16; ++i) {
+    ASSERT_EQ(vec[i], 3);
+  }
+  vec.resize(2048, 7);
+  for (std::size_t i = 1024; i < vec.size(); ++i) {
+    ASSERT_EQ(vec[i], 7);
+  }
+
+  // Non-trivial types are still constructed.
+  std::vector<std::string, DefaultInitAllocator<std::string>> strs(4);
+  for (auto const& str : strs) {
+    ASSERT_TRUE(str.empty());
+  }
+  strs.emplace_back("xgboost");
+  ASSERT_EQ(strs.back(), "xgboost");
+}
+
+TEST(HugePageAllocator, Basic) {
+  // Small allocation.
+  std::vector<double, HugePageAllocator<double>> small(16, 1.0);
+  ASSERT_EQ(small.back(), 1.0);
+  // Large allocation, aligned to huge page on Linux.
+  std::size_t n = detail::kHugePageSize / sizeof(double) * 2 + 3;
+  HugePageVector<double> large(n);
+  for (std::size_t i = 0; i < n; ++i) {
+    large[i] = static_cast<double>(i);
+  }
+#if defined(__linux__)
+  if (HugePageEnabled()) {
+    ASSERT_EQ(reinterpret_cast<std::uintptr_t>(large.data()) % detail::kHugePageSize, 0);
+  }
+#endif  // defined(__linux__)
+  large.resize(n * 2);
+  for (std::size_t i = 0; i < n; ++i) {
+    ASSERT_EQ(large[i], static_cast<double>(i));
+  }
+  large.clear();
+  large.shrink_to_fit();
+  ASSERT_EQ(large.capacity(), 0);
+}
+}  // namespace xgboost::common
@@ -6,6 +6,7 @@
 #include <string>
 #include <utility>
 
+#include "../../../src/common/column_matrix.h"
 #include "../../../src/common/hist_util.h"
 #include "../../../src/data/gradient_index.h"
 #include "../helpers.h"
@@ -41,7 +42,7 @@ void ParallelGHistBuilderReset() {
   hist_builder.Reset(nthreads, kNodes, space, target_hist);
 
   common::ParallelFor2d(space, nthreads, [&](size_t inode, common::Range1d) {
-    const size_t tid = omp_get_thread_num();
+    const size_t tid = ThreadIdx();
 
     GHistRow hist = hist_builder.GetInitializedHist(tid, inode);
     // fill hist by some non-null values
@@ -60,7 +61,7 @@ void ParallelGHistBuilderReset() {
   hist_builder.Reset(nthreads, kNodesExtended, space2, target_hist);
 
   common::ParallelFor2d(space2, nthreads, [&](size_t inode, common::Range1d) {
-    const size_t tid = omp_get_thread_num();
+    const size_t tid = ThreadIdx();
 
     GHistRow hist = hist_builder.GetInitializedHist(tid, inode);
     // fill hist by some non-null values
@@ -98,7 +99,7 @@ void ParallelGHistBuilderReduceHist(){
 
   // Simple analog of BuildHist function, works in parallel for both tree-nodes and data in node
   common::ParallelFor2d(space, nthreads, [&](size_t inode, common::Range1d) {
-    const size_t tid = omp_get_thread_num();
+    const size_t tid = ThreadIdx();
 
     GHistRow hist = hist_builder.GetInitializedHist(tid, inode);
     for(size_t i = 0; i < kBins; ++i) {
@@ -120,6 +121,32 @@ void ParallelGHistBuilderReduceHist(){
 
 TEST(ParallelGHistBuilder, Reset) { ParallelGHistBuilderReset(); }
 
+TEST(HistCollection, Chunks) {
+  // Large enough for several histograms in each chunk.
+  constexpr std::uint32_t kBins = 1024;
+  constexpr bst_uint kNodes = 1024;
+  HistCollection collection;
+  for (std::int32_t tree = 0; tree < 2; ++tree) {
+    collection.Init(kBins);
+    for (bst_uint nidx = 0; nidx < kNodes; ++nidx) {
+      collection.AddHistRow(nidx);
+      collection.AllocateData(nidx);
+      auto hist = collection[nidx];
+      ASSERT_EQ(hist.size(), kBins);
+      for (auto& bin : hist) {
+        bin = GradientPairPrecise{static_cast<double>(nidx), static_cast<double>(tree)};
+      }
+    }
+    // Histograms don't overlap.
+    for (bst_uint nidx = 0; nidx < kNodes; ++nidx) {
+      for (auto const& bin : collection[nidx]) {
+        ASSERT_EQ(bin.GetGrad(), static_cast<double>(nidx));
+        ASSERT_EQ(bin.GetHess(), static_cast<double>(tree));
+      }
+    }
+  }
+}
+
 TEST(ParallelGHistBuilder, ReduceHist) { ParallelGHistBuilderReduceHist(); }
 
 TEST(CutsBuilder, SearchGroupInd) {
@@ -327,6 +354,71 @@ TEST(HistUtil, IndexBinData) {
   }
 }
 
+TEST(HistUtil, PackedIndex) {
+  size_t constexpr kRows = 128;
+  bst_feature_t constexpr kNarrow = 5, kCols = 7;
+  // Low cardinality features followed by continuous features.
+  std::vector<float> x(kRows * kCols);
+  SimpleLCG lcg;
+  SimpleRealUniformDistribution<float> dist(0.0f, 1.0f);
+  for (size_t i = 0; i < kRows; ++i) {
+    for (bst_feature_t j = 0; j < kCols; ++j) {
+      x[i * kCols + j] = j < kNarrow ? static_cast<float>(i % (j + 2)) : dist(&lcg);
+    }
+  }
+  auto p_fmat = GetDMatrixFromData(x, kRows, kCols);
+  auto ctx = CreateEmptyGenericParam(Context::kCpuId);
+  GHistIndexMatrix gmat(&ctx, p_fmat.get(), 256, 0.5, false);
+
+  ASSERT_TRUE(gmat.index.IsPacked());
+  ASSERT_EQ(gmat.index.NumNarrow(), kNarrow);
+  ASSERT_EQ(gmat.index.Size(), kRows * kCols);
+  // 3 bytes for the 4-bit bins and 2 bytes for the uint8 bins.
+  ASSERT_EQ(gmat.index.SizeBytes(), kRows * 5);
+  for (size_t i = 0; i < kRows; ++i) {
+    for (bst_feature_t j = 0; j < kCols; ++j) {
+      auto bin = gmat.cut.SearchBin(x[i * kCols + j], j);
+      ASSERT_EQ(gmat.index[i * kCols + j], bin);
+      ASSERT_EQ(gmat.GetGindex(i, j), bin);
+    }
+  }
+
+  auto const& columns = gmat.Transpose();
+  for (size_t i = 0; i < kRows; ++i) {
+    for (bst_feature_t j = 0; j < kCols; ++j) {
+      auto col = columns.DenseColumn<uint8_t, false>(j);
+      ASSERT_EQ(col.GetGlobalBinIdx(i), gmat.index[i * kCols + j]);
+    }
+  }
+
+  // Use every other row to exercise the prefetching.
+  std::vector<size_t> rows;
+  for (size_t i = 0; i < kRows; i += 2) {
+    rows.push_back(i);
+  }
+  RowSetCollection::Elem elem{rows.data(), rows.data() + rows.size(), 0};
+  auto gpair = GenerateRandomGradients(kRows);
+  auto const& h_gpair = gpair.ConstHostVector();
+  auto n_bins = gmat.cut.TotalBins();
+  std::vector<GradientPairPrecise> expected(n_bins);
+  for (auto ridx : rows) {
+    for (bst_feature_t j = 0; j < kCols; ++j) {
+      expected[gmat.cut.SearchBin(x[ridx * kCols + j], j)] += GradientPairPrecise{h_gpair[ridx]};
+    }
+  }
+
+  GHistBuilder builder{n_bins};
+  for (bool force_read_by_column : {false, true}) {
+    std::vector<GradientPairPrecise> hist(n_bins);
+    builder.BuildHist<false>(Span<GradientPair const>{h_gpair.data(), h_gpair.size()}, elem,
+                             gmat, GHistRow{hist.data(), hist.size()}, force_read_by_column);
+    for (size_t i = 0; i < n_bins; ++i) {
+      ASSERT_NEAR(hist[i].GetGrad(), expected[i].GetGrad(), kRtEps);
+      ASSERT_NEAR(hist[i].GetHess(), expected[i].GetHess(), kRtEps);
+    }
+  }
+}
+
 void TestSketchFromWeights(bool with_group) {
   size_t constexpr kRows = 300, kCols = 20, kBins = 256;
   size_t constexpr kGroups = 10;
@@ -3,10 +3,18 @@
  */
 #include <gtest/gtest.h>
 
-#include <cstddef>  // std::size_t
+#if !defined(_WIN32)
+#include <sys/wait.h>  // for waitpid, WIFEXITED, WEXITSTATUS
+#include <unistd.h>    // for fork, _exit
+#endif                 // !defined(_WIN32)
 
+#include <atomic>     // std::atomic
+#include <cstddef>    // std::size_t
+#include <stdexcept>  // std::runtime_error
+#include <vector>     // std::vector
+
+#include "../../../src/common/thread_pool.h"      // ThreadPool
 #include "../../../src/common/threading_utils.h"  // BlockedSpace2d,ParallelFor2d,ParallelFor
-#include "dmlc/omp.h"                             // omp_in_parallel
 #include "xgboost/context.h"                      // Context
 
 namespace xgboost {
@@ -96,11 +104,126 @@ TEST(ParallelFor, Basic) {
   ParallelFor(n, n_threads, [&](auto i) {
     ASSERT_EQ(ctx.Threads(), 1);
     if (n_threads > 1) {
-      ASSERT_TRUE(omp_in_parallel());
+      ASSERT_TRUE(InParallelRegion());
     }
     ASSERT_LT(i, n);
   });
-  ASSERT_FALSE(omp_in_parallel());
+  ASSERT_FALSE(InParallelRegion());
+}
+
+namespace {
+class ThreadPoolBackend {
+  ParallelBackend prev_;
+
+ public:
+  ThreadPoolBackend() : prev_{GetParallelBackend()} {
+    SetParallelBackend(ParallelBackend::kThreadPool);
+  }
+  ~ThreadPoolBackend() { SetParallelBackend(prev_); }
+};
+}  // namespace
+
+TEST(ThreadPool, ParallelFor) {
+  ThreadPoolBackend backend;
+  std::int32_t n_threads{4};
+  std::size_t n{1031};
+  for (auto sched : {Sched::Auto(), Sched::Dyn(), Sched::Dyn(7), Sched::Static(),
+                     Sched::Guided()}) {
+    std::vector<std::int32_t> visited(n, 0);
+    // Per-thread accumulation without synchronization relies on unique thread indices.
+    std::vector<std::size_t> sum_tloc(n_threads, 0);
+    ParallelFor(n, n_threads, sched, [&](auto i) {
+      auto tidx = ThreadIdx();
+      ASSERT_GE(tidx, 0);
+      ASSERT_LT(tidx, n_threads);
+      ASSERT_TRUE(InParallelRegion());
+      visited[i]++;
+      sum_tloc[tidx] += i;
+    });
+    ASSERT_FALSE(InParallelRegion());
+    for (auto v : visited) {
+      ASSERT_EQ(v, 1);
+    }
+    std::size_t sum{0};
+    for (auto v : sum_tloc) {
+      sum += v;
+    }
+    ASSERT_EQ(sum, n * (n - 1) / 2);
+  }
+  ASSERT_GE(ThreadPool::Global()->NumWorkers(), n_threads - 1);
+}
+
+TEST(ThreadPool, StaticParallelFor2d) {
+  ThreadPoolBackend backend;
+  std::int32_t n_threads{3};
+  BlockedSpace2d space{4, [](std::size_t) { return 10; }, 3};
+  // Blocks must be assigned to threads in the same way as the OpenMP implementation.
+  auto chunk = space.Size() / n_threads + !!(space.Size() % n_threads);
+  ParallelFor2d(space, n_threads, [&](std::size_t node, Range1d r) {
+    std::size_t block{0};
+    while (space.GetFirstDimension(block) != node || space.GetRange(block).begin() != r.begin()) {
+      ++block;
+    }
+    ASSERT_EQ(static_cast<std::size_t>(ThreadIdx()), block / chunk);
+  });
+}
+
+TEST(ThreadPool, Nested) {
+  ThreadPoolBackend backend;
+  Context ctx;
+  ctx.UpdateAllowUnknown(Args{{"nthread", "4"}});
+  std::atomic<std::size_t> n_inner{0};
+  ParallelFor(8, ctx.Threads(), [&](auto) {
+    // Nested loops run on the calling thread.
+    ASSERT_EQ(ctx.Threads(), 1);
+    ParallelFor(8, 4, [&](auto) { n_inner++; });
+  });
+  ASSERT_EQ(n_inner.load(), 64);
+}
+
+TEST(ThreadPool, Exception) {
+  ThreadPoolBackend backend;
+  std::atomic<std::size_t> n_visited{0};
+  ASSERT_THROW(
+      {
+        ParallelFor(128, 4, Sched::Dyn(), [&](auto i) {
+          n_visited++;
+          if (i == 64) {
+            throw std::runtime_error{"Test"};
+          }
+        });
+      },
+      std::runtime_error);
+  ASSERT_EQ(n_visited.load(), 128);
+}
+
+#if !defined(_WIN32)
+TEST(ThreadPool, Fork) {
+  ThreadPoolBackend backend;
+  std::size_t constexpr kTasks = 256;
+  std::atomic<std::size_t> n_visited{0};
+  // Start the workers in the parent.
+  ParallelFor(kTasks, 4, [&](auto) { n_visited++; });
+  ASSERT_EQ(n_visited.load(), kTasks);
+
+  auto pid = fork();
+  ASSERT_GE(pid, 0);
+  if (pid == 0) {
+    n_visited = 0;
+    ParallelFor(kTasks, 4, [&](auto) { n_visited++; });
+    _exit(n_visited.load() == kTasks ? 0 : 1);
+  }
+  int status{0};
+  ASSERT_EQ(waitpid(pid, &status, 0), pid);
+  ASSERT_TRUE(WIFEXITED(status));
+  ASSERT_EQ(WEXITSTATUS(status), 0);
+}
+#endif  // !defined(_WIN32)
+
+TEST(ThreadPool, Topology) {
+  auto topo = CPUTopology::Detect();
+  ASSERT_FALSE(topo.cpus.empty());
+  ASSERT_EQ(topo.cpus.size(), topo.nodes.size());
 }
 }  // namespace common
 }  // namespace xgboost
@@ -0,0 +1,140 @@
+/**
+ * Copyright 2023 by XGBoost Contributors
+ */
+#include <gtest/gtest.h>
+#include <xgboost/json.h>  // for Json, get, Array, Object
+
+#include <cstddef>  // for size_t
+#include <cstdint>  // for int64_t
+#include <map>      // for map
+#include <string>   // for string
+#include <thread>   // for thread
+#include <vector>   // for vector
+
+#include "../../../src/collective/communicator-inl.h"  // for Allreduce
+#include "../../../src/common/timer.h"                  // for Monitor
+#include "../../../src/common/trace.h"
+
+namespace xgboost::common {
+namespace {
+// Count the events by name, metadata events are skipped.
+std::map<std::string, std::size_t> CountEvents(Json const& trace) {
+  std::map<std::string, std::size_t> counts;
+  for (auto const& event : get<Array const>(trace["traceEvents"])) {
+    if (get<String const>(event["ph"]) == "M") {
+      continue;
+    }
+    counts[get<String const>(event["name"])]++;
+  }
+  return counts;
+}
+}  // anonymous namespace
+
+TEST(Trace, Disabled) {
+  Tracer::Start(16);
+  Tracer::Stop();
+  { TraceScope scope{"test", "test"}; }
+  auto trace = Json::Load(StringView{Tracer::Dump()});
+  ASSERT_TRUE(get<Array const>(trace["traceEvents"]).empty());
+}
+
+TEST(Trace, Scopes) {
+  std::size_t constexpr kThreads = 4, kEvents = 8;
+  Tracer::Start(64);
+  std::vector<std::thread> workers;
+  for (std::size_t t = 0; t < kThreads; ++t) {
+    workers.emplace_back([&] {
+      for (std::size_t i = 0; i < kEvents; ++i) {
+        TraceScope scope{"Worker", "test", {{"i", static_cast<std::int64_t>(i)}, {"rows", 3}}};
+      }
+    });
+  }
+  for (auto& t : workers) {
+    t.join();
+  }
+  Monitor monitor;
+  monitor.Init("Trace");
+  monitor.Start("Phase");
+  monitor.Stop("Phase");
+  Tracer::Stop();
+
+  auto trace = Json::Load(StringView{Tracer::Dump()});
+  auto counts = CountEvents(trace);
+  ASSERT_EQ(counts.at("Worker"), kThreads * kEvents);
+  ASSERT_EQ(counts.at("Trace::Phase"), 2);
+
+  for (auto const& event : get<Array const>(trace["traceEvents"])) {
+    auto const& phase = get<String const>(event["ph"]);
+    if (phase == "X") {
+      ASSERT_EQ(get<Integer const>(event["args"]["rows"]), 3);
+      ASSERT_LT(get<Integer const>(event["args"]["i"]), static_cast<std::int64_t>(kEvents));
+      ASSERT_GE(get<Number const>(event["dur"]), 0.0);
+      ASSERT_EQ(get<String const>(event["cat"]), "test");
+    } else if (phase != "M") {
+      ASSERT_TRUE(phase == "B" || phase == "E");
+      ASSERT_EQ(get<String const>(event["cat"]), "monitor");
+    }
+  }
+}
+
+TEST(Trace, Overflow) {
+  std::size_t constexpr kCapacity = 4;
+  Tracer::Start(kCapacity);
+  for (std::int64_t i = 0; i < 10; ++i) {
+    TraceScope scope{"Overflow", "test", {{"i", i}}};
+  }
+  Tracer::Stop();
+
+  auto trace = Json::Load(StringView{Tracer::Dump()});
+  std::vector<std::int64_t> kept;
+  for (auto const& event : get<Array const>(trace["traceEvents"])) {
+    if (get<String const>(event["ph"]) == "X") {
+      kept.push_back(get<Integer const>(event["args"]["i"]));
+    }
+  }
+  ASSERT_EQ(kept, (std::vector<std::int64_t>{6, 7, 8, 9}));
+}
+
+TEST(Trace, MemoryUsage) {
+  std::size_t constexpr kCapacity = 1 << 16;
+  Tracer::Start(kCapacity);
+  std::thread worker{[] {
+    for (std::int64_t i = 0; i < 8; ++i) {
+      TraceScope scope{"Worker", "test", {{"i", i}}};
+    }
+  }};
+  worker.join();
+  // Buffers grow with the number of events.
+  auto n_bytes = Tracer::MemoryUsage();
+  ASSERT_GT(n_bytes, 0);
+  ASSERT_LT(n_bytes, kCapacity * sizeof(TraceEvent));
+  Tracer::Stop();
+  // Events of exited threads are kept until the next start.
+  auto counts = CountEvents(Json::Load(StringView{Tracer::Dump()}));
+  ASSERT_EQ(counts.at("Worker"), 8);
+
+  Tracer::Start(16);
+  ASSERT_LT(Tracer::MemoryUsage(), n_bytes);
+  Tracer::Stop();
+}
+
+TEST(Trace, TypedAllreduce) {
+  std::vector<double> values(4, 1.0);
+  std::vector<std::uint32_t> indices(3, 1);
+  Tracer::Start(16);
+  collective::Allreduce<collective::Operation::kSum>(values.data(), values.size());
+  collective::Allreduce<collective::Operation::kMax>(indices.data(), indices.size());
+  Tracer::Stop();
+
+  auto trace = Json::Load(StringView{Tracer::Dump()});
+  std::vector<std::int64_t> bytes;
+  for (auto const& event : get<Array const>(trace["traceEvents"])) {
+    if (get<String const>(event["ph"]) == "X") {
+      ASSERT_EQ(get<String const>(event["name"]), "Allreduce");
+      ASSERT_EQ(get<String const>(event["cat"]), "collective");
+      bytes.push_back(get<Integer const>(event["args"]["bytes"]));
+    }
+  }
+  ASSERT_EQ(bytes, (std::vector<std::int64_t>{4 * sizeof(double), 3 * sizeof(std::uint32_t)}));
+}
+}  // namespace xgboost::common
@@ -1,7 +1,10 @@
 // Copyright (c) 2019-2021 by XGBoost Contributors
 #include <gtest/gtest.h>
+#include <cstdint>
+#include <limits>
 #include <type_traits>
 #include <utility>
+#include <vector>
 #include <xgboost/data.h>
 #include "../../../src/data/adapter.h"
 #include "../../../src/data/simple_dmatrix.h"
@@ -57,6 +60,93 @@ TEST(Adapter, CSRArrayAdapter) {
   ASSERT_EQ(adapter.NumColumns(), n_features);
 }
 
+TEST(Adapter, TypedArrayAdapter) {
+  std::size_t constexpr kRows = 16, kCols = 5;
+  // Column-major float64 input.
+  linalg::Matrix<double> f64{{kRows, kCols}, Context::kCpuId, linalg::Order::kF};
+  linalg::Matrix<float> f32{{kRows, kCols}, Context::kCpuId};
+  auto h_f64 = f64.HostView();
+  auto h_f32 = f32.HostView();
+  for (std::size_t i = 0; i < kRows; ++i) {
+    for (std::size_t j = 0; j < kCols; ++j) {
+      auto v = (i + j) % 3 == 0 ? std::numeric_limits<double>::quiet_NaN()
+                                 : static_cast<double>(i * kCols + j) / 3.0;
+      h_f64(i, j) = v;
+      h_f32(i, j) = static_cast<float>(v);
+    }
+  }
+
+  auto f64_arr = linalg::ArrayInterfaceStr(f64.HostView());
+  data::ArrayAdapter adapter{StringView{f64_arr}};
+  auto const &batch = adapter.Value();
+  data::DispatchTypedBatch(batch, [&](auto const &typed) {
+    using Batch = std::remove_cv_t<std::remove_reference_t<decltype(typed)>>;
+    ASSERT_TRUE((std::is_same<Batch, data::TypedArrayAdapterBatch<double>>::value));
+    ASSERT_EQ(typed.NumRows(), kRows);
+    for (std::size_t i = 0; i < kRows; ++i) {
+      auto line = typed.GetLine(i);
+      auto expected = batch.GetLine(i);
+      ASSERT_EQ(line.Size(), kCols);
+      for (std::size_t j = 0; j < kCols; ++j) {
+        auto e = line.GetElement(j);
+        ASSERT_EQ(e.row_idx, i);
+        ASSERT_EQ(e.column_idx, j);
+        if (common::CheckNAN(e.value)) {
+          ASSERT_TRUE(common::CheckNAN(expected.GetElement(j).value));
+        } else {
+          ASSERT_EQ(e.value, expected.GetElement(j).value);
+        }
+      }
+    }
+  });
+
+  // Same DMatrix as the one from a row-major float32 input.
+  auto f32_arr = linalg::ArrayInterfaceStr(f32.HostView());
+  data::ArrayAdapter f32_adapter{StringView{f32_arr}};
+  data::SimpleDMatrix m_f64{&adapter, std::numeric_limits<float>::quiet_NaN(), 1};
+  data::SimpleDMatrix m_f32{&f32_adapter, std::numeric_limits<float>::quiet_NaN(), 1};
+  ASSERT_EQ(m_f64.Info().num_nonzero_, m_f32.Info().num_nonzero_);
+  auto const &page_f64 = *m_f64.GetBatches<SparsePage>().begin();
+  auto const &page_f32 = *m_f32.GetBatches<SparsePage>().begin();
+  ASSERT_EQ(page_f64.offset.ConstHostVector(), page_f32.offset.ConstHostVector());
+  auto const &data_f64 = page_f64.data.ConstHostVector();
+  auto const &data_f32 = page_f32.data.ConstHostVector();
+  for (std::size_t i = 0; i < data_f64.size(); ++i) {
+    ASSERT_EQ(data_f64[i].index, data_f32[i].index);
+    ASSERT_EQ(data_f64[i].fvalue, data_f32[i].fvalue);
+  }
+}
+
+TEST(Adapter, TypedCSRArrayAdapter) {
+  std::vector<std::int64_t> indptr{0, 2, 3, 5};
+  std::vector<std::int64_t> indices{0, 2, 1, 0, 3};
+  std::vector<double> values{1.5, 2.5, 3.5, 4.5, 5.5};
+  using linalg::MakeVec;
+  auto indptr_arr = ArrayInterfaceStr(MakeVec(indptr.data(), indptr.size()));
+  auto indices_arr = ArrayInterfaceStr(MakeVec(indices.data(), indices.size()));
+  auto values_arr = ArrayInterfaceStr(MakeVec(values.data(), values.size()));
+  data::CSRArrayAdapter adapter{StringView{indptr_arr}, StringView{indices_arr},
+                                StringView{values_arr}, 4};
+  data::DispatchTypedBatch(adapter.Value(), [&](auto const &typed) {
+    using Batch = std::remove_cv_t<std::remove_reference_t<decltype(typed)>>;
+    ASSERT_TRUE(
+        (std::is_same<Batch, data::TypedCSRArrayAdapterBatch<std::int64_t, double>>::value));
+    ASSERT_EQ(typed.NumRows(), 3);
+    ASSERT_EQ(typed.NumCols(), 4);
+    std::size_t k = 0;
+    for (std::size_t i = 0; i < typed.Size(); ++i) {
+      auto line = typed.GetLine(i);
+      ASSERT_EQ(line.Size(), static_cast<std::size_t>(indptr[i + 1] - indptr[i]));
+      for (std::size_t j = 0; j < line.Size(); ++j, ++k) {
+        auto e = line.GetElement(j);
+        ASSERT_EQ(e.row_idx, i);
+        ASSERT_EQ(e.column_idx, static_cast<std::size_t>(indices[k]));
+        ASSERT_EQ(e.value, static_cast<float>(values[k]));
+      }
+    }
+  });
+}
+
 TEST(Adapter, CSCAdapterColsMoreThanRows) {
   std::vector<float> data = {1, 2, 3, 4, 5, 6, 7, 8};
   std::vector<unsigned> row_idx = {0, 1, 0, 1, 0, 1, 0, 1};
@@ -9,6 +9,7 @@
 #include <cstddef>                              // for size_t
 #include <limits>                               // for numeric_limits
 #include <memory>                               // for shared_ptr, __shared_ptr_access, unique_ptr
+#include <numeric>                              // for accumulate
 #include <string>                               // for string
 #include <tuple>                                // for make_tuple, tie, tuple
 #include <utility>                              // for move
@@ -152,6 +153,91 @@ TEST(GradientIndex, PushBatch) {
   test(0.9f);
 }
 
+TEST(GradientIndex, Rebin) {
+  std::size_t constexpr kRows = 2048;
+  bst_feature_t constexpr kCols = 3;
+  bst_bin_t constexpr kBins = 16;
+  Context ctx;
+
+  auto test = [&](bool sparse) {
+    // The first feature increases with the row index, the others are random.
+    std::vector<float> x(kRows * kCols);
+    SimpleLCG lcg;
+    SimpleRealUniformDistribution<float> dist(0.0f, 1.0f);
+    for (std::size_t i = 0; i < kRows; ++i) {
+      for (bst_feature_t j = 0; j < kCols; ++j) {
+        if (j == 0) {
+          x[i * kCols + j] = static_cast<float>(i) / kRows;
+        } else if (sparse && i % 3 == 0) {
+          x[i * kCols + j] = std::numeric_limits<float>::quiet_NaN();
+        } else {
+          x[i * kCols + j] = dist(&lcg);
+        }
+      }
+    }
+    auto p_fmat = GetDMatrixFromData(x, kRows, kCols);
+    std::vector<float> hess(kRows, 1.0f);
+    GHistIndexMatrix gmat{&ctx, p_fmat.get(), kBins, std::numeric_limits<double>::quiet_NaN(),
+                          true, hess};
+    ASSERT_EQ(gmat.IsDense(), !sparse);
+    double constexpr kTolerance = 0.15;
+    ASSERT_EQ(gmat.Rebin(&ctx, p_fmat.get(), hess, kTolerance), 0);
+
+    // Larger hessian for the first half of the rows moves the weighted quantiles of the
+    // first feature.
+    for (std::size_t i = 0; i < kRows / 2; ++i) {
+      hess[i] = 16.0f;
+    }
+    auto old_ptrs = gmat.cut.Ptrs();
+    auto old_values = gmat.cut.Values();
+    ASSERT_EQ(gmat.Rebin(&ctx, p_fmat.get(), hess, kTolerance), 1);
+    ASSERT_EQ(gmat.cut.Ptrs(), old_ptrs);
+    auto const& values = gmat.cut.Values();
+    for (auto i = old_ptrs[1]; i < old_ptrs.back(); ++i) {
+      ASSERT_EQ(values[i], old_values[i]);
+    }
+    ASSERT_NE(values[0], old_values[0]);
+
+    std::vector<double> bin_weights(gmat.cut.TotalBins(), 0.0);
+    for (std::size_t i = 0; i < kRows; ++i) {
+      for (bst_feature_t j = 0; j < kCols; ++j) {
+        auto v = x[i * kCols + j];
+        if (std::isnan(v)) {
+          continue;
+        }
+        auto bin = gmat.cut.SearchBin(v, j);
+        ASSERT_EQ(gmat.GetGindex(i, j), bin);
+        bin_weights[bin] += hess[i];
+      }
+    }
+    // Each bin of the first feature has roughly the same weight.
+    double total = kRows / 2 * 16.0 + kRows / 2;
+    for (auto i = old_ptrs[0]; i + 1 < old_ptrs[1]; ++i) {
+      ASSERT_NEAR(bin_weights[i], total / kBins, 16.0);
+    }
+    ASSERT_EQ(std::accumulate(gmat.hit_count.cbegin(), gmat.hit_count.cbegin() + old_ptrs[1],
+                              std::size_t{0}),
+              kRows);
+    // Nothing has moved since the last update.
+    ASSERT_EQ(gmat.Rebin(&ctx, p_fmat.get(), hess, kTolerance), 0);
+
+    // Through the DMatrix cache.
+    BatchParam p{kBins, common::Span<float>{hess}, true};
+    p.rebin_tolerance = kTolerance;
+    auto const& page = *p_fmat->GetBatches<GHistIndexMatrix>(&ctx, p).begin();
+    old_values = page.cut.Values();
+    for (std::size_t i = 0; i < kRows / 2; ++i) {
+      hess[i] = 1.0f;
+    }
+    auto const& rebinned = *p_fmat->GetBatches<GHistIndexMatrix>(&ctx, p).begin();
+    ASSERT_EQ(&page, &rebinned);
+    ASSERT_NE(rebinned.cut.Values(), old_values);
+  };
+
+  test(false);
+  test(true);
+}
+
 #if defined(XGBOOST_USE_CUDA)
 
 namespace {
@@ -3,9 +3,11 @@
  */
 #include <gtest/gtest.h>
 
+#include <limits>
 #include <memory>
 #include <sstream>
 
+#include "../../../src/data/proxy_dmatrix.h"
 #include "../helpers.h"
 #include "xgboost/context.h"
 #include "xgboost/gbm.h"
@@ -40,5 +42,45 @@ TEST(GBLinear, JsonIO) {
     ASSERT_EQ(weights.size(), 17);
   }
 }
+
+TEST(GBLinear, InplacePredict) {
+  size_t constexpr kRows = 130, kCols = 20, kClasses = 3;
+  HostDeviceVector<float> data;
+  auto array_str = RandomDataGenerator{kRows, kCols, 0.2}.GenerateArrayInterface(&data);
+  auto p_mat = GetDMatrixFromData(data.HostVector(), kRows, kCols);
+  std::vector<float> labels(kRows);
+  for (size_t i = 0; i < kRows; ++i) {
+    labels[i] = i % kClasses;
+  }
+  p_mat->SetInfo("label", labels.data(), DataType::kFloat32, kRows);
+
+  for (auto n_classes : {static_cast<size_t>(1), kClasses}) {
+    std::unique_ptr<Learner> learner{Learner::Create({p_mat})};
+    learner->SetParam("booster", "gblinear");
+    if (n_classes != 1) {
+      learner->SetParam("num_class", std::to_string(n_classes));
+    }
+    for (size_t i = 0; i < 4; ++i) {
+      learner->UpdateOneIter(i, p_mat);
+    }
+
+    HostDeviceVector<float> expected;
+    learner->Predict(p_mat, true, &expected, 0, 0);
+
+    std::shared_ptr<data::DMatrixProxy> x{new data::DMatrixProxy{}};
+    x->SetArrayData(array_str.c_str());
+    HostDeviceVector<float>* out_predt;
+    learner->InplacePredict(x, PredictionType::kMargin, std::numeric_limits<float>::quiet_NaN(),
+                            &out_predt, 0, 0);
+
+    auto const& h_expected = expected.ConstHostVector();
+    auto const& h_predt = out_predt->ConstHostVector();
+    ASSERT_EQ(h_expected.size(), kRows * n_classes);
+    ASSERT_EQ(h_expected.size(), h_predt.size());
+    for (size_t i = 0; i < h_expected.size(); ++i) {
+      ASSERT_NEAR(h_expected[i], h_predt[i], 1e-5);
+    }
+  }
+}
 }  // namespace gbm
 }  // namespace xgboost
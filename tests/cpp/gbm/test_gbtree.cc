@@ -301,6 +301,70 @@ INSTANTIATE_TEST_SUITE_P(PredictorTypes, Dart,
 INSTANTIATE_TEST_SUITE_P(PredictorTypes, Dart, testing::Values("auto", "cpu_predictor"));
 #endif  // defined(XGBOOST_USE_CUDA)
 
+TEST(Dart, TreeOutputCache) {
+  size_t constexpr kRows = 256, kCols = 10, kClasses = 3;
+  auto p_mat = RandomDataGenerator{kRows, kCols, 0}.GenerateDMatrix(true, false, kClasses);
+
+  auto train = [&](std::string cache) {
+    std::unique_ptr<Learner> learner{Learner::Create({p_mat})};
+    learner->SetParams(Args{{"booster", "dart"},
+                            {"num_class", std::to_string(kClasses)},
+                            {"rate_drop", "0.3"},
+                            {"seed_per_iteration", "true"},
+                            {"cache_tree_output", cache}});
+    for (size_t i = 0; i < 8; ++i) {
+      learner->UpdateOneIter(i, p_mat);
+    }
+    HostDeviceVector<float> predts;
+    learner->Predict(p_mat, false, &predts, 0, 0);
+    return predts;
+  };
+
+  auto expected = train("false");
+  auto got = train("true");
+  auto const& h_expected = expected.ConstHostVector();
+  auto const& h_got = got.ConstHostVector();
+  ASSERT_EQ(h_expected.size(), h_got.size());
+  for (size_t i = 0; i < h_expected.size(); ++i) {
+    ASSERT_NEAR(h_expected[i], h_got[i], 1e-5);
+  }
+}
+
+TEST(Dart, TreeOutputCacheFreedDMatrix) {
+  size_t constexpr kRows = 256, kCols = 10;
+
+  auto train = [&](std::string cache) {
+    std::unique_ptr<Learner> learner{Learner::Create({})};
+    learner->SetParams(Args{{"booster", "dart"},
+                            {"rate_drop", "0.3"},
+                            {"seed_per_iteration", "true"},
+                            {"cache_tree_output", cache}});
+    {
+      auto p_mat = RandomDataGenerator{kRows, kCols, 0}.Seed(1).GenerateDMatrix(true);
+      for (size_t i = 0; i < 4; ++i) {
+        learner->UpdateOneIter(i, p_mat);
+      }
+    }
+    // A new DMatrix with the same shape, which may be allocated at the address of the
+    // freed one.
+    auto p_mat = RandomDataGenerator{kRows, kCols, 0}.Seed(2).GenerateDMatrix(true);
+    for (size_t i = 4; i < 8; ++i) {
+      learner->UpdateOneIter(i, p_mat);
+    }
+    HostDeviceVector<float> predts;
+    learner->Predict(p_mat, false, &predts, 0, 0);
+    return predts;
+  };
+
+  auto expected = train("false");
+  auto got = train("true");
+  auto const& h_expected = expected.ConstHostVector();
+  auto const& h_got = got.ConstHostVector();
+  ASSERT_EQ(h_expected.size(), h_got.size());
+  for (size_t i = 0; i < h_expected.size(); ++i) {
+    ASSERT_NEAR(h_expected[i], h_got[i], 1e-5);
+  }
+}
 
 std::pair<Json, Json> TestModelSlice(std::string booster) {
   size_t constexpr kRows = 1000, kCols = 100, kForest = 2, kClasses = 3;
@@ -7,6 +7,7 @@
 #include "../helpers.h"
 #include "test_json_io.h"
 #include "../../../src/gbm/gblinear_model.h"
+#include "../../../src/linear/coordinate_common.h"
 #include "xgboost/base.h"
 
 namespace xgboost {
@@ -64,6 +65,36 @@ TEST(Linear, coordinate) {
   ASSERT_EQ(model.Bias()[0], 5.0f);
 }
 
+TEST(Coordinate, ColumnGradient) {
+  std::size_t constexpr kRows = linear::kMinParallelColumnSize * 2;
+  std::int32_t constexpr kGroups = 2;
+  std::vector<Entry> col(kRows);
+  std::vector<GradientPair> gpair(kRows * kGroups);
+  for (std::size_t i = 0; i < kRows; ++i) {
+    col[i] = Entry{static_cast<bst_feature_t>(i), static_cast<float>(i % 7) / 7.0f};
+    gpair[i * kGroups] = GradientPair{static_cast<float>(i % 3) - 1.0f, 1.0f};
+    gpair[i * kGroups + 1] = GradientPair{1.0f, (i % 5 == 0) ? -1.0f : 0.5f};
+  }
+
+  Context serial, parallel;
+  serial.UpdateAllowUnknown(Args{{"nthread", "1"}});
+  parallel.UpdateAllowUnknown(Args{{"nthread", "4"}});
+  for (std::int32_t gidx = 0; gidx < kGroups; ++gidx) {
+    auto expected = linear::GetColumnGradient(&serial, gidx, kGroups, col, gpair);
+    auto got = linear::GetColumnGradient(&parallel, gidx, kGroups, col, gpair);
+    ASSERT_NEAR(expected.first, got.first, 1e-6 * kRows);
+    ASSERT_NEAR(expected.second, got.second, 1e-6 * kRows);
+  }
+
+  auto expected = gpair;
+  linear::UpdateColumnResidual(&serial, 0, kGroups, 0.5f, col, &expected);
+  linear::UpdateColumnResidual(&parallel, 0, kGroups, 0.5f, col, &gpair);
+  for (std::size_t i = 0; i < gpair.size(); ++i) {
+    ASSERT_EQ(expected[i].GetGrad(), gpair[i].GetGrad());
+    ASSERT_EQ(expected[i].GetHess(), gpair[i].GetHess());
+  }
+}
+
 TEST(Coordinate, JsonIO){
   TestUpdaterJsonIO("coord_descent");
 }
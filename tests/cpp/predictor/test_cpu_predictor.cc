@@ -5,6 +5,8 @@
 #include <xgboost/predictor.h>
 
 #include <cstdint>
+#include <functional>
+#include <numeric>
 #include <thread>
 
 #include "../../../src/collective/communicator-inl.h"
@@ -12,6 +14,7 @@
 #include "../../../src/data/proxy_dmatrix.h"
 #include "../../../src/gbm/gbtree.h"
 #include "../../../src/gbm/gbtree_model.h"
+#include "../../../src/predictor/cpu_treeshap.h"
 #include "../filesystem.h"  // dmlc::TemporaryDirectory
 #include "../helpers.h"
 #include "test_predictor.h"
@@ -262,6 +265,176 @@ TEST(CpuPredictor, SparseColumnSplit) {
   TestSparsePredictionColumnSplit(0.8, "cpu_predictor");
 }
 
+namespace {
+Json TrainModelForShap(std::shared_ptr<DMatrix> dmat, size_t n_classes, size_t max_depth) {
+  std::unique_ptr<Learner> learner{Learner::Create({dmat})};
+  learner->SetParams(Args{{"objective", "multi:softprob"},
+                          {"num_class", std::to_string(n_classes)},
+                          {"max_depth", std::to_string(max_depth)}});
+  for (size_t i = 0; i < 4; ++i) {
+    learner->UpdateOneIter(i, dmat);
+  }
+  Json j_model{Object{}};
+  learner->SaveModel(&j_model);
+  return j_model["learner"]["gradient_booster"]["model"];
+}
+}  // anonymous namespace
+
+TEST(CpuPredictor, TreeShapPaths) {
+  size_t constexpr kRows = 150, kCols = 16, kClasses = 3;
+  auto dmat = RandomDataGenerator(kRows, kCols, 0.2).GenerateDMatrix(true, false, kClasses);
+  auto j_model = TrainModelForShap(dmat, kClasses, 6);
+
+  Context ctx;
+  ctx.UpdateAllowUnknown(Args{});
+  LearnerModelParam mparam{MakeMP(kCols, .5, kClasses)};
+  gbm::GBTreeModel model{&mparam, &ctx};
+  model.LoadModel(j_model);
+  std::unique_ptr<Predictor> predictor{Predictor::Create("cpu_predictor", &ctx)};
+  predictor->Configure({});
+
+  std::vector<float> tree_weights(model.trees.size());
+  std::iota(tree_weights.begin(), tree_weights.end(), 1.0f);
+  HostDeviceVector<float> contribs;
+  predictor->PredictContribution(dmat.get(), &contribs, model, 0, &tree_weights);
+  auto const& h_contribs = contribs.ConstHostVector();
+  size_t constexpr kColumns = kCols + 1;
+  ASSERT_EQ(h_contribs.size(), kRows * kClasses * kColumns);
+
+  // Reference from the recursive TreeSHAP.
+  std::vector<std::vector<float>> mean_values(model.trees.size());
+  for (size_t t = 0; t < model.trees.size(); ++t) {
+    auto const& tree = *model.trees[t];
+    mean_values[t].resize(tree.NumNodes());
+    std::function<float(bst_node_t)> fill = [&](bst_node_t nidx) {
+      float v = tree[nidx].LeafValue();
+      if (!tree[nidx].IsLeaf()) {
+        auto l = tree[nidx].LeftChild(), r = tree[nidx].RightChild();
+        v = (fill(l) * tree.Stat(l).sum_hess + fill(r) * tree.Stat(r).sum_hess) /
+            tree.Stat(nidx).sum_hess;
+      }
+      mean_values[t][nidx] = v;
+      return v;
+    };
+    fill(RegTree::kRoot);
+  }
+  RegTree::FVec feats;
+  feats.Init(kCols);
+  std::vector<float> expected(kColumns), tree_contribs(kColumns);
+  auto const& page = *dmat->GetBatches<SparsePage>().begin();
+  auto batch = page.GetView();
+  for (size_t i = 0; i < kRows; ++i) {
+    feats.Fill(batch[i]);
+    for (size_t gid = 0; gid < kClasses; ++gid) {
+      std::fill(expected.begin(), expected.end(), 0.0f);
+      for (size_t t = 0; t < model.trees.size(); ++t) {
+        if (model.tree_info[t] != static_cast<int>(gid)) {
+          continue;
+        }
+        std::fill(tree_contribs.begin(), tree_contribs.end(), 0.0f);
+        CalculateContributions(*model.trees[t], feats, mean_values[t], model.trees[t]->MaxDepth(0),
+                               tree_contribs.data(), 0, 0);
+        for (size_t c = 0; c < kColumns; ++c) {
+          expected[c] += tree_contribs[c] * tree_weights[t];
+        }
+      }
+      expected.back() += 0.5f;
+      for (size_t c = 0; c < kColumns; ++c) {
+        ASSERT_NEAR(h_contribs[(i * kClasses + gid) * kColumns + c], expected[c], 1e-4);
+      }
+    }
+    feats.Drop();
+  }
+}
+
+TEST(CpuPredictor, ShapCache) {
+  Context ctx;
+  ctx.UpdateAllowUnknown(Args{});
+  LearnerModelParam mparam{MakeMP(4, .5, 1)};
+  gbm::GBTreeModel model{&mparam, &ctx};
+  auto commit = [&](float leaf) {
+    gbm::TreesOneIter trees(1);
+    trees.front().push_back(std::make_unique<RegTree>());
+    (*trees.front().back())[0].SetLeaf(leaf);
+    trees.front().back()->Stat(0).sum_hess = 1.0f;
+    model.CommitModel(std::move(trees));
+  };
+  commit(1.5f);
+
+  auto paths = model.ShapPaths(1);
+  ASSERT_EQ(paths->NumTrees(), 1);
+  ASSERT_EQ(paths->MeanValues(0)[0], 1.5f);
+  ASSERT_EQ(model.ShapPaths(1), paths);
+
+  // Extended with new trees, existing snapshots are not modified.
+  commit(2.0f);
+  auto extended = model.ShapPaths(2);
+  ASSERT_NE(extended, paths);
+  ASSERT_EQ(paths->NumTrees(), 1);
+  ASSERT_EQ(extended->NumTrees(), 2);
+  ASSERT_EQ(extended->MeanValues(1)[0], 2.0f);
+  ASSERT_EQ(model.ShapPaths(1), extended);
+
+  // Invalidated by loading a new model.
+  Json j_model{Object{}};
+  model.SaveModel(&j_model);
+  model.LoadModel(j_model);
+  auto loaded = model.ShapPaths(2);
+  ASSERT_NE(loaded, extended);
+  ASSERT_TRUE(loaded->Match(model.trees));
+  ASSERT_FALSE(extended->Match(model.trees));
+}
+
+TEST(CpuPredictor, InteractionContributions) {
+  size_t constexpr kRows = 64, kCols = 16, kClasses = 3;
+  auto dmat = RandomDataGenerator(kRows, kCols, 0.2).GenerateDMatrix(true, false, kClasses);
+  auto j_model = TrainModelForShap(dmat, kClasses, 4);
+
+  Context ctx;
+  ctx.UpdateAllowUnknown(Args{});
+  LearnerModelParam mparam{MakeMP(kCols, .5, kClasses)};
+  gbm::GBTreeModel model{&mparam, &ctx};
+  model.LoadModel(j_model);
+  std::unique_ptr<Predictor> predictor{Predictor::Create("cpu_predictor", &ctx)};
+  predictor->Configure({});
+
+  HostDeviceVector<float> interactions;
+  predictor->PredictInteractionContributions(dmat.get(), &interactions, model, 0, nullptr,
+                                             false);
+  auto const& h_interactions = interactions.ConstHostVector();
+  size_t constexpr kColumns = kCols + 1;
+  float constexpr kEps = 1e-5f;
+  ASSERT_EQ(h_interactions.size(), kRows * kClasses * kColumns * kColumns);
+
+  // Reference from the contributions conditioned on each feature.
+  HostDeviceVector<float> diag, on, off;
+  predictor->PredictContribution(dmat.get(), &diag, model, 0, nullptr, false, 0, 0);
+  auto const& h_diag = diag.ConstHostVector();
+  for (size_t i = 0; i < kColumns; ++i) {
+    predictor->PredictContribution(dmat.get(), &on, model, 0, nullptr, false, 1, i);
+    predictor->PredictContribution(dmat.get(), &off, model, 0, nullptr, false, -1, i);
+    auto const& h_on = on.ConstHostVector();
+    auto const& h_off = off.ConstHostVector();
+    for (size_t r = 0; r < kRows * kClasses; ++r) {
+      auto const* p_inter = h_interactions.data() + r * kColumns * kColumns + i * kColumns;
+      auto const* p_contrib = h_diag.data() + r * kColumns;
+      float expected_diag = p_contrib[i];
+      for (size_t k = 0; k < kColumns; ++k) {
+        if (k == i) {
+          continue;
+        }
+        float expected = (h_on[r * kColumns + k] - h_off[r * kColumns + k]) / 2.0f;
+        ASSERT_NEAR(p_inter[k], expected, kEps);
+        expected_diag -= expected;
+      }
+      ASSERT_NEAR(p_inter[i], expected_diag, kEps);
+      // The interactions sum up to the contribution of each feature.
+      float sum = std::accumulate(p_inter, p_inter + kColumns, 0.0f);
+      ASSERT_NEAR(sum, p_contrib[i], kEps);
+    }
+  }
+}
+
 TEST(CpuPredictor, Multi) {
   Context ctx;
   ctx.nthread = 1;
@@ -262,6 +262,104 @@ TEST(Learner, MultiThreadedPredict) {
   }
 }
 
+TEST(Learner, InferenceSnapshot) {
+  size_t constexpr kRows = 256;
+  size_t constexpr kCols = 16;
+
+  std::shared_ptr<DMatrix> p_dmat{RandomDataGenerator{kRows, kCols, 0}.GenerateDMatrix(true)};
+  std::unique_ptr<Learner> learner{Learner::Create({p_dmat})};
+  learner->SetParam("objective", "binary:logistic");
+  for (std::int32_t i = 0; i < 4; ++i) {
+    learner->UpdateOneIter(i, p_dmat);
+  }
+
+  HostDeviceVector<float> expected;
+  learner->Predict(p_dmat, false, &expected, 0, 0);
+  auto snapshot = learner->Snapshot();
+  ASSERT_EQ(snapshot->BoostedRounds(), 4);
+  ASSERT_EQ(snapshot->Groups(), 1);
+
+  // Training the learner further must not affect the snapshot.
+  for (std::int32_t i = 4; i < 8; ++i) {
+    learner->UpdateOneIter(i, p_dmat);
+  }
+  ASSERT_EQ(snapshot->BoostedRounds(), 4);
+
+  std::vector<std::thread> threads;
+  for (std::uint32_t thread_id = 0; thread_id < 4; ++thread_id) {
+    threads.emplace_back([&] {
+      HostDeviceVector<float> predictions;
+      for (std::size_t iter = 0; iter < 4; ++iter) {
+        snapshot->Predict(p_dmat, false, &predictions, 0, 0);
+        ASSERT_EQ(predictions.Size(), expected.Size());
+        auto const& h_predt = predictions.ConstHostVector();
+        auto const& h_expected = expected.ConstHostVector();
+        for (std::size_t i = 0; i < h_predt.size(); ++i) {
+          ASSERT_NEAR(h_predt[i], h_expected[i], kRtEps);
+        }
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+}
+
+TEST(Learner, PredictionCacheIO) {
+  size_t constexpr kRows = 256;
+  size_t constexpr kCols = 16;
+
+  std::shared_ptr<DMatrix> p_train{RandomDataGenerator{kRows, kCols, 0}.GenerateDMatrix(true)};
+  std::shared_ptr<DMatrix> p_valid{
+      RandomDataGenerator{kRows, kCols, 0}.Seed(1).GenerateDMatrix(true)};
+  std::unique_ptr<Learner> learner{Learner::Create({p_train, p_valid})};
+  learner->SetParam("objective", "binary:logistic");
+  for (std::int32_t i = 0; i < 4; ++i) {
+    learner->UpdateOneIter(i, p_train);
+    learner->EvalOneIter(i, {p_valid}, {"valid"});
+  }
+
+  Json cache{Object{}};
+  learner->ExportPredictionCache(p_valid, &cache);
+  ASSERT_EQ(get<Integer const>(cache["version"]), 4);
+  std::vector<char> buffer;
+  Json::Dump(cache, &buffer, std::ios::binary);
+  Json model{Object{}};
+  learner->SaveModel(&model);
+
+  HostDeviceVector<float> expected;
+  learner->Predict(p_valid, true, &expected, 0, 0);
+
+  // Shift the cached margin, so we can tell whether the cache is used.
+  auto loaded = Json::Load(StringView{buffer.data(), buffer.size()}, std::ios::binary);
+  for (auto& v : get<F32Array>(loaded["predictions"])) {
+    v += 1.0f;
+  }
+  learner.reset(Learner::Create({p_train, p_valid}));
+  learner->LoadModel(model);
+  learner->ImportPredictionCache(p_valid, loaded);
+  HostDeviceVector<float> predt;
+  learner->Predict(p_valid, true, &predt, 0, 0);
+  ASSERT_EQ(predt.Size(), expected.Size());
+  for (std::size_t i = 0; i < predt.Size(); ++i) {
+    ASSERT_NEAR(predt.HostVector()[i], expected.HostVector()[i] + 1.0f, kRtEps);
+  }
+
+  // Only the new trees are added on top of the imported cache.
+  learner->UpdateOneIter(4, p_train);
+  learner->Predict(p_valid, true, &predt, 0, 0);
+  learner->Snapshot()->Predict(p_valid, true, &expected, 0, 0);
+  ASSERT_EQ(predt.Size(), expected.Size());
+  for (std::size_t i = 0; i < predt.Size(); ++i) {
+    ASSERT_NEAR(predt.HostVector()[i], expected.HostVector()[i] + 1.0f, kRtEps);
+  }
+
+  // Different data.
+  std::shared_ptr<DMatrix> p_other{
+      RandomDataGenerator{kRows, kCols, 0}.Seed(2).GenerateDMatrix(true)};
+  ASSERT_THROW({ learner->ImportPredictionCache(p_other, loaded); }, dmlc::Error);
+}
+
 TEST(Learner, BinaryModelIO) {
   size_t constexpr kRows = 8;
   int32_t constexpr kIters = 4;
@@ -10,7 +10,10 @@
 #include <xgboost/logging.h>                            // for CHECK_EQ
 #include <xgboost/tree_model.h>                         // for RegTree, RTreeNodeStat
 
+#include <algorithm>                                    // for max, stable_sort
 #include <memory>                                       // for make_shared, shared_ptr, addressof
+#include <numeric>                                      // for iota
+#include <string>                                       // for to_string
 
 #include "../../../../src/common/hist_util.h"           // for HistCollection, HistogramCuts
 #include "../../../../src/common/random.h"              // for ColumnSampler
@@ -43,7 +46,7 @@ void TestEvaluateSplits(bool force_read_by_column) {
   // dense, no missing values
   GHistIndexMatrix gmat(&ctx, dmat.get(), kMaxBins, 0.5, false);
   common::RowSetCollection row_set_collection;
-  std::vector<size_t> &row_indices = *row_set_collection.Data();
+  auto &row_indices = *row_set_collection.Data();
   row_indices.resize(kRows);
   std::iota(row_indices.begin(), row_indices.end(), 0);
   row_set_collection.Init();
@@ -113,21 +116,21 @@ TEST(HistMultiEvaluator, Evaluate) {
       RandomDataGenerator{n_samples, n_features, 0.5}.Targets(n_targets).GenerateDMatrix(true);
 
   HistMultiEvaluator evaluator{&ctx, p_fmat->Info(), &param, sampler};
-  std::vector<common::HistCollection> histogram(n_targets);
+  // The histogram layout is [bin][target], all targets share the same values.
+  common::HistCollection histogram;
+  histogram.Init(n_bins * n_features * n_targets);
+  histogram.AddHistRow(0);
+  histogram.AllocateAllData();
+  auto node_hist = histogram[0];
   linalg::Vector<GradientPairPrecise> root_sum({2}, Context::kCpuId);
   for (bst_target_t t{0}; t < n_targets; ++t) {
-    auto &hist = histogram[t];
-    hist.Init(n_bins * n_features);
-    hist.AddHistRow(0);
-    hist.AllocateAllData();
-    auto node_hist = hist[0];
-    node_hist[0] = {-0.5, 0.5};
-    node_hist[1] = {2.0, 0.5};
-    node_hist[2] = {0.5, 0.5};
-    node_hist[3] = {1.0, 0.5};
+    node_hist[0 * n_targets + t] = {-0.5, 0.5};
+    node_hist[1 * n_targets + t] = {2.0, 0.5};
+    node_hist[2 * n_targets + t] = {0.5, 0.5};
+    node_hist[3 * n_targets + t] = {1.0, 0.5};
 
-    root_sum(t) += node_hist[0];
-    root_sum(t) += node_hist[1];
+    root_sum(t) += node_hist[0 * n_targets + t];
+    root_sum(t) += node_hist[1 * n_targets + t];
   }
 
   RegTree tree{n_targets, n_features};
@@ -145,11 +148,7 @@ TEST(HistMultiEvaluator, Evaluate) {
 
   std::vector<MultiExpandEntry> entries(1, {/*nidx=*/0, /*depth=*/0});
 
-  std::vector<common::HistCollection const *> ptrs;
-  std::transform(histogram.cbegin(), histogram.cend(), std::back_inserter(ptrs),
-                 [](auto const &h) { return std::addressof(h); });
-
-  evaluator.EvaluateSplits(tree, ptrs, cuts, &entries);
+  evaluator.EvaluateSplits(tree, histogram, cuts, &entries);
 
   ASSERT_EQ(entries.front().split.loss_chg, 12.5);
   ASSERT_EQ(entries.front().split.split_value, 0.5);
@@ -262,6 +261,79 @@ TEST(HistEvaluator, Categorical) {
   ASSERT_EQ(with_onehot.split.loss_chg, with_part.split.loss_chg);
 }
 
+TEST(HistEvaluator, CategoricalThreshold) {
+  // Only the first and the last `max_cat_threshold` categories in the sorted order are
+  // sorted, check the result against a full sort.
+  bst_bin_t constexpr kCats = 1000, kThreshold = 8;
+  TrainParam param;
+  param.UpdateAllowUnknown(Args{{"min_child_weight", "0"},
+                                {"reg_lambda", "0"},
+                                {"max_cat_to_onehot", "1"},
+                                {"max_cat_threshold", std::to_string(kThreshold)}});
+
+  common::HistogramCuts cuts;
+  cuts.cut_ptrs_.HostVector() = {0, static_cast<std::uint32_t>(kCats)};
+  cuts.cut_values_.HostVector().resize(kCats);
+  std::iota(cuts.cut_values_.HostVector().begin(), cuts.cut_values_.HostVector().end(), 0.0f);
+  cuts.min_vals_.HostVector() = {0.0f};
+
+  common::HistCollection hist;
+  hist.Init(kCats);
+  hist.AddHistRow(0);
+  hist.AllocateAllData();
+  auto node_hist = hist[0];
+  auto gpair = GenerateRandomGradients(kCats, 0.5, 1.5);
+  GradientPairPrecise parent_sum;
+  for (bst_bin_t i = 0; i < kCats; ++i) {
+    node_hist[i] = GradientPairPrecise{gpair.HostVector()[i]};
+    parent_sum += node_hist[i];
+  }
+
+  MetaInfo info;
+  info.num_col_ = 1;
+  info.feature_types = {FeatureType::kCategorical};
+  Context ctx;
+  ctx.nthread = 1;
+  auto sampler = std::make_shared<common::ColumnSampler>();
+  auto evaluator = HistEvaluator{&ctx, &param, info, sampler};
+  evaluator.InitRoot(GradStats{parent_sum});
+  std::vector<CPUExpandEntry> entries(1);
+  RegTree tree;
+  evaluator.EvaluateSplits(hist, cuts, info.feature_types.ConstHostSpan(), tree, &entries);
+  auto const &split = entries.front().split;
+
+  // Reference with a full sort, the gain is G^2/H without regularization.
+  std::vector<bst_bin_t> sorted_idx(kCats);
+  std::iota(sorted_idx.begin(), sorted_idx.end(), 0);
+  std::stable_sort(sorted_idx.begin(), sorted_idx.end(), [&](auto l, auto r) {
+    return static_cast<float>(-node_hist[l].GetGrad() / node_hist[l].GetHess()) <
+           static_cast<float>(-node_hist[r].GetGrad() / node_hist[r].GetHess());
+  });
+  auto gain = [](GradientPairPrecise const &s) { return s.GetGrad() * s.GetGrad() / s.GetHess(); };
+  double best{0};
+  GradientPairPrecise forward, backward;
+  for (bst_bin_t i = 0; i < kThreshold - 1; ++i) {
+    forward += node_hist[sorted_idx[i]];
+    backward += node_hist[sorted_idx[kCats - 1 - i]];
+    for (auto const &part : {forward, backward}) {
+      best = std::max(best, gain(part) + gain(parent_sum - part) - gain(parent_sum));
+    }
+  }
+  ASSERT_TRUE(split.is_cat);
+  ASSERT_NEAR(split.loss_chg, best, 1e-3);
+
+  // The categories in the bitset go to the right.
+  GradientPairPrecise right;
+  common::KCatBitField cat_bits{split.cat_bits};
+  for (bst_bin_t i = 0; i < kCats; ++i) {
+    if (cat_bits.Check(i)) {
+      right += node_hist[i];
+    }
+  }
+  ASSERT_NEAR(right.GetGrad(), split.right_sum.GetGrad(), 1e-3);
+  ASSERT_NEAR(right.GetHess(), split.right_sum.GetHess(), 1e-3);
+}
+
 TEST_F(TestCategoricalSplitWithMissing, HistEvaluator) {
   common::HistCollection hist;
   hist.Init(cuts_.TotalBins());
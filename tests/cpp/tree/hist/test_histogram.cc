@@ -303,6 +303,58 @@ TEST(CPUHistogram, BuildHistColSplit) {
   RunWithInMemoryCommunicator(kWorkers, TestBuildHistogram, true, false, true);
 }
 
+namespace {
+void TestMultiTargetHistogram(float sparsity, bst_bin_t max_bin) {
+  size_t constexpr kNRows = 64, kNCols = 8;
+  bst_target_t constexpr kTargets = 3;
+  auto ctx = CreateEmptyGenericParam(Context::kCpuId);
+  auto p_fmat = RandomDataGenerator(kNRows, kNCols, sparsity).Seed(3).GenerateDMatrix();
+
+  auto gpair = linalg::Empty<GradientPair>(&ctx, kNRows, kTargets);
+  auto h_gpair = gpair.HostView();
+  auto gen = GenerateRandomGradients(kNRows * kTargets, -1.0, 1.0);
+  std::copy(gen.HostVector().cbegin(), gen.HostVector().cend(), linalg::begin(h_gpair));
+
+  common::RowSetCollection row_set_collection;
+  InitRowPartitionForTest(&row_set_collection, kNRows);
+  RegTree tree{kTargets, kNCols};
+  std::vector<MultiExpandEntry> nodes{{RegTree::kRoot, tree.GetDepth(RegTree::kRoot)}};
+  common::BlockedSpace2d space{
+      1, [&](std::size_t) { return row_set_collection[RegTree::kRoot].Size(); }, 256};
+
+  for (auto const &gidx : p_fmat->GetBatches<GHistIndexMatrix>(&ctx, {max_bin, 0.5})) {
+    auto n_bins = gidx.cut.TotalBins();
+    HistogramBuilder<MultiExpandEntry> multi;
+    multi.Reset(n_bins * kTargets, {max_bin, 0.5}, ctx.Threads(), 1, false, false);
+    multi.BuildHist(0, space, gidx, &tree, row_set_collection, nodes, {}, h_gpair);
+    auto multi_hist = multi.Histogram()[RegTree::kRoot];
+    ASSERT_EQ(multi_hist.size(), n_bins * kTargets);
+
+    for (bst_target_t t = 0; t < kTargets; ++t) {
+      std::vector<GradientPair> t_gpair(kNRows);
+      for (size_t i = 0; i < kNRows; ++i) {
+        t_gpair[i] = h_gpair(i, t);
+      }
+      HistogramBuilder<MultiExpandEntry> single;
+      single.Reset(n_bins, {max_bin, 0.5}, ctx.Threads(), 1, false, false);
+      single.BuildHist(0, space, gidx, &tree, row_set_collection, nodes, {}, t_gpair);
+      auto single_hist = single.Histogram()[RegTree::kRoot];
+      for (size_t i = 0; i < n_bins; ++i) {
+        ASSERT_NEAR(single_hist[i].GetGrad(), multi_hist[i * kTargets + t].GetGrad(), kRtEps);
+        ASSERT_NEAR(single_hist[i].GetHess(), multi_hist[i * kTargets + t].GetHess(), kRtEps);
+      }
+    }
+  }
+}
+}  // anonymous namespace
+
+TEST(CPUHistogram, MultiTarget) {
+  // dense, dense with packed bins, and sparse
+  TestMultiTargetHistogram(0.0, 256);
+  TestMultiTargetHistogram(0.0, 8);
+  TestMultiTargetHistogram(0.6, 16);
+}
+
 namespace {
 template <typename GradientSumT>
 void ValidateCategoricalHistogram(size_t n_categories,
@@ -7,6 +7,7 @@
 
 #include <algorithm>
 #include <cstddef>  // for size_t
+#include <limits>   // for numeric_limits
 #include <string>
 #include <vector>
 
@@ -94,6 +95,57 @@ TEST(QuantileHist, Partitioner) { TestPartitioner<CPUExpandEntry>(1); }
 
 TEST(QuantileHist, MultiPartitioner) { TestPartitioner<MultiExpandEntry>(3); }
 
+namespace {
+void TestRowMajorPartitioner(float sparsity) {
+  std::size_t n_samples = 1024, base_rowid = 0;
+  bst_feature_t n_features = 8;
+
+  Context ctx;
+  ctx.InitAllowUnknown(Args{});
+  auto Xy = RandomDataGenerator{n_samples, n_features, sparsity}.GenerateDMatrix(true);
+  auto cuts = common::SketchOnDMatrix(&ctx, Xy.get(), 64);
+
+  for (auto const& page : Xy->GetBatches<SparsePage>()) {
+    // The column matrix is not built without a sparse threshold.
+    GHistIndexMatrix gmat(page, {}, cuts, 64, Xy->IsDense(),
+                          std::numeric_limits<double>::quiet_NaN(), ctx.Threads());
+    ASSERT_FALSE(gmat.Transpose().IsInitialized());
+    common::ColumnMatrix column_indices;
+    column_indices.InitFromSparse(page, gmat, 0.5, ctx.Threads());
+
+    for (bst_feature_t fidx = 0; fidx < n_features; ++fidx) {
+      auto const& ptrs = gmat.cut.Ptrs();
+      float split_value = gmat.cut.Values().at((ptrs[fidx] + ptrs[fidx + 1]) / 2);
+      bool default_left = fidx % 2 == 0;
+      RegTree tree{1, n_features};
+      tree.ExpandNode(RegTree::kRoot, fidx, split_value, default_left, 0.0f, 0.0f, 0.0f, 0.0f,
+                      0.0f, 0.0f, 0.0f);
+      std::vector<CPUExpandEntry> candidates{{0, 0}};
+      candidates.front().split.Update(0.4f, fidx, split_value, default_left, false,
+                                      GradStats{}, GradStats{});
+
+      CommonRowPartitioner row_major{&ctx, n_samples, base_rowid, false};
+      row_major.UpdatePosition(&ctx, gmat, candidates, &tree);
+      CommonRowPartitioner column_major{&ctx, n_samples, base_rowid, false};
+      column_major.UpdatePosition<false>(&ctx, gmat, column_indices, candidates, &tree);
+
+      for (auto nidx : {tree.LeftChild(RegTree::kRoot), tree.RightChild(RegTree::kRoot)}) {
+        auto elem = row_major[nidx];
+        auto expected = column_major[nidx];
+        ASSERT_EQ(elem.Size(), expected.Size());
+        ASSERT_TRUE(std::equal(elem.begin, elem.end, expected.begin));
+      }
+      ASSERT_GT(row_major[tree.LeftChild(RegTree::kRoot)].Size(), 0);
+    }
+  }
+}
+}  // anonymous namespace
+
+TEST(QuantileHist, RowMajorPartitioner) {
+  TestRowMajorPartitioner(0.0f);
+  TestRowMajorPartitioner(0.4f);
+}
+
 namespace {
 
 template <typename ExpandEntry>
@@ -6,11 +6,13 @@
 #include <xgboost/task.h>  // for ObjInfo
 #include <xgboost/tree_updater.h>
 
+#include <cstddef>  // for size_t
 #include <memory>
 #include <string>
 #include <vector>
 
-#include "../../../src/tree/param.h"  // for TrainParam
+#include "../../../src/predictor/predict_fn.h"  // for GetNextNode
+#include "../../../src/tree/param.h"            // for TrainParam
 #include "../helpers.h"
 
 namespace xgboost::tree {
@@ -56,4 +58,72 @@ TEST(Updater, Refresh) {
   ASSERT_NEAR(0, tree.Stat(1).loss_chg, kEps);
   ASSERT_NEAR(0, tree.Stat(2).loss_chg, kEps);
 }
+
+TEST(Updater, RefreshManyTrees) {
+  // More rows and trees than the block sizes of leaf prediction.
+  bst_row_t constexpr kRows = 300;
+  bst_feature_t constexpr kCols = 8;
+  std::size_t constexpr kTrees = 130;
+  auto p_dmat = RandomDataGenerator{kRows, kCols, 0.2f}.Seed(3).GenerateDMatrix();
+  auto gpair = GenerateRandomGradients(kRows);
+
+  std::vector<RegTree> trees;
+  trees.reserve(kTrees);
+  std::vector<RegTree *> p_trees;
+  for (std::size_t t = 0; t < kTrees; ++t) {
+    auto &tree = trees.emplace_back(1u, kCols);
+    tree.ExpandNode(0, t % kCols, 0.5f, t % 2 == 0, 0.0, 0.2f, 0.8f, 0.0f, 0.0f,
+                    /*left_sum=*/0.0f, /*right_sum=*/0.0f);
+    tree.ExpandNode(tree[0].LeftChild(), (t + 1) % kCols, 0.3f, t % 3 == 0, 0.0, 0.2f, 0.8f, 0.0f,
+                    0.0f, /*left_sum=*/0.0f, /*right_sum=*/0.0f);
+    p_trees.push_back(&tree);
+  }
+
+  // Expected hessian of each node with a full traversal.
+  std::vector<std::vector<double>> expected(kTrees);
+  RegTree::FVec feats;
+  feats.Init(kCols);
+  auto const &h_gpair = gpair.ConstHostVector();
+  for (auto const &batch : p_dmat->GetBatches<SparsePage>()) {
+    auto page = batch.GetView();
+    for (std::size_t i = 0; i < batch.Size(); ++i) {
+      feats.Fill(page[i]);
+      for (std::size_t t = 0; t < kTrees; ++t) {
+        auto const &tree = trees[t];
+        expected[t].resize(tree.NumNodes(), 0.0);
+        bst_node_t nidx = 0;
+        expected[t][nidx] += h_gpair[batch.base_rowid + i].GetHess();
+        while (!tree[nidx].IsLeaf()) {
+          auto fidx = tree[nidx].SplitIndex();
+          nidx = predictor::GetNextNode<true, false>(tree[nidx], nidx, feats.GetFvalue(fidx),
+                                                     feats.IsMissing(fidx),
+                                                     tree.GetCategoriesMatrix());
+          expected[t][nidx] += h_gpair[batch.base_rowid + i].GetHess();
+        }
+      }
+      feats.Drop();
+    }
+  }
+
+  auto ctx = CreateEmptyGenericParam(Context::kCpuId);
+  ctx.nthread = 4;
+  ObjInfo task{ObjInfo::kRegression};
+  std::unique_ptr<TreeUpdater> refresher(TreeUpdater::Create("refresh", &ctx, &task));
+  tree::TrainParam param;
+  param.UpdateAllowUnknown(Args{});
+  std::vector<HostDeviceVector<bst_node_t>> position;
+  auto check = [&](std::size_t n_trees) {
+    std::vector<RegTree *> subset(p_trees.cbegin(), p_trees.cbegin() + n_trees);
+    refresher->Update(&param, &gpair, p_dmat.get(), position, subset);
+    for (std::size_t t = 0; t < n_trees; ++t) {
+      for (bst_node_t nidx = 0; nidx < trees[t].NumNodes(); ++nidx) {
+        ASSERT_NEAR(trees[t].Stat(nidx).sum_hess, expected[t][nidx], 1e-3);
+      }
+    }
+  };
+  // Fewer trees than threads, rows are split among threads.
+  check(2);
+  // Trees are split among threads.
+  check(kTrees);
+}
 }  // namespace xgboost::tree
@@ -3,6 +3,7 @@
 
 #include "../../../src/common/bitfield.h"
 #include "../../../src/common/categorical.h"
+#include "../../../src/predictor/predict_fn.h"
 #include "../filesystem.h"
 #include "../helpers.h"
 #include "xgboost/json_io.h"
@@ -267,6 +268,49 @@ TEST(Tree, CategoricalIO) {
   }
 }
 
+TEST(Tree, CategoricalEncoding) {
+  using Encoding = RegTree::CategoricalSplitMatrix::Encoding;
+  bst_cat_t constexpr kMaxCat = 50000;
+  auto check = [&](std::vector<bst_cat_t> const& chosen, Encoding expected) {
+    std::vector<uint32_t> split_cats(LBitField32::ComputeStorageSize(kMaxCat + 1));
+    LBitField32 bitset{split_cats};
+    for (auto c : chosen) {
+      bitset.Set(c);
+    }
+    RegTree tree;
+    tree.ExpandCategorical(0, 0, split_cats, true, 1.0, 2.0, 3.0, 11.0, 2.0,
+                           /*left_sum=*/3.0, /*right_sum=*/4.0);
+    RegTree loaded;
+    Json out{Object()};
+    tree.SaveModel(&out);
+    loaded.LoadModel(out);
+
+    for (auto const* p_tree : {&tree, &loaded}) {
+      auto cats = p_tree->GetCategoriesMatrix();
+      ASSERT_EQ(cats.compact_ptr[RegTree::kRoot].kind, expected);
+      for (bst_cat_t c = 0; c < kMaxCat + 16; ++c) {
+        auto fvalue = static_cast<float>(c);
+        ASSERT_EQ(predictor::CatDecision(cats, RegTree::kRoot, fvalue),
+                  common::Decision(split_cats, fvalue))
+            << c;
+      }
+      ASSERT_TRUE(predictor::CatDecision(cats, RegTree::kRoot, -1.0f));
+    }
+  };
+
+  check({3, 17, 4096, kMaxCat}, Encoding::kSorted);
+  std::vector<bst_cat_t> chosen;
+  for (bst_cat_t c = 7; c <= kMaxCat; c += 97) {
+    chosen.push_back(c);
+  }
+  check(chosen, Encoding::kHash);
+  chosen.clear();
+  for (bst_cat_t c = 0; c <= kMaxCat; c += 3) {
+    chosen.push_back(c);
+  }
+  check(chosen, Encoding::kBitset);
+}
+
 namespace {
 RegTree ConstructTree() {
   RegTree tree;